@@ -4,12 +4,48 @@
 #pragma once
 
 #include <intx/intx.hpp>
+#include <cassert>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include "x86_64.hpp"
+#endif
 
 namespace evmmax
 {
+/// The modulus kind for any odd modulus. Uses the generic Montgomery arithmetic.
+struct GenericModulus
+{};
+
+/// The modulus kind for the "sparse" odd modulus having the most significant word
+/// less than 2⁶³-1, e.g. the BN254 and BLS12-381 primes.
+///
+/// The intermediate values of the Montgomery multiplication and the sum x + y
+/// fit the UintT so the carry handling can be skipped.
+struct SparseModulus
+{};
+
+/// The modulus kind for the pseudo-Mersenne prime 2ⁿ - C, where n is the UintT bit size
+/// and C is a "small" constant, e.g. the secp256k1 prime 2²⁵⁶ - 2³² - 977.
+///
+/// The values are not in Montgomery form (to_mont() and from_mont() are identities)
+/// and the multiplication uses the dedicated reduction exploiting 2ⁿ ≡ C.
+template <uint64_t C>
+struct PseudoMersenneModulus
+{
+    static constexpr uint64_t c = C;
+};
+
+template <typename T>
+inline constexpr bool is_pseudo_mersenne = false;
+
+template <uint64_t C>
+inline constexpr bool is_pseudo_mersenne<PseudoMersenneModulus<C>> = true;
 
 /// The modular arithmetic operations for EVMMAX (EVM Modular Arithmetic Extensions).
-template <typename UintT>
+///
+/// The KindT selects at compile time the arithmetic kernels specialized for the given kind
+/// of the modulus, see GenericModulus, SparseModulus and PseudoMersenneModulus.
+template <typename UintT, typename KindT = GenericModulus>
 class ModArith
 {
 public:
@@ -46,6 +82,36 @@ private:
         return intx::udivrem(r2, mod).rem;
     }
 
+    /// Performs the Montgomery multiplication for the SparseModulus.
+    ///
+    /// This is the CIOS method with the two inner loops fused. The sparse modulus guarantees
+    /// the intermediate result fits S words so the extra carry word t[S] is not needed.
+    /// See https://hackmd.io/@gnark/modular_multiplication.
+    constexpr UintT mul_sparse(const UintT& x, const UintT& y) const noexcept
+    {
+        constexpr auto S = UintT::num_words;
+
+        UintT t;
+        for (size_t i = 0; i != S; ++i)
+        {
+            uint64_t a = 0;
+            std::tie(a, t[0]) = addmul(t[0], x[0], y[i], 0);
+            const auto m = t[0] * m_mod_inv;
+            uint64_t c = 0;
+            std::tie(c, std::ignore) = addmul(t[0], m, mod[0], 0);
+            for (size_t j = 1; j != S; ++j)
+            {
+                std::tie(a, t[j]) = addmul(t[j], x[j], y[i], a);
+                std::tie(c, t[j - 1]) = addmul(t[j], m, mod[j], c);
+            }
+            t[S - 1] = c + a;
+        }
+
+        if (t >= mod)
+            t -= mod;
+        return t;
+    }
+
     static constexpr std::pair<uint64_t, uint64_t> addmul(
         uint64_t t, uint64_t a, uint64_t b, uint64_t c) noexcept
     {
@@ -53,32 +119,149 @@ private:
         return {p[1], p[0]};
     }
 
+    /// Reduces the double-width product p = hi⋅2ⁿ + lo modulo the pseudo-Mersenne prime 2ⁿ - C.
+    ///
+    /// Because 2ⁿ ≡ C, the high part is folded twice: first lo + hi⋅C fits n + 64 bits,
+    /// then the top word k gives the sum r + k⋅C of which the overflow is folded once more.
+    constexpr UintT reduce_pseudo_mersenne(const intx::uint<UintT::num_bits * 2>& p) const noexcept
+    {
+        constexpr auto S = UintT::num_words;
+        constexpr auto C = KindT::c;
+        static_assert(S >= 3, "the final fold requires k⋅C + C to fit the UintT");
+
+        UintT r;
+        uint64_t k = 0;
+        for (size_t j = 0; j != S; ++j)
+            std::tie(k, r[j]) = addmul(p[j], p[S + j], C, k);
+
+        const auto kc = intx::umul(k, C);
+        const auto s = intx::addc(r, UintT{kc[0], kc[1]});
+        r = s.value;
+        if (s.carry)
+            r += C;  // Cannot overflow: r < k⋅C here.
+
+        if (r >= mod)
+            r -= mod;
+        return r;
+    }
+
+    /// Computes the double-width square x².
+    ///
+    /// Each cross product xᵢ⋅xⱼ (i < j) is computed once and doubled, so the squaring
+    /// needs S(S+1)/2 word multiplications instead of S².
+    static constexpr intx::uint<UintT::num_bits * 2> square(const UintT& x) noexcept
+    {
+        constexpr auto S = UintT::num_words;
+
+        intx::uint<UintT::num_bits * 2> p;
+        for (size_t i = 0; i != S; ++i)
+        {
+            uint64_t c = 0;
+            for (size_t j = i + 1; j != S; ++j)
+                std::tie(c, p[i + j]) = addmul(p[i + j], x[i], x[j], c);
+            p[i + S] = c;
+        }
+
+        // Double the cross products (shift left by 1) and add the squares xᵢ².
+        uint64_t top = 0;
+        uint64_t c = 0;
+        for (size_t i = 0; i != S; ++i)
+        {
+            const auto lo = (p[2 * i] << 1) | top;
+            const auto hi = (p[2 * i + 1] << 1) | (p[2 * i] >> 63);
+            top = p[2 * i + 1] >> 63;
+            std::tie(c, p[2 * i]) = addmul(lo, x[i], x[i], c);
+            std::tie(c, p[2 * i + 1]) = addmul(hi, c, 1, 0);
+        }
+        return p;
+    }
+
+    /// Performs the Montgomery reduction tR⁻¹ % mod of the double-width t < mod⋅R
+    /// (Separated Operand Scanning).
+    constexpr UintT reduce_mont(intx::uint<UintT::num_bits * 2> t) const noexcept
+    {
+        constexpr auto S = UintT::num_words;
+
+        bool k = false;
+        for (size_t i = 0; i != S; ++i)
+        {
+            const auto m = t[i] * m_mod_inv;
+            uint64_t c = 0;
+            for (size_t j = 0; j != S; ++j)
+                std::tie(c, t[i + j]) = addmul(t[i + j], m, mod[j], c);
+            const auto s = intx::addc(t[i + S], c, k);
+            t[i + S] = s.value;
+            k = s.carry;
+        }
+
+        intx::uint<UintT::num_bits + 64> r;
+        for (size_t i = 0; i != S; ++i)
+            r[i] = t[S + i];
+        r[S] = k;
+        if (r >= mod)
+            r -= mod;
+        return static_cast<UintT>(r);
+    }
+
 public:
     constexpr explicit ModArith(const UintT& modulus) noexcept
       : mod{modulus},
-        m_r_squared{compute_r_squared(modulus)},
+        m_r_squared{is_pseudo_mersenne<KindT> ? UintT{} : compute_r_squared(modulus)},
         m_mod_inv{compute_mod_inv(modulus[0])}
-    {}
+    {
+        if constexpr (is_pseudo_mersenne<KindT>)
+            assert(modulus == 0 - UintT{KindT::c});
+        else if constexpr (std::is_same_v<KindT, SparseModulus>)
+            assert(modulus[UintT::num_words - 1] < 0x7fffffffffffffff);
+    }
 
     /// Converts a value to Montgomery form.
     ///
     /// This is done by using Montgomery multiplication mul(x, R²)
     /// what gives aR²R⁻¹ % mod = aR % mod.
-    constexpr UintT to_mont(const UintT& x) const noexcept { return mul(x, m_r_squared); }
+    constexpr UintT to_mont(const UintT& x) const noexcept
+    {
+        if constexpr (is_pseudo_mersenne<KindT>)
+            return x;
+        else
+            return mul(x, m_r_squared);
+    }
 
     /// Converts a value in Montgomery form back to normal value.
     ///
     /// Given the x is the Montgomery form x = aR, the conversion is done by using
     /// Montgomery multiplication mul(x, 1) what gives aRR⁻¹ % mod = a % mod.
-    constexpr UintT from_mont(const UintT& x) const noexcept { return mul(x, 1); }
+    constexpr UintT from_mont(const UintT& x) const noexcept
+    {
+        if constexpr (is_pseudo_mersenne<KindT>)
+            return x;
+        else
+            return mul(x, 1);
+    }
 
     /// Performs a Montgomery modular multiplication.
     ///
     /// Inputs must be in Montgomery form: x = aR, y = bR.
     /// This computes Montgomery multiplication xyR⁻¹ % mod what gives aRbRR⁻¹ % mod = abR % mod.
     /// The result (abR) is in Montgomery form.
+    /// For the PseudoMersenneModulus this is the plain modular multiplication ab % mod.
     constexpr UintT mul(const UintT& x, const UintT& y) const noexcept
     {
+        if constexpr (is_pseudo_mersenne<KindT>)
+            return reduce_pseudo_mersenne(intx::umul(x, y));
+
+#if defined(__x86_64__) && defined(__GNUC__)
+        if constexpr (x86_64::has_mul_mont<UintT>)
+        {
+            // The constant evaluation always uses the portable code below.
+            if (!std::is_constant_evaluated() && x86_64::use_mulx_adx)
+                return x86_64::mul_mont(x, y, mod, m_mod_inv);
+        }
+#endif
+
+        if constexpr (std::is_same_v<KindT, SparseModulus>)
+            return mul_sparse(x, y);
+
         // Coarsely Integrated Operand Scanning (CIOS) Method
         // Based on 2.3.2 from
         // High-Speed Algorithms & Architectures For Number-Theoretic Cryptosystems
@@ -94,7 +277,7 @@ public:
                 std::tie(c, t[j]) = addmul(t[j], x[j], y[i], c);
             auto tmp = intx::addc(t[S], c);
             t[S] = tmp.value;
-            const auto d = tmp.carry;  // TODO: Carry is 0 for sparse modulus.
+            const auto d = tmp.carry;  // Carry is 0 for sparse modulus, see mul_sparse().
 
             const auto m = t[0] * m_mod_inv;
             std::tie(c, std::ignore) = addmul(t[0], m, mod[0], 0);
@@ -102,7 +285,7 @@ public:
                 std::tie(c, t[j - 1]) = addmul(t[j], m, mod[j], c);
             tmp = intx::addc(t[S], c);
             t[S - 1] = tmp.value;
-            t[S] = d + tmp.carry;  // TODO: Carry is 0 for sparse modulus.
+            t[S] = d + tmp.carry;  // Carry is 0 for sparse modulus, see mul_sparse().
         }
 
         if (t >= mod)
@@ -111,11 +294,43 @@ public:
         return static_cast<UintT>(t);
     }
 
+    /// Performs a Montgomery modular squaring, the same as mul(x, x).
+    ///
+    /// The portable implementation uses the dedicated squaring skipping the duplicate
+    /// cross products followed by the separate Montgomery reduction.
+    /// On x86-64 with MULX/ADX available the mul_mont() kernel is used instead
+    /// (it is faster than the portable squaring), so the dedicated squaring only runs
+    /// for the pseudo-Mersenne moduli, in constant evaluation and on the other CPUs.
+    constexpr UintT sqr(const UintT& x) const noexcept
+    {
+        if constexpr (is_pseudo_mersenne<KindT>)
+            return reduce_pseudo_mersenne(square(x));
+
+#if defined(__x86_64__) && defined(__GNUC__)
+        if constexpr (x86_64::has_mul_mont<UintT>)
+        {
+            // The constant evaluation always uses the portable code below.
+            if (!std::is_constant_evaluated() && x86_64::use_mulx_adx)
+                return x86_64::mul_mont(x, x, mod, m_mod_inv);
+        }
+#endif
+
+        return reduce_mont(square(x));
+    }
+
     /// Performs a modular addition. It is required that x < mod and y < mod, but x and y may be
     /// but are not required to be in Montgomery form.
     constexpr UintT add(const UintT& x, const UintT& y) const noexcept
     {
-        const auto s = addc(x, y);  // TODO: cannot overflow if modulus is sparse (e.g. 255 bits).
+        if constexpr (std::is_same_v<KindT, SparseModulus>)
+        {
+            // The sum x + y < 2⋅mod cannot overflow.
+            const auto s = x + y;
+            const auto d = subc(s, mod);
+            return d.carry ? s : d.value;
+        }
+
+        const auto s = addc(x, y);
         const auto d = subc(s.value, mod);
         return (!s.carry && d.carry) ? s.value : d.value;
     }
@@ -0,0 +1,238 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "evmmax.hpp"
+
+/// The constant-time modular inversion for 256-bit odd moduli using the Bernstein–Yang
+/// "safegcd" algorithm (https://eprint.iacr.org/2019/266).
+///
+/// This follows the libsecp256k1 modinv64 implementation: the numbers are represented
+/// in the signed 62-bit limbs and the divsteps are performed in batches of 59
+/// on the low limbs only, producing the 2x2 transition matrix applied to the full numbers.
+/// The number of the divsteps is fixed (590 is enough for 256-bit numbers),
+/// so the execution does not depend on the input value.
+namespace evmmax::safegcd
+{
+using intx::uint256;
+
+/// The 256-bit number in 5 signed 62-bit limbs. Only the top limb is negative
+/// for negative numbers.
+struct Signed62
+{
+    int64_t v[5];
+};
+
+/// The 2x2 transition matrix [[u, v], [q, r]] of a batch of divsteps, scaled by 2⁶².
+struct Trans2x2
+{
+    int64_t u, v, q, r;
+};
+
+inline constexpr uint64_t M62 = ~uint64_t{0} >> 2;
+
+/// The signed 128-bit product a⋅b represented as the two's complement intx::uint128.
+constexpr intx::uint128 imul(int64_t a, int64_t b) noexcept
+{
+    auto p = intx::umul(static_cast<uint64_t>(a), static_cast<uint64_t>(b));
+    // Correct the unsigned product of the two's complement numbers (without branches).
+    p[1] -= (static_cast<uint64_t>(a >> 63) & static_cast<uint64_t>(b)) +
+            (static_cast<uint64_t>(b >> 63) & static_cast<uint64_t>(a));
+    return p;
+}
+
+/// The arithmetic shift right by 62 of the signed 128-bit x.
+constexpr intx::uint128 sar62(const intx::uint128& x) noexcept
+{
+    return {(x[0] >> 62) | (x[1] << 2), static_cast<uint64_t>(static_cast<int64_t>(x[1]) >> 62)};
+}
+
+/// The low 62 bits of the signed 128-bit x.
+constexpr int64_t low62(const intx::uint128& x) noexcept
+{
+    return static_cast<int64_t>(x[0] & M62);
+}
+
+/// Converts x to the signed 62-bit limbs.
+constexpr Signed62 to_signed62(const uint256& x) noexcept
+{
+    Signed62 r{};
+    for (size_t i = 0; i != 5; ++i)
+        r.v[i] = static_cast<int64_t>(static_cast<uint64_t>(x >> (62 * i)) & M62);
+    return r;
+}
+
+/// Converts the normalized number (all limbs in [0, 2⁶²)) to uint256.
+constexpr uint256 from_signed62(const Signed62& x) noexcept
+{
+    uint256 r;
+    for (size_t i = 0; i != 5; ++i)
+        r |= uint256{static_cast<uint64_t>(x.v[i])} << (62 * i);
+    return r;
+}
+
+/// Performs 59 divsteps on the low 64 bits of f and g, starting from the given zeta
+/// (ζ = -(δ + ½)). Returns the new zeta and the transition matrix.
+constexpr int64_t divsteps_59(int64_t zeta, uint64_t f, uint64_t g, Trans2x2& t) noexcept
+{
+    // The matrix starts as the identity matrix times 8 so after 59 steps
+    // it ends up scaled by 2⁶². The elements are in [-2⁶², 2⁶²]
+    // but represented as unsigned to allow the left shifts.
+    uint64_t u = 8, v = 0, q = 0, r = 8;
+
+    for (int i = 3; i != 62; ++i)
+    {
+        // The masks for the conditions ζ < 0 and g odd.
+        auto mask1 = static_cast<uint64_t>(zeta >> 63);
+        const auto mask2 = -(g & 1);
+        // Conditionally negated f, u, v.
+        const auto x = (f ^ mask1) - mask1;
+        const auto y = (u ^ mask1) - mask1;
+        const auto z = (v ^ mask1) - mask1;
+        // If g is odd: g += x, q += y, r += z.
+        g += x & mask2;
+        q += y & mask2;
+        r += z & mask2;
+        // The mask for ζ < 0 and g odd: then ζ = -ζ - 2, otherwise ζ = ζ - 1.
+        mask1 &= mask2;
+        zeta = (zeta ^ static_cast<int64_t>(mask1)) - 1;
+        // In that case also the swap: f, u, v += g, q, r (f = old g).
+        f += g & mask1;
+        u += q & mask1;
+        v += r & mask1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+    t = {static_cast<int64_t>(u), static_cast<int64_t>(v), static_cast<int64_t>(q),
+        static_cast<int64_t>(r)};
+    return zeta;
+}
+
+/// Computes [d, e] = t⋅[d, e] / 2⁶² % mod, keeping d and e in (-2⋅mod, mod).
+///
+/// The multiples of mod making the bottom 62 bits zero are added before the division.
+constexpr void update_de(
+    Signed62& d, Signed62& e, const Trans2x2& t, const Signed62& mod, uint64_t mod_inv62) noexcept
+{
+    const auto [u, v, q, r] = t;
+
+    // md, me start as [u, q] if d is negative plus [v, r] if e is negative.
+    const auto sd = d.v[4] >> 63;
+    const auto se = e.v[4] >> 63;
+    auto md = (u & sd) + (v & se);
+    auto me = (q & sd) + (r & se);
+
+    auto cd = imul(u, d.v[0]) + imul(v, e.v[0]);
+    auto ce = imul(q, d.v[0]) + imul(r, e.v[0]);
+
+    // Correct md, me so that t⋅[d, e] + mod⋅[md, me] has the bottom 62 bits zero.
+    md -= static_cast<int64_t>((mod_inv62 * cd[0] + static_cast<uint64_t>(md)) & M62);
+    me -= static_cast<int64_t>((mod_inv62 * ce[0] + static_cast<uint64_t>(me)) & M62);
+
+    cd = sar62(cd + imul(mod.v[0], md));
+    ce = sar62(ce + imul(mod.v[0], me));
+
+    for (size_t i = 1; i != 5; ++i)
+    {
+        cd = cd + imul(u, d.v[i]) + imul(v, e.v[i]) + imul(mod.v[i], md);
+        ce = ce + imul(q, d.v[i]) + imul(r, e.v[i]) + imul(mod.v[i], me);
+        d.v[i - 1] = low62(cd);
+        e.v[i - 1] = low62(ce);
+        cd = sar62(cd);
+        ce = sar62(ce);
+    }
+    d.v[4] = static_cast<int64_t>(cd[0]);
+    e.v[4] = static_cast<int64_t>(ce[0]);
+}
+
+/// Computes [f, g] = t⋅[f, g] / 2⁶² (the division is exact).
+constexpr void update_fg(Signed62& f, Signed62& g, const Trans2x2& t) noexcept
+{
+    const auto [u, v, q, r] = t;
+
+    auto cf = sar62(imul(u, f.v[0]) + imul(v, g.v[0]));
+    auto cg = sar62(imul(q, f.v[0]) + imul(r, g.v[0]));
+    for (size_t i = 1; i != 5; ++i)
+    {
+        cf = cf + imul(u, f.v[i]) + imul(v, g.v[i]);
+        cg = cg + imul(q, f.v[i]) + imul(r, g.v[i]);
+        f.v[i - 1] = low62(cf);
+        g.v[i - 1] = low62(cg);
+        cf = sar62(cf);
+        cg = sar62(cg);
+    }
+    f.v[4] = static_cast<int64_t>(cf[0]);
+    g.v[4] = static_cast<int64_t>(cg[0]);
+}
+
+/// Brings d in (-2⋅mod, mod) to [0, mod), negating it if the sign of f is negative.
+constexpr void normalize(Signed62& d, int64_t sign, const Signed62& mod) noexcept
+{
+    const auto propagate = [&d]() noexcept {
+        for (size_t i = 0; i != 4; ++i)
+        {
+            d.v[i + 1] += d.v[i] >> 62;
+            d.v[i] &= static_cast<int64_t>(M62);
+        }
+    };
+
+    // Add mod if d is negative and then negate if requested: d in (-mod, mod).
+    auto cond_add = d.v[4] >> 63;
+    const auto cond_negate = sign >> 63;
+    for (size_t i = 0; i != 5; ++i)
+        d.v[i] = ((d.v[i] + (mod.v[i] & cond_add)) ^ cond_negate) - cond_negate;
+    propagate();
+
+    // Add mod again if d is still negative: d in [0, mod).
+    cond_add = d.v[4] >> 63;
+    for (size_t i = 0; i != 5; ++i)
+        d.v[i] += mod.v[i] & cond_add;
+    propagate();
+}
+
+/// Computes the modular inverse x⁻¹ % mod in constant time.
+///
+/// The mod must be odd and the x must be less than mod and coprime to it (e.g. a prime mod).
+/// The inverse of 0 is 0, the same as computed by the Fermat's little theorem.
+constexpr uint256 inv(const uint256& x, const uint256& mod) noexcept
+{
+    // The inverse of mod modulo 2⁶² by the Newton's method: each step doubles the precision
+    // starting from the 3 correct bits (x⋅x ≡ 1 mod 8 for any odd x).
+    auto mod_inv62 = mod[0];
+    for (int i = 0; i != 5; ++i)
+        mod_inv62 *= 2 - mod[0] * mod_inv62;
+    mod_inv62 &= M62;
+
+    const auto m = to_signed62(mod);
+    Signed62 d{};
+    Signed62 e{{1}};
+    auto f = m;
+    auto g = to_signed62(x);
+    int64_t zeta = -1;  // ζ = -(δ + ½), δ starts at ½.
+
+    // 10 ⋅ 59 = 590 divsteps are enough for 256-bit numbers. Then g is 0 and f is ±1
+    // so d is ± the inverse.
+    for (int i = 0; i != 10; ++i)
+    {
+        Trans2x2 t{};
+        zeta = divsteps_59(zeta, static_cast<uint64_t>(f.v[0]), static_cast<uint64_t>(g.v[0]), t);
+        update_de(d, e, t, m, mod_inv62);
+        update_fg(f, g, t);
+    }
+
+    normalize(d, f.v[4], m);
+    return from_signed62(d);
+}
+
+/// Computes the modular inverse of x in the representation used by the ModArith m,
+/// i.e. x⁻¹R % mod for x in Montgomery form.
+template <typename KindT>
+constexpr uint256 inv(const ModArith<uint256, KindT>& m, const uint256& x) noexcept
+{
+    // For x = aR the plain inverse is a⁻¹R⁻¹ and the two conversions multiply it by R².
+    // For the pseudo-Mersenne kind the conversions are identities.
+    return m.to_mont(m.to_mont(inv(x, m.mod)));
+}
+}  // namespace evmmax::safegcd
@@ -0,0 +1,190 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <intx/intx.hpp>
+#include <cpuid.h>
+
+/// The x86-64 kernels of the Montgomery multiplication for 256-bit and 384-bit numbers
+/// using the MULX (BMI2) and ADCX/ADOX (ADX) instructions.
+///
+/// The ADCX and ADOX use separate carry flags (CF and OF) so the additions of
+/// the low and high halves of the MULX products form two independent carry chains.
+namespace evmmax::x86_64
+{
+/// Checks if the CPU supports the BMI2 and ADX extensions.
+inline bool has_bmi2_adx() noexcept
+{
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0)
+        return false;
+    constexpr auto BMI2 = 1u << 8;
+    constexpr auto ADX = 1u << 19;
+    return (ebx & BMI2) != 0 && (ebx & ADX) != 0;
+}
+
+/// The runtime switch of the kernels, initialized during the program startup.
+///
+/// It is safe to use before the initialization (e.g. by other static initializers),
+/// the generic implementation is selected then.
+inline const bool use_mulx_adx = has_bmi2_adx();
+
+/// The Montgomery multiplication kernels are available for these sizes.
+template <typename UintT>
+inline constexpr bool has_mul_mont = UintT::num_words == 4 || UintT::num_words == 6;
+
+/// Performs the Montgomery multiplication xyR⁻¹ % mod (CIOS, see ModArith::mul()).
+///
+/// The inputs must be less than the odd modulus, the mod_inv is -mod⁻¹ % 2⁶⁴.
+/// The result is fully reduced so it is bit-identical with the generic implementation.
+/// Requires BMI2 and ADX, see use_mulx_adx.
+template <typename UintT>
+inline UintT mul_mont(
+    const UintT& x, const UintT& y, const UintT& mod, uint64_t mod_inv) noexcept
+{
+    static_assert(has_mul_mont<UintT>);
+    constexpr auto S = UintT::num_words;
+
+    // The accumulator t of S+1 words and the top word for the carries.
+    uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0, t5 = 0, t6 = 0, t7 = 0;
+    for (size_t i = 0; i != S; ++i)
+    {
+        uint64_t yi = y[i];
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+
+        // Computes t += x⋅yᵢ, then with m = t₀⋅mod_inv computes t += m⋅mod (t₀ becomes 0).
+        // In both steps the OF chain accumulates the low words of the products
+        // and the CF chain the high words. Both chains are closed in the top words.
+        if constexpr (S == 4)
+        {
+            asm("xorl %k[lo], %k[lo]\n\t"
+                "mulxq 0(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t0]\n\t"
+                "adcxq %[hi], %[t1]\n\t"
+                "mulxq 8(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t1]\n\t"
+                "adcxq %[hi], %[t2]\n\t"
+                "mulxq 16(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t2]\n\t"
+                "adcxq %[hi], %[t3]\n\t"
+                "mulxq 24(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t3]\n\t"
+                "adcxq %[hi], %[t4]\n\t"
+                "movl $0, %k[lo]\n\t"
+                "adoxq %[lo], %[t4]\n\t"
+                "adcxq %[lo], %[t5]\n\t"
+                "adoxq %[lo], %[t5]\n\t"
+
+                "movq %[t0], %%rdx\n\t"
+                "imulq %[inv], %%rdx\n\t"
+                "xorl %k[lo], %k[lo]\n\t"
+                "mulxq 0(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t0]\n\t"
+                "adcxq %[hi], %[t1]\n\t"
+                "mulxq 8(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t1]\n\t"
+                "adcxq %[hi], %[t2]\n\t"
+                "mulxq 16(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t2]\n\t"
+                "adcxq %[hi], %[t3]\n\t"
+                "mulxq 24(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t3]\n\t"
+                "adcxq %[hi], %[t4]\n\t"
+                "movl $0, %k[lo]\n\t"
+                "adoxq %[lo], %[t4]\n\t"
+                "adcxq %[lo], %[t5]\n\t"
+                "adoxq %[lo], %[t5]"
+                : [t0] "+r"(t0), [t1] "+r"(t1), [t2] "+r"(t2), [t3] "+r"(t3),
+                [t4] "+r"(t4), [t5] "+r"(t5), [lo] "=&r"(lo), [hi] "=&r"(hi), "+d"(yi)
+                : [x] "r"(&x[0]), [m] "r"(&mod[0]), [inv] "rm"(mod_inv)
+                : "cc", "memory");
+
+            // Shift the accumulator by one word, the t₀ is 0 now.
+            t0 = t1;
+            t1 = t2;
+            t2 = t3;
+            t3 = t4;
+            t4 = t5;
+            t5 = 0;
+        }
+        else
+        {
+            asm("xorl %k[lo], %k[lo]\n\t"
+                "mulxq 0(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t0]\n\t"
+                "adcxq %[hi], %[t1]\n\t"
+                "mulxq 8(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t1]\n\t"
+                "adcxq %[hi], %[t2]\n\t"
+                "mulxq 16(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t2]\n\t"
+                "adcxq %[hi], %[t3]\n\t"
+                "mulxq 24(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t3]\n\t"
+                "adcxq %[hi], %[t4]\n\t"
+                "mulxq 32(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t4]\n\t"
+                "adcxq %[hi], %[t5]\n\t"
+                "mulxq 40(%[x]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t5]\n\t"
+                "adcxq %[hi], %[t6]\n\t"
+                "movl $0, %k[lo]\n\t"
+                "adoxq %[lo], %[t6]\n\t"
+                "adcxq %[lo], %[t7]\n\t"
+                "adoxq %[lo], %[t7]\n\t"
+
+                "movq %[t0], %%rdx\n\t"
+                "imulq %[inv], %%rdx\n\t"
+                "xorl %k[lo], %k[lo]\n\t"
+                "mulxq 0(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t0]\n\t"
+                "adcxq %[hi], %[t1]\n\t"
+                "mulxq 8(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t1]\n\t"
+                "adcxq %[hi], %[t2]\n\t"
+                "mulxq 16(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t2]\n\t"
+                "adcxq %[hi], %[t3]\n\t"
+                "mulxq 24(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t3]\n\t"
+                "adcxq %[hi], %[t4]\n\t"
+                "mulxq 32(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t4]\n\t"
+                "adcxq %[hi], %[t5]\n\t"
+                "mulxq 40(%[m]), %[lo], %[hi]\n\t"
+                "adoxq %[lo], %[t5]\n\t"
+                "adcxq %[hi], %[t6]\n\t"
+                "movl $0, %k[lo]\n\t"
+                "adoxq %[lo], %[t6]\n\t"
+                "adcxq %[lo], %[t7]\n\t"
+                "adoxq %[lo], %[t7]"
+                : [t0] "+r"(t0), [t1] "+r"(t1), [t2] "+r"(t2), [t3] "+r"(t3),
+                [t4] "+r"(t4), [t5] "+r"(t5), [t6] "+r"(t6), [t7] "+r"(t7),
+                [lo] "=&r"(lo), [hi] "=&r"(hi), "+d"(yi)
+                : [x] "r"(&x[0]), [m] "r"(&mod[0]), [inv] "rm"(mod_inv)
+                : "cc", "memory");
+
+            t0 = t1;
+            t1 = t2;
+            t2 = t3;
+            t3 = t4;
+            t4 = t5;
+            t5 = t6;
+            t6 = t7;
+            t7 = 0;
+        }
+    }
+
+    // The result t < 2⋅mod needs the final subtraction, the same as in the generic version.
+    intx::uint<UintT::num_bits + 64> r;
+    if constexpr (S == 4)
+        r = {t0, t1, t2, t3, t4};
+    else
+        r = {t0, t1, t2, t3, t4, t5, t6};
+    if (r >= mod)
+        r -= mod;
+    return static_cast<UintT>(r);
+}
+}  // namespace evmmax::x86_64
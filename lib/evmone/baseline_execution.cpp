@@ -298,6 +298,10 @@ evmc_result execute(VM& vm, const evmc_host_interface& host, evmc_host_context*
 
     state.analysis.baseline = &analysis;  // Assign code analysis for instruction implementations.
 
+    state.keccak_cache = vm.keccak_cache.get();
+    if (state.keccak_cache != nullptr && msg.depth == 0)
+        state.keccak_cache->clear();  // The cache is scoped to a single transaction.
+
     const auto& cost_table = get_baseline_cost_table(state.rev, analysis.eof_header().version);
 
     auto* tracer = vm.get_tracer();
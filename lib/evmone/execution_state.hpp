@@ -19,6 +19,7 @@ namespace baseline
 {
 class CodeAnalysis;
 }
+class Keccak64Cache;
 
 using evmc::bytes;
 using evmc::bytes_view;
@@ -184,6 +185,11 @@ public:
 
     std::vector<const uint8_t*> call_stack;
 
+    /// The cache of the KECCAK256 results for 64-byte inputs (owned by the VM).
+    /// Null if the cache is disabled.
+    /// This should be set and used internally by execute() function of a particular interpreter.
+    Keccak64Cache* keccak_cache = nullptr;
+
     /// Stack space allocation.
     ///
     /// This is the last field to make other fields' offsets of reasonable values.
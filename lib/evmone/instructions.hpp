@@ -8,6 +8,7 @@
 #include "execution_state.hpp"
 #include "instructions_traits.hpp"
 #include "instructions_xmacro.hpp"
+#include "keccak_cache.hpp"
 #include <ethash/keccak.hpp>
 
 namespace evmone
@@ -363,7 +364,10 @@ inline Result keccak256(StackTop stack, int64_t gas_left, ExecutionState& state)
         return {EVMC_OUT_OF_GAS, gas_left};
 
     auto data = s != 0 ? &state.memory[i] : nullptr;
-    size = intx::be::load<uint256>(ethash::keccak256(data, s));
+    if (s == Keccak64Cache::INPUT_SIZE && state.keccak_cache != nullptr)
+        size = state.keccak_cache->keccak256(data);
+    else
+        size = intx::be::load<uint256>(ethash::keccak256(data, s));
     return {EVMC_SUCCESS, gas_left};
 }
 
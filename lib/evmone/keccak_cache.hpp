@@ -0,0 +1,88 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <ethash/keccak.hpp>
+#include <intx/intx.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace evmone
+{
+using intx::uint256;
+
+/// The cache of the KECCAK256 instruction results for 64-byte inputs.
+///
+/// Solidity computes the storage location of a mapping value as keccak256(key ‖ slot)
+/// over 64 bytes of memory. The same few keys (e.g. the sender's balance and allowances)
+/// are hashed many times in a transaction. The cache is direct-mapped and compares
+/// the full inputs so it never returns a wrong result.
+class Keccak64Cache
+{
+public:
+    /// The size of the cached inputs.
+    static constexpr size_t INPUT_SIZE = 64;
+
+    /// The number of the cache entries (power of 2).
+    static constexpr size_t NUM_ENTRIES = 64;
+
+    /// The cache hit-rate counters.
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+private:
+    struct Entry
+    {
+        uint8_t input[INPUT_SIZE]{};
+        uint256 hash;
+        bool valid = false;
+    };
+
+    Entry m_entries[NUM_ENTRIES]{};
+    Stats m_stats;
+
+    /// Selects the entry by the lowest 8 bytes of the two 32-byte words of the input
+    /// where the mapping key (e.g. an address) and the mapping slot number are.
+    static size_t index(const uint8_t* input) noexcept
+    {
+        static constexpr uint64_t K = 0x9e3779b97f4a7c15;  // The golden ratio multiplier.
+        uint64_t key = 0;
+        uint64_t slot = 0;
+        std::memcpy(&key, &input[24], sizeof(key));
+        std::memcpy(&slot, &input[56], sizeof(slot));
+        return static_cast<size_t>(((key ^ (slot * K)) * K) >> 58);
+    }
+    static_assert(NUM_ENTRIES == 1 << (64 - 58));
+
+public:
+    /// Returns the Keccak-256 hash of the 64-byte input as a big-endian number.
+    uint256 keccak256(const uint8_t* input) noexcept
+    {
+        auto& e = m_entries[index(input)];
+        if (e.valid && std::memcmp(e.input, input, INPUT_SIZE) == 0)
+        {
+            ++m_stats.hits;
+            return e.hash;
+        }
+
+        ++m_stats.misses;
+        std::memcpy(e.input, input, INPUT_SIZE);
+        e.hash = intx::be::load<uint256>(ethash::keccak256(input, INPUT_SIZE));
+        e.valid = true;
+        return e.hash;
+    }
+
+    /// Invalidates all entries. The counters are kept.
+    void clear() noexcept
+    {
+        for (auto& e : m_entries)
+            e.valid = false;
+    }
+
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+};
+}  // namespace evmone
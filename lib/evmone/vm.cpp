@@ -66,6 +66,11 @@ evmc_set_option_result set_option(evmc_vm* c_vm, char const* c_name, char const*
         vm.validate_eof = true;
         return EVMC_SET_OPTION_SUCCESS;
     }
+    else if (name == "keccak_cache")
+    {
+        vm.keccak_cache = std::make_unique<Keccak64Cache>();
+        return EVMC_SET_OPTION_SUCCESS;
+    }
     return EVMC_SET_OPTION_INVALID_NAME;
 }
 
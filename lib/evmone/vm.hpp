@@ -4,6 +4,7 @@
 #pragma once
 
 #include "execution_state.hpp"
+#include "keccak_cache.hpp"
 #include "tracing.hpp"
 #include <evmc/evmc.h>
 #include <vector>
@@ -23,6 +24,10 @@ public:
     bool cgoto = EVMONE_CGOTO_SUPPORTED;
     bool validate_eof = false;
 
+    /// The cache of the KECCAK256 results for 64-byte inputs (the "keccak_cache" option).
+    /// It is cleared at the beginning of every transaction (depth 0 execution).
+    std::unique_ptr<Keccak64Cache> keccak_cache;
+
 private:
     std::vector<ExecutionState> m_execution_states;
     std::unique_ptr<Tracer> m_first_tracer;
@@ -1,7 +1,13 @@
 #include "bls.hpp"
 #include <blst.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <memory>
 #include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace evmone::crypto::bls
@@ -89,6 +95,179 @@ void store(uint8_t _rx[128], const blst_fp2& _x) noexcept
     store(&_rx[64], _x.fp[1]);
 }
 
+/// The bit size of the MSM scalars.
+constexpr size_t MSM_SCALAR_BITS = 256;
+
+/// The minimal number of points of the MSM per thread. The smaller MSMs are computed
+/// by the calling thread only because the thread startup costs more than it saves.
+constexpr size_t MSM_MIN_POINTS_PER_THREAD = 16;
+
+/// The blst functions of the G1 group used by the generic MSM.
+struct G1
+{
+    using Point = blst_p1;
+    using Affine = blst_p1_affine;
+    static constexpr auto in_group = blst_p1_affine_in_g1;
+    static constexpr auto scratch_sizeof = blst_p1s_mult_pippenger_scratch_sizeof;
+    static constexpr auto mult_pippenger = blst_p1s_mult_pippenger;
+    static constexpr auto tile_pippenger = blst_p1s_tile_pippenger;
+    static constexpr auto add = blst_p1_add_or_double;
+    static constexpr auto dbl = blst_p1_double;
+    static constexpr auto to_affine = blst_p1_to_affine;
+};
+
+/// The blst functions of the G2 group used by the generic MSM.
+struct G2
+{
+    using Point = blst_p2;
+    using Affine = blst_p2_affine;
+    static constexpr auto in_group = blst_p2_affine_in_g2;
+    static constexpr auto scratch_sizeof = blst_p2s_mult_pippenger_scratch_sizeof;
+    static constexpr auto mult_pippenger = blst_p2s_mult_pippenger;
+    static constexpr auto tile_pippenger = blst_p2s_tile_pippenger;
+    static constexpr auto add = blst_p2_add_or_double;
+    static constexpr auto dbl = blst_p2_double;
+    static constexpr auto to_affine = blst_p2_to_affine;
+};
+
+/// The memory of the MSM inputs and of the Pippenger algorithm.
+///
+/// There is one arena per calling thread and it is reused by the following MSMs:
+/// the vectors are cleared but keep the capacity, so the MSM doesn't allocate
+/// unless the input is bigger than any before.
+template <typename G>
+struct MsmArena
+{
+    std::vector<typename G::Affine> points;
+    std::vector<blst_scalar> scalars;
+    std::vector<typename G::Point> windows;  ///< The partial results of the scalar windows.
+    std::vector<limb_t> scratch;
+
+    static MsmArena& local() noexcept
+    {
+        thread_local MsmArena arena;
+        return arena;
+    }
+
+    void clear() noexcept
+    {
+        points.clear();
+        scalars.clear();
+    }
+};
+
+/// Returns the number of threads to compute the MSM of the given number of points
+/// within the thread budget of the caller.
+size_t msm_num_threads(size_t npoints, size_t max_threads) noexcept
+{
+    return std::clamp(
+        npoints / MSM_MIN_POINTS_PER_THREAD, size_t{1}, std::max(max_threads, size_t{1}));
+}
+
+/// Calls fn(i, t) for every i in [0, n) using num_threads threads (including the calling one),
+/// where t in [0, num_threads) identifies the thread. The fn must not throw.
+///
+/// If a thread cannot be started the work is done by the already running ones.
+template <typename Fn>
+void parallel_for(size_t n, size_t num_threads, const Fn& fn) noexcept
+{
+    static_assert(std::is_nothrow_invocable_v<const Fn&, size_t, size_t>);
+
+    std::atomic<size_t> next = 0;
+    const auto worker = [&](size_t t) noexcept {
+        for (auto i = next++; i < n; i = next++)
+            fn(i, t);
+    };
+
+    std::vector<std::thread> threads;
+    try
+    {
+        threads.reserve(num_threads - 1);
+        for (size_t t = 1; t < num_threads; ++t)
+            threads.emplace_back(worker, t);
+    }
+    catch (...)
+    {}
+    worker(0);
+    for (auto& t : threads)
+        t.join();
+}
+
+/// Returns the Pippenger window size in bits for the number of points. This is the same
+/// heuristic as used by blst for the single-threaded Pippenger.
+constexpr size_t pippenger_window_size(size_t npoints) noexcept
+{
+    const auto wbits = static_cast<size_t>(std::bit_width(npoints)) - 1;
+    return wbits > 12 ? wbits - 3 : (wbits > 4 ? wbits - 2 : (wbits != 0 ? 2 : 1));
+}
+
+/// Computes the MSM ∑ sₖPₖ of the points and scalars collected in the arena.
+///
+/// Performs the subgroup checks of the points and returns std::nullopt if any fails.
+/// The points must not be the point at infinity. For the MSM of many points
+/// both the subgroup checks and the Pippenger algorithm are split between threads:
+/// the scalars are split into windows of bits and each window is computed by
+/// the blst Pippenger "tile" over all points. The window results are then combined
+/// with the doublings.
+template <typename G>
+std::optional<typename G::Affine> msm(MsmArena<G>& arena, size_t max_threads) noexcept
+{
+    const auto npoints = arena.points.size();
+    typename G::Affine result{};
+    if (npoints == 0)
+        return result;
+
+    const auto num_threads = msm_num_threads(npoints, max_threads);
+
+    std::atomic<bool> in_group = true;
+    parallel_for(npoints, num_threads, [&](size_t i, size_t) noexcept {
+        if (!G::in_group(&arena.points[i]))
+            in_group = false;
+    });
+    if (!in_group)
+        return std::nullopt;
+
+    // The arrays of pointers with the second one null are interpreted by blst
+    // as the pointer to the contiguous array.
+    const typename G::Affine* const points[] = {arena.points.data(), nullptr};
+    const byte* const scalars[] = {arena.scalars.data()->b, nullptr};
+
+    typename G::Point out;
+    if (num_threads == 1)
+    {
+        arena.scratch.resize(G::scratch_sizeof(npoints) / sizeof(limb_t));
+        G::mult_pippenger(&out, points, npoints, scalars, MSM_SCALAR_BITS, arena.scratch.data());
+    }
+    else
+    {
+        // Split the scalar bits into windows, the top one is narrower than the others
+        // to have room for the carry of the signed digits.
+        const auto num_windows = MSM_SCALAR_BITS / pippenger_window_size(npoints) + 1;
+        const auto window = MSM_SCALAR_BITS / num_windows + 1;
+
+        // Each thread needs the buckets of a single window.
+        const auto tile_scratch_size = G::scratch_sizeof(0) / sizeof(limb_t) << (window - 1);
+        arena.scratch.resize(tile_scratch_size * num_threads);
+        arena.windows.resize(num_windows);
+
+        parallel_for(num_windows, num_threads, [&](size_t w, size_t t) noexcept {
+            G::tile_pippenger(&arena.windows[w], points, npoints, scalars, MSM_SCALAR_BITS,
+                &arena.scratch[t * tile_scratch_size], w * window, window);
+        });
+
+        out = arena.windows[num_windows - 1];
+        for (auto w = num_windows - 1; w-- != 0;)
+        {
+            for (size_t i = 0; i < window; ++i)
+                G::dbl(&out, &out);
+            G::add(&out, &out, &arena.windows[w]);
+        }
+    }
+
+    G::to_affine(&result, &out);
+    return result;
+}
+
 }  // namespace
 
 [[nodiscard]] bool g1_add(uint8_t _rx[64], uint8_t _ry[64], const uint8_t _x0[64],
@@ -191,133 +370,65 @@ void store(uint8_t _rx[128], const blst_fp2& _x) noexcept
     return true;
 }
 
-[[nodiscard]] bool g1_msm(
-    uint8_t _rx[64], uint8_t _ry[64], const uint8_t* _xycs, size_t size) noexcept
+[[nodiscard]] bool g1_msm(uint8_t _rx[64], uint8_t _ry[64], const uint8_t* _xycs, size_t size,
+    size_t num_threads) noexcept
 {
     constexpr auto SINGLE_ENTRY_SIZE = (64 * 2 + 32);
     assert(size % SINGLE_ENTRY_SIZE == 0);
-    auto npoints = size / SINGLE_ENTRY_SIZE;
-
-    std::vector<blst_p1_affine> p1_affines;
-    std::vector<const blst_p1_affine*> p1_affine_ptrs;
-    p1_affines.reserve(npoints);
-    p1_affine_ptrs.reserve(npoints);
-
-    std::vector<blst_scalar> scalars;
-    std::vector<const uint8_t*> scalars_ptrs;
-    scalars.reserve(npoints);
-    scalars_ptrs.reserve(npoints);
 
-    auto ptr = _xycs;
-    for (size_t i = 0; i < npoints; ++i)
+    auto& arena = MsmArena<G1>::local();
+    arena.clear();
+    for (auto ptr = _xycs; ptr != _xycs + size; ptr += SINGLE_ENTRY_SIZE)
     {
         const auto p_affine = validate_p1(ptr, &ptr[64]);
         if (!p_affine.has_value())
             return false;
 
-        if (!blst_p1_affine_in_g1(&*p_affine))
-            return false;
-
         // Point at infinity must be filtered out for BLST library.
         if (blst_p1_affine_is_inf(&*p_affine))
             continue;
 
-        const auto& p = p1_affines.emplace_back(*p_affine);
-        p1_affine_ptrs.emplace_back(&p);
-
-        blst_scalar scalar;
-        blst_scalar_from_bendian(&scalar, &ptr[128]);
-        const auto& s = scalars.emplace_back(scalar);
-        scalars_ptrs.emplace_back(s.b);
-
-        ptr += SINGLE_ENTRY_SIZE;
-    }
-
-    npoints = p1_affine_ptrs.size();
-
-    if (npoints == 0)
-    {
-        memset(_rx, 0, 64);
-        memset(_ry, 0, 64);
-        return true;
+        arena.points.emplace_back(*p_affine);
+        blst_scalar_from_bendian(&arena.scalars.emplace_back(), &ptr[128]);
     }
 
-    const auto scratch_size = blst_p1s_mult_pippenger_scratch_sizeof(npoints) / sizeof(limb_t);
-    const auto scratch_space = std::make_unique_for_overwrite<limb_t[]>(scratch_size);
-    blst_p1 out;
-    blst_p1s_mult_pippenger(
-        &out, p1_affine_ptrs.data(), npoints, scalars_ptrs.data(), 256, scratch_space.get());
-
-    blst_p1_affine result;
-    blst_p1_to_affine(&result, &out);
-    store(_rx, result.x);
-    store(_ry, result.y);
+    const auto result = msm(arena, num_threads);
+    if (!result.has_value())
+        return false;
 
+    store(_rx, result->x);
+    store(_ry, result->y);
     return true;
 }
 
-[[nodiscard]] bool g2_msm(
-    uint8_t _rx[128], uint8_t _ry[128], const uint8_t* _xycs, size_t size) noexcept
+[[nodiscard]] bool g2_msm(uint8_t _rx[128], uint8_t _ry[128], const uint8_t* _xycs, size_t size,
+    size_t num_threads) noexcept
 {
     constexpr auto SINGLE_ENTRY_SIZE = (128 * 2 + 32);
     assert(size % SINGLE_ENTRY_SIZE == 0);
-    auto npoints = size / SINGLE_ENTRY_SIZE;
-
-    std::vector<blst_p2_affine> p2_affines;
-    std::vector<const blst_p2_affine*> p2_affine_ptrs;
-    p2_affines.reserve(npoints);
-    p2_affine_ptrs.reserve(npoints);
 
-    std::vector<blst_scalar> scalars;
-    std::vector<const uint8_t*> scalars_ptrs;
-    scalars.reserve(npoints);
-    scalars_ptrs.reserve(npoints);
-
-    auto ptr = _xycs;
-    for (size_t i = 0; i < npoints; ++i)
+    auto& arena = MsmArena<G2>::local();
+    arena.clear();
+    for (auto ptr = _xycs; ptr != _xycs + size; ptr += SINGLE_ENTRY_SIZE)
     {
         const auto p_affine = validate_p2(ptr, &ptr[128]);
         if (!p_affine.has_value())
             return false;
 
-        if (!blst_p2_affine_in_g2(&*p_affine))
-            return false;
-
         // Point at infinity must be filtered out for BLST library.
         if (blst_p2_affine_is_inf(&*p_affine))
             continue;
 
-        const auto& p = p2_affines.emplace_back(*p_affine);
-        p2_affine_ptrs.emplace_back(&p);
-
-        blst_scalar scalar;
-        blst_scalar_from_bendian(&scalar, &ptr[256]);
-        const auto& s = scalars.emplace_back(scalar);
-        scalars_ptrs.emplace_back(s.b);
-
-        ptr += SINGLE_ENTRY_SIZE;
-    }
-
-    npoints = p2_affine_ptrs.size();
-
-    if (npoints == 0)
-    {
-        memset(_rx, 0, 128);
-        memset(_ry, 0, 128);
-        return true;
+        arena.points.emplace_back(*p_affine);
+        blst_scalar_from_bendian(&arena.scalars.emplace_back(), &ptr[256]);
     }
 
-    const auto scratch_size = blst_p2s_mult_pippenger_scratch_sizeof(npoints) / sizeof(limb_t);
-    const auto scratch_space = std::make_unique_for_overwrite<limb_t[]>(scratch_size);
-    blst_p2 out;
-    blst_p2s_mult_pippenger(
-        &out, p2_affine_ptrs.data(), npoints, scalars_ptrs.data(), 256, scratch_space.get());
-
-    blst_p2_affine result;
-    blst_p2_to_affine(&result, &out);
-    store(_rx, result.x);
-    store(_ry, result.y);
+    const auto result = msm(arena, num_threads);
+    if (!result.has_value())
+        return false;
 
+    store(_rx, result->x);
+    store(_ry, result->y);
     return true;
 }
 
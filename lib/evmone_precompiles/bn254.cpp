@@ -3,14 +3,29 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "bn254.hpp"
+#include <evmmax/safegcd.hpp>
+#include <bit>
+#include <vector>
 
 namespace evmmax::bn254
 {
 namespace
 {
-constexpr ModArith Fp{FieldPrime};
+constexpr FieldArith Fp{FieldPrime};
 constexpr auto B = Fp.to_mont(3);
 constexpr auto B3 = Fp.to_mont(3 * 3);
+
+/// The GLV endomorphism of the BN254 G1 curve, see ecc::GLV.
+constexpr ecc::GLV<uint256> G1_GLV{
+    Fp.to_mont(0x59e26bcea0d48bacd4f263f1acdb5c4f5763473177fffffe_u256),
+    0x89d3256894d213e3_u256,
+    -0x6f4d8248eeb859fc8211bbeb7d4f1128_u256,
+    0x6f4d8248eeb859fd0be4e1541221250b_u256,
+    0x89d3256894d213e3_u256,
+    0xb64748cbb1f82cf5dbae71c51dce9bbca3e9f4cb4bebee99_u256,
+    0x9333bc0529dcf4b3de9ef6750e47ac636978e33ed7aa89b661a4dd45a6e6f7ff_u256,
+    382,
+};
 }  // namespace
 
 bool validate(const Point& pt) noexcept
@@ -20,8 +35,8 @@ bool validate(const Point& pt) noexcept
 
     const auto xm = Fp.to_mont(pt.x);
     const auto ym = Fp.to_mont(pt.y);
-    const auto y2 = Fp.mul(ym, ym);
-    const auto x2 = Fp.mul(xm, xm);
+    const auto y2 = Fp.sqr(ym);
+    const auto x2 = Fp.sqr(xm);
     const auto x3 = Fp.mul(x2, xm);
     const auto x3_3 = Fp.add(x3, B);
     return y2 == x3_3;
@@ -48,373 +63,600 @@ Point mul(const Point& pt, const uint256& c) noexcept
     if (c == 0)
         return {};
 
-    const auto pr = ecc::mul(Fp, ecc::to_proj(Fp, pt), c, B3);
+    const auto pr = ecc::mul(Fp, ecc::to_proj(Fp, pt), c, B3, G1_GLV);
 
     return ecc::to_affine(Fp, field_inv, pr);
 }
 
-uint256 field_inv(const ModArith<uint256>& m, const uint256& x) noexcept
-{
-    // Computes modular exponentiation
-    // x^0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd45
-    // Operations: 247 squares 56 multiplies
-    // Generated by github.com/mmcloughlin/addchain v0.4.0.
-    //   addchain search 0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd45
-    //     > bn254_field_inv.acc
-    //   addchain gen -tmpl expmod.tmpl bn254_field_inv.acc
-    //     > bn254_field_inv.cpp
-    //
-    // Inversion computation is derived from the addition chain:
-    //
-    //	_10       = 2*1
-    //	_11       = 1 + _10
-    //	_101      = _10 + _11
-    //	_110      = 1 + _101
-    //	_1000     = _10 + _110
-    //	_1101     = _101 + _1000
-    //	_10010    = _101 + _1101
-    //	_10011    = 1 + _10010
-    //	_10100    = 1 + _10011
-    //	_10111    = _11 + _10100
-    //	_11100    = _101 + _10111
-    //	_100000   = _1101 + _10011
-    //	_100011   = _11 + _100000
-    //	_101011   = _1000 + _100011
-    //	_101111   = _10011 + _11100
-    //	_1000001  = _10010 + _101111
-    //	_1010011  = _10010 + _1000001
-    //	_1011011  = _1000 + _1010011
-    //	_1100001  = _110 + _1011011
-    //	_1110101  = _10100 + _1100001
-    //	_10010001 = _11100 + _1110101
-    //	_10010101 = _100000 + _1110101
-    //	_10110101 = _100000 + _10010101
-    //	_10111011 = _110 + _10110101
-    //	_11000001 = _110 + _10111011
-    //	_11000011 = _10 + _11000001
-    //	_11010011 = _10010 + _11000001
-    //	_11100001 = _100000 + _11000001
-    //	_11100011 = _10 + _11100001
-    //	_11100111 = _110 + _11100001
-    //	i57       = ((_11000001 << 8 + _10010001) << 10 + _11100111) << 7
-    //	i76       = ((_10111 + i57) << 9 + _10011) << 7 + _1101
-    //	i109      = ((i76 << 14 + _1010011) << 9 + _11100001) << 8
-    //	i127      = ((_1000001 + i109) << 10 + _1011011) << 5 + _1101
-    //	i161      = ((i127 << 8 + _11) << 12 + _101011) << 12
-    //	i186      = ((_10111011 + i161) << 8 + _101111) << 14 + _10110101
-    //	i214      = ((i186 << 9 + _10010001) << 5 + _1101) << 12
-    //	i236      = ((_11100011 + i214) << 8 + _10010101) << 11 + _11010011
-    //	i268      = ((i236 << 7 + _1100001) << 11 + _100011) << 12
-    //	i288      = ((_1011011 + i268) << 9 + _11000011) << 8 + _11100111
-    //	return      (i288 << 7 + _1110101) << 6 + _101
-    //
-    // Operations: 247 squares 56 m.multiplies
-    //
-    // Generated by github.com/mmcloughlin/addchain v0.4.0.
-
-    // Allocate Temporaries.
-    uint256 t0;
-    uint256 t1;
-    uint256 t2;
-    uint256 t3;
-    uint256 t4;
-    uint256 t5;
-    uint256 t6;
-    uint256 t7;
-    uint256 t8;
-    uint256 t9;
-    uint256 t10;
-    uint256 t11;
-    uint256 t12;
-    uint256 t13;
-    uint256 t14;
-    uint256 t15;
-    uint256 t16;
-    uint256 t17;
-    uint256 t18;
-    uint256 t19;
-    uint256 t20;
-    uint256 t21;
-    // Step 1: t8 = x^0x2
-    t8 = m.mul(x, x);
-
-    // Step 2: t15 = x^0x3
-    t15 = m.mul(x, t8);
-
-    // Step 3: z = x^0x5
-    auto z = m.mul(t8, t15);
-
-    // Step 4: t1 = x^0x6
-    t1 = m.mul(x, z);
-
-    // Step 5: t3 = x^0x8
-    t3 = m.mul(t8, t1);
-
-    // Step 6: t9 = x^0xd
-    t9 = m.mul(z, t3);
-
-    // Step 7: t6 = x^0x12
-    t6 = m.mul(z, t9);
-
-    // Step 8: t19 = x^0x13
-    t19 = m.mul(x, t6);
-
-    // Step 9: t0 = x^0x14
-    t0 = m.mul(x, t19);
-
-    // Step 10: t20 = x^0x17
-    t20 = m.mul(t15, t0);
-
-    // Step 11: t2 = x^0x1c
-    t2 = m.mul(z, t20);
-
-    // Step 12: t17 = x^0x20
-    t17 = m.mul(t9, t19);
-
-    // Step 13: t4 = x^0x23
-    t4 = m.mul(t15, t17);
-
-    // Step 14: t14 = x^0x2b
-    t14 = m.mul(t3, t4);
-
-    // Step 15: t12 = x^0x2f
-    t12 = m.mul(t19, t2);
-
-    // Step 16: t16 = x^0x41
-    t16 = m.mul(t6, t12);
-
-    // Step 17: t18 = x^0x53
-    t18 = m.mul(t6, t16);
-
-    // Step 18: t3 = x^0x5b
-    t3 = m.mul(t3, t18);
-
-    // Step 19: t5 = x^0x61
-    t5 = m.mul(t1, t3);
-
-    // Step 20: t0 = x^0x75
-    t0 = m.mul(t0, t5);
-
-    // Step 21: t10 = x^0x91
-    t10 = m.mul(t2, t0);
-
-    // Step 22: t7 = x^0x95
-    t7 = m.mul(t17, t0);
-
-    // Step 23: t11 = x^0xb5
-    t11 = m.mul(t17, t7);
-
-    // Step 24: t13 = x^0xbb
-    t13 = m.mul(t1, t11);
-
-    // Step 25: t21 = x^0xc1
-    t21 = m.mul(t1, t13);
-
-    // Step 26: t2 = x^0xc3
-    t2 = m.mul(t8, t21);
-
-    // Step 27: t6 = x^0xd3
-    t6 = m.mul(t6, t21);
-
-    // Step 28: t17 = x^0xe1
-    t17 = m.mul(t17, t21);
-
-    // Step 29: t8 = x^0xe3
-    t8 = m.mul(t8, t17);
-
-    // Step 30: t1 = x^0xe7
-    t1 = m.mul(t1, t17);
-
-    // Step 38: t21 = x^0xc100
-    for (int i = 0; i < 8; ++i)
-        t21 = m.mul(t21, t21);
-
-    // Step 39: t21 = x^0xc191
-    t21 = m.mul(t10, t21);
+uint256 field_inv(const FieldArith& m, const uint256& x) noexcept
+{
+    return safegcd::inv(m, x);
+}
 
-    // Step 49: t21 = x^0x3064400
-    for (int i = 0; i < 10; ++i)
-        t21 = m.mul(t21, t21);
+namespace
+{
+/// The element of the quadratic extension field Fp2 = Fp[u]/(u²+1): c0 + c1⋅u.
+/// The coefficients are in the Montgomery form.
+struct Fp2
+{
+    uint256 c0;
+    uint256 c1;
 
-    // Step 50: t21 = x^0x30644e7
-    t21 = m.mul(t1, t21);
+    friend constexpr bool operator==(const Fp2& a, const Fp2& b) noexcept = default;
+};
 
-    // Step 57: t21 = x^0x183227380
-    for (int i = 0; i < 7; ++i)
-        t21 = m.mul(t21, t21);
+/// The element of the cubic extension field Fp6 = Fp2[v]/(v³-ξ), ξ = 9+u: c0 + c1⋅v + c2⋅v².
+struct Fp6
+{
+    Fp2 c0;
+    Fp2 c1;
+    Fp2 c2;
+
+    friend constexpr bool operator==(const Fp6& a, const Fp6& b) noexcept = default;
+};
+
+/// The element of the quadratic extension field Fp12 = Fp6[w]/(w²-v): c0 + c1⋅w.
+///
+/// Equivalently, this is Fp2[w]/(w⁶-ξ) with the coefficients of w⁰, w², w⁴ in c0
+/// and the coefficients of w¹, w³, w⁵ in c1.
+struct Fp12
+{
+    Fp6 c0;
+    Fp6 c1;
 
-    // Step 58: t20 = x^0x183227397
-    t20 = m.mul(t20, t21);
+    friend constexpr bool operator==(const Fp12& a, const Fp12& b) noexcept = default;
+};
 
-    // Step 67: t20 = x^0x30644e72e00
-    for (int i = 0; i < 9; ++i)
-        t20 = m.mul(t20, t20);
+/// Converts the Fp2 element c0 + c1⋅u to the Montgomery form.
+constexpr Fp2 to_mont(const uint256& c0, const uint256& c1) noexcept
+{
+    return {Fp.to_mont(c0), Fp.to_mont(c1)};
+}
 
-    // Step 68: t19 = x^0x30644e72e13
-    t19 = m.mul(t19, t20);
+constexpr Fp2 operator+(const Fp2& a, const Fp2& b) noexcept
+{
+    return {Fp.add(a.c0, b.c0), Fp.add(a.c1, b.c1)};
+}
 
-    // Step 75: t19 = x^0x1832273970980
-    for (int i = 0; i < 7; ++i)
-        t19 = m.mul(t19, t19);
+constexpr Fp2 operator-(const Fp2& a, const Fp2& b) noexcept
+{
+    return {Fp.sub(a.c0, b.c0), Fp.sub(a.c1, b.c1)};
+}
 
-    // Step 76: t19 = x^0x183227397098d
-    t19 = m.mul(t9, t19);
+constexpr Fp2 operator-(const Fp2& a) noexcept
+{
+    return {Fp.sub(0, a.c0), Fp.sub(0, a.c1)};
+}
 
-    // Step 90: t19 = x^0x60c89ce5c2634000
-    for (int i = 0; i < 14; ++i)
-        t19 = m.mul(t19, t19);
+constexpr Fp2 operator*(const Fp2& a, const Fp2& b) noexcept
+{
+    // Karatsuba: (a0 + a1⋅u)(b0 + b1⋅u) = a0⋅b0 - a1⋅b1 + ((a0 + a1)(b0 + b1) - a0⋅b0 - a1⋅b1)⋅u.
+    const auto t0 = Fp.mul(a.c0, b.c0);
+    const auto t1 = Fp.mul(a.c1, b.c1);
+    const auto t2 = Fp.mul(Fp.add(a.c0, a.c1), Fp.add(b.c0, b.c1));
+    return {Fp.sub(t0, t1), Fp.sub(t2, Fp.add(t0, t1))};
+}
 
-    // Step 91: t18 = x^0x60c89ce5c2634053
-    t18 = m.mul(t18, t19);
+/// Multiplies the Fp2 element by the Fp element (in the Montgomery form).
+constexpr Fp2 operator*(const Fp2& a, const uint256& s) noexcept
+{
+    return {Fp.mul(a.c0, s), Fp.mul(a.c1, s)};
+}
 
-    // Step 100: t18 = x^0xc19139cb84c680a600
-    for (int i = 0; i < 9; ++i)
-        t18 = m.mul(t18, t18);
+constexpr Fp2 sqr(const Fp2& a) noexcept
+{
+    // (a0 + a1⋅u)² = (a0 + a1)(a0 - a1) + 2⋅a0⋅a1⋅u.
+    const auto t = Fp.mul(a.c0, a.c1);
+    return {Fp.mul(Fp.add(a.c0, a.c1), Fp.sub(a.c0, a.c1)), Fp.add(t, t)};
+}
 
-    // Step 101: t17 = x^0xc19139cb84c680a6e1
-    t17 = m.mul(t17, t18);
+constexpr Fp2 conj(const Fp2& a) noexcept
+{
+    return {a.c0, Fp.sub(0, a.c1)};
+}
 
-    // Step 109: t17 = x^0xc19139cb84c680a6e100
-    for (int i = 0; i < 8; ++i)
-        t17 = m.mul(t17, t17);
+/// Multiplies by the non-residue ξ = 9+u: (9+u)(a0 + a1⋅u) = 9⋅a0 - a1 + (a0 + 9⋅a1)⋅u.
+constexpr Fp2 mul_by_xi(const Fp2& a) noexcept
+{
+    auto t = a + a;
+    t = t + t;
+    t = t + t;
+    t = t + a;
+    return {Fp.sub(t.c0, a.c1), Fp.add(t.c1, a.c0)};
+}
 
-    // Step 110: t16 = x^0xc19139cb84c680a6e141
-    t16 = m.mul(t16, t17);
+Fp2 inv(const Fp2& a) noexcept
+{
+    // 1/(a0 + a1⋅u) = (a0 - a1⋅u)/(a0² + a1²).
+    const auto t = field_inv(Fp, Fp.add(Fp.sqr(a.c0), Fp.sqr(a.c1)));
+    return conj(a) * t;
+}
 
-    // Step 120: t16 = x^0x30644e72e131a029b850400
-    for (int i = 0; i < 10; ++i)
-        t16 = m.mul(t16, t16);
+constexpr Fp6 operator+(const Fp6& a, const Fp6& b) noexcept
+{
+    return {a.c0 + b.c0, a.c1 + b.c1, a.c2 + b.c2};
+}
 
-    // Step 121: t16 = x^0x30644e72e131a029b85045b
-    t16 = m.mul(t3, t16);
+constexpr Fp6 operator-(const Fp6& a, const Fp6& b) noexcept
+{
+    return {a.c0 - b.c0, a.c1 - b.c1, a.c2 - b.c2};
+}
 
-    // Step 126: t16 = x^0x60c89ce5c263405370a08b60
-    for (int i = 0; i < 5; ++i)
-        t16 = m.mul(t16, t16);
+constexpr Fp6 operator-(const Fp6& a) noexcept
+{
+    return {-a.c0, -a.c1, -a.c2};
+}
 
-    // Step 127: t16 = x^0x60c89ce5c263405370a08b6d
-    t16 = m.mul(t9, t16);
+constexpr Fp6 operator*(const Fp6& a, const Fp6& b) noexcept
+{
+    // Devegili, Ó hÉigeartaigh, Scott, Dahab "Multiplication and Squaring on Pairing-Friendly
+    // Fields", https://eprint.iacr.org/2006/471, Section 4 (Karatsuba).
+    const auto t0 = a.c0 * b.c0;
+    const auto t1 = a.c1 * b.c1;
+    const auto t2 = a.c2 * b.c2;
+    return {
+        mul_by_xi((a.c1 + a.c2) * (b.c1 + b.c2) - t1 - t2) + t0,
+        (a.c0 + a.c1) * (b.c0 + b.c1) - t0 - t1 + mul_by_xi(t2),
+        (a.c0 + a.c2) * (b.c0 + b.c2) - t0 - t2 + t1,
+    };
+}
 
-    // Step 135: t16 = x^0x60c89ce5c263405370a08b6d00
-    for (int i = 0; i < 8; ++i)
-        t16 = m.mul(t16, t16);
+/// Multiplies the Fp6 element by the Fp2 element.
+constexpr Fp6 operator*(const Fp6& a, const Fp2& b) noexcept
+{
+    return {a.c0 * b, a.c1 * b, a.c2 * b};
+}
 
-    // Step 136: t15 = x^0x60c89ce5c263405370a08b6d03
-    t15 = m.mul(t15, t16);
+/// Multiplies by the sparse Fp6 element b0 + b1⋅v.
+constexpr Fp6 mul_by_01(const Fp6& a, const Fp2& b0, const Fp2& b1) noexcept
+{
+    const auto t0 = a.c0 * b0;
+    const auto t1 = a.c1 * b1;
+    return {
+        mul_by_xi((a.c1 + a.c2) * b1 - t1) + t0,
+        (a.c0 + a.c1) * (b0 + b1) - t0 - t1,
+        (a.c0 + a.c2) * b0 - t0 + t1,
+    };
+}
 
-    // Step 148: t15 = x^0x60c89ce5c263405370a08b6d03000
-    for (int i = 0; i < 12; ++i)
-        t15 = m.mul(t15, t15);
+/// Multiplies by v: v⋅(a0 + a1⋅v + a2⋅v²) = ξ⋅a2 + a0⋅v + a1⋅v².
+constexpr Fp6 mul_by_v(const Fp6& a) noexcept
+{
+    return {mul_by_xi(a.c2), a.c0, a.c1};
+}
 
-    // Step 149: t14 = x^0x60c89ce5c263405370a08b6d0302b
-    t14 = m.mul(t14, t15);
+Fp6 inv(const Fp6& a) noexcept
+{
+    // Scott "Implementing cryptographic pairings", Section 3.2.
+    const auto t0 = sqr(a.c0) - mul_by_xi(a.c1 * a.c2);
+    const auto t1 = mul_by_xi(sqr(a.c2)) - a.c0 * a.c1;
+    const auto t2 = sqr(a.c1) - a.c0 * a.c2;
+    const auto t = inv(a.c0 * t0 + mul_by_xi(a.c2 * t1 + a.c1 * t2));
+    return {t0 * t, t1 * t, t2 * t};
+}
 
-    // Step 161: t14 = x^0x60c89ce5c263405370a08b6d0302b000
-    for (int i = 0; i < 12; ++i)
-        t14 = m.mul(t14, t14);
+constexpr Fp12 operator*(const Fp12& a, const Fp12& b) noexcept
+{
+    const auto t0 = a.c0 * b.c0;
+    const auto t1 = a.c1 * b.c1;
+    return {t0 + mul_by_v(t1), (a.c0 + a.c1) * (b.c0 + b.c1) - t0 - t1};
+}
 
-    // Step 162: t13 = x^0x60c89ce5c263405370a08b6d0302b0bb
-    t13 = m.mul(t13, t14);
+constexpr Fp12 sqr(const Fp12& a) noexcept
+{
+    // The complex squaring: (a0 + a1⋅w)² = (a0 + a1)(a0 + v⋅a1) - a0⋅a1 - v⋅a0⋅a1 + 2⋅a0⋅a1⋅w.
+    const auto t = a.c0 * a.c1;
+    return {(a.c0 + a.c1) * (a.c0 + mul_by_v(a.c1)) - t - mul_by_v(t), t + t};
+}
 
-    // Step 170: t13 = x^0x60c89ce5c263405370a08b6d0302b0bb00
-    for (int i = 0; i < 8; ++i)
-        t13 = m.mul(t13, t13);
+/// The conjugation, i.e. the Frobenius endomorphism π^6 (raising to the power p⁶).
+/// For elements of the cyclotomic subgroup this is the inversion.
+constexpr Fp12 conj(const Fp12& a) noexcept
+{
+    return {a.c0, -a.c1};
+}
 
-    // Step 171: t12 = x^0x60c89ce5c263405370a08b6d0302b0bb2f
-    t12 = m.mul(t12, t13);
+Fp12 inv(const Fp12& a) noexcept
+{
+    // 1/(a0 + a1⋅w) = (a0 - a1⋅w)/(a0² - v⋅a1²).
+    const auto t = inv(a.c0 * a.c0 - mul_by_v(a.c1 * a.c1));
+    return {a.c0 * t, -(a.c1 * t)};
+}
 
-    // Step 185: t12 = x^0x183227397098d014dc2822db40c0ac2ecbc000
-    for (int i = 0; i < 14; ++i)
-        t12 = m.mul(t12, t12);
+/// Squares the Fp12 element of the cyclotomic subgroup (e.g. after the easy part of the final
+/// exponentiation).
+///
+/// Granger, Scott "Faster Squaring in the Cyclotomic Subgroup of Sixth Degree Extensions",
+/// https://eprint.iacr.org/2009/565, Section 3.2. The Fp12 is seen as Fp4[w]/(w³-τ)
+/// where Fp4 = Fp2[τ]/(τ²-ξ), τ = w³. Then for a = g0 + g1⋅w + g2⋅w²:
+/// a² = (3⋅g0² - 2⋅ḡ0) + (3⋅τ⋅g2² + 2⋅ḡ1)⋅w + (3⋅g1² - 2⋅ḡ2)⋅w².
+constexpr Fp12 cyclotomic_sqr(const Fp12& a) noexcept
+{
+    // Squares the Fp4 element x0 + x1⋅τ: x0² + ξ⋅x1² + 2⋅x0⋅x1⋅τ.
+    const auto fp4_sqr = [](const Fp2& x0, const Fp2& x1) noexcept {
+        const auto t0 = sqr(x0);
+        const auto t1 = sqr(x1);
+        return std::pair{t0 + mul_by_xi(t1), sqr(x0 + x1) - t0 - t1};
+    };
+
+    // g0 = c0.c0 + c1.c1⋅τ, g1 = c1.c0 + c0.c2⋅τ, g2 = c0.c1 + c1.c2⋅τ.
+    const auto [a0, a1] = fp4_sqr(a.c0.c0, a.c1.c1);
+    const auto [b0, b1] = fp4_sqr(a.c1.c0, a.c0.c2);
+    const auto [c0, c1] = fp4_sqr(a.c0.c1, a.c1.c2);
+    const auto tc1 = mul_by_xi(c1);  // τ⋅(c0 + c1⋅τ) = ξ⋅c1 + c0⋅τ.
+
+    const auto three_minus_two = [](const Fp2& x, const Fp2& y) noexcept {
+        const auto t = x - y;
+        return t + t + x;  // 3⋅x - 2⋅y
+    };
+    const auto three_plus_two = [](const Fp2& x, const Fp2& y) noexcept {
+        const auto t = x + y;
+        return t + t + x;  // 3⋅x + 2⋅y
+    };
+
+    return {
+        {
+            three_minus_two(a0, a.c0.c0),
+            three_minus_two(b0, a.c0.c1),
+            three_minus_two(c0, a.c0.c2),
+        },
+        {
+            three_plus_two(tc1, a.c1.c0),
+            three_plus_two(a1, a.c1.c1),
+            three_plus_two(b1, a.c1.c2),
+        },
+    };
+}
 
-    // Step 186: t11 = x^0x183227397098d014dc2822db40c0ac2ecbc0b5
-    t11 = m.mul(t11, t12);
+/// The identity element of Fp12.
+constexpr Fp12 FP12_ONE{{{Fp.to_mont(1), 0}, {}, {}}, {}};
+
+/// The Frobenius coefficients γ₁,ᵢ = ξ^(i⋅(p-1)/6), i = 1..5.
+constexpr Fp2 FROBENIUS_COEFFS_1[] = {
+    to_mont(0x1284b71c2865a7dfe8b99fdd76e68b605c521e08292f2176d60b35dadcc9e470_u256,
+        0x246996f3b4fae7e6a6327cfe12150b8e747992778eeec7e5ca5cf05f80f362ac_u256),
+    to_mont(0x2fb347984f7911f74c0bec3cf559b143b78cc310c2c3330c99e39557176f553d_u256,
+        0x16c9e55061ebae204ba4cc8bd75a079432ae2a1d0b7c9dce1665d51c640fcba2_u256),
+    to_mont(0x063cf305489af5dcdc5ec698b6e2f9b9dbaae0eda9c95998dc54014671a0135a_u256,
+        0x07c03cbcac41049a0704b5a7ec796f2b21807dc98fa25bd282d37f632623b0e3_u256),
+    to_mont(0x05b54f5e64eea80180f3c0b75a181e84d33365f7be94ec72848a1f55921ea762_u256,
+        0x2c145edbe7fd8aee9f3a80b03b0b1c923685d2ea1bdec763c13b4711cd2b8126_u256),
+    to_mont(0x0183c1e74f798649e93a3661a4353ff4425c459b55aa1bd32ea2c810eab7692f_u256,
+        0x12acf2ca76fd0675a27fb246c7729f7db080cb99678e2ac024c6b8ee6e0c2c4b_u256),
+};
+
+/// The Frobenius coefficients γ₂,ᵢ = ξ^(i⋅(p²-1)/6), i = 1..5. These are in Fp.
+constexpr uint256 FROBENIUS_COEFFS_2[] = {
+    Fp.to_mont(0x30644e72e131a0295e6dd9e7e0acccb0c28f069fbb966e3de4bd44e5607cfd49_u256),
+    Fp.to_mont(0x30644e72e131a0295e6dd9e7e0acccb0c28f069fbb966e3de4bd44e5607cfd48_u256),
+    Fp.to_mont(0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd46_u256),
+    Fp.to_mont(0x000000000000000059e26bcea0d48bacd4f263f1acdb5c4f5763473177fffffe_u256),
+    Fp.to_mont(0x000000000000000059e26bcea0d48bacd4f263f1acdb5c4f5763473177ffffff_u256),
+};
+
+/// The Frobenius endomorphism π (raising to the power p).
+///
+/// For a = Σ aᵢ⋅wⁱ: π(a) = Σ āᵢ⋅γ₁,ᵢ⋅wⁱ.
+Fp12 frobenius(const Fp12& a) noexcept
+{
+    const auto& g = FROBENIUS_COEFFS_1;
+    return {
+        {conj(a.c0.c0), conj(a.c0.c1) * g[1], conj(a.c0.c2) * g[3]},
+        {conj(a.c1.c0) * g[0], conj(a.c1.c1) * g[2], conj(a.c1.c2) * g[4]},
+    };
+}
 
-    // Step 195: t11 = x^0x30644e72e131a029b85045b68181585d97816a00
-    for (int i = 0; i < 9; ++i)
-        t11 = m.mul(t11, t11);
+/// The Frobenius endomorphism π² (raising to the power p²).
+///
+/// For a = Σ aᵢ⋅wⁱ: π²(a) = Σ aᵢ⋅γ₂,ᵢ⋅wⁱ.
+Fp12 frobenius2(const Fp12& a) noexcept
+{
+    const auto& g = FROBENIUS_COEFFS_2;
+    return {
+        {a.c0.c0, a.c0.c1 * g[1], a.c0.c2 * g[3]},
+        {a.c1.c0 * g[0], a.c1.c1 * g[2], a.c1.c2 * g[4]},
+    };
+}
 
-    // Step 196: t10 = x^0x30644e72e131a029b85045b68181585d97816a91
-    t10 = m.mul(t10, t11);
+/// The coefficient of the twisted curve: b' = 3/ξ.
+constexpr auto TWIST_B =
+    to_mont(0x2b149d40ceb8aaae81be18991be06ac3b5b4c5e559dbefa33267e6dc24a138e5_u256,
+        0x009713b03af0fed4cd2cafadeed8fdf4a74fa084e52d1852e4a2bd0685c315d2_u256);
 
-    // Step 201: t10 = x^0x60c89ce5c263405370a08b6d0302b0bb2f02d5220
-    for (int i = 0; i < 5; ++i)
-        t10 = m.mul(t10, t10);
+/// The 3⋅b' used in the point doubling and addition formulas.
+constexpr auto TWIST_B3 = TWIST_B + TWIST_B + TWIST_B;
 
-    // Step 202: t9 = x^0x60c89ce5c263405370a08b6d0302b0bb2f02d522d
-    t9 = m.mul(t9, t10);
+/// The inverse of 2 in Fp.
+constexpr auto TWO_INV =
+    Fp.to_mont(0x183227397098d014dc2822db40c0ac2ecbc0b548b438e5469e10460b6c3e7ea4_u256);
 
-    // Step 214: t9 = x^0x60c89ce5c263405370a08b6d0302b0bb2f02d522d000
-    for (int i = 0; i < 12; ++i)
-        t9 = m.mul(t9, t9);
+/// The point on the twisted curve in the homogeneous projective coordinates (x = X/Z, y = Y/Z).
+struct ExtProjPoint
+{
+    Fp2 x;
+    Fp2 y;
+    Fp2 z;
+};
 
-    // Step 215: t8 = x^0x60c89ce5c263405370a08b6d0302b0bb2f02d522d0e3
-    t8 = m.mul(t8, t9);
+/// The line (of the Miller loop) evaluated at the G1 point: c0 + c1⋅w + c3⋅w³.
+struct Line
+{
+    Fp2 c0;
+    Fp2 c1;
+    Fp2 c3;
+};
 
-    // Step 223: t8 = x^0x60c89ce5c263405370a08b6d0302b0bb2f02d522d0e300
-    for (int i = 0; i < 8; ++i)
-        t8 = m.mul(t8, t8);
+/// Multiplies the Fp12 element by the sparse Fp12 element of the line.
+constexpr Fp12 mul_by_line(const Fp12& a, const Line& l) noexcept
+{
+    // The line is (l.c0 + 0⋅v + 0⋅v²) + (l.c1 + l.c3⋅v + 0⋅v²)⋅w.
+    const auto t0 = a.c0 * l.c0;
+    const auto t1 = mul_by_01(a.c1, l.c1, l.c3);
+    return {t0 + mul_by_v(t1), mul_by_01(a.c0 + a.c1, l.c0 + l.c1, l.c3) - t0 - t1};
+}
 
-    // Step 224: t7 = x^0x60c89ce5c263405370a08b6d0302b0bb2f02d522d0e395
-    t7 = m.mul(t7, t8);
+/// Doubles the point t and returns the tangent line at t evaluated at the G1 point (xp, yp).
+///
+/// The lines are untwisted with ψ(x, y) = (x⋅w², y⋅w³) and scaled by Fp2 factors
+/// which are eliminated by the final exponentiation.
+/// Costello, Lange, Naehrig "Faster Pairing Computations on Curves with High-Degree Twists",
+/// https://eprint.iacr.org/2009/615, Section 4 (the formulas for the homogeneous coordinates).
+Line dbl_step(ExtProjPoint& t, const uint256& xp, const uint256& yp) noexcept
+{
+    const auto a = (t.x * t.y) * TWO_INV;
+    const auto b = sqr(t.y);
+    const auto c = sqr(t.z);
+    const auto e = TWIST_B3 * c;
+    const auto f = e + e + e;
+    const auto g = (b + f) * TWO_INV;
+    const auto h = sqr(t.y + t.z) - (b + c);  // 2⋅Y⋅Z
+    const auto j = sqr(t.x);
+    const auto e2 = sqr(e);
+
+    t.x = a * (b - f);
+    t.y = sqr(g) - (e2 + e2 + e2);
+    t.z = b * h;
+
+    // The tangent: 3⋅X²⋅xp⋅w - 2⋅Y⋅Z⋅yp + (3⋅b'⋅Z² - Y²)⋅w³.
+    return {-h * yp, (j + j + j) * xp, e - b};
+}
 
-    // Step 235: t7 = x^0x30644e72e131a029b85045b68181585d97816a916871ca800
-    for (int i = 0; i < 11; ++i)
-        t7 = m.mul(t7, t7);
+/// Adds the affine point q to the point t and returns the line through t and q
+/// evaluated at the G1 point (xp, yp). See dbl_step().
+Line add_step(ExtProjPoint& t, const Fp2& qx, const Fp2& qy, const uint256& xp,
+    const uint256& yp) noexcept
+{
+    const auto d = t.x - qx * t.z;
+    const auto e = t.y - qy * t.z;
+    const auto f = sqr(d);
+    const auto g = sqr(e);
+    const auto h = d * f;
+    const auto i = t.x * f;
+    const auto j = h + t.z * g - (i + i);
+
+    t.x = d * j;
+    t.y = e * (i - j) - h * t.y;
+    t.z = t.z * h;
+
+    // The line: D⋅yp - E⋅xp⋅w + (E⋅qx - D⋅qy)⋅w³.
+    return {d * yp, -e * xp, e * qx - d * qy};
+}
 
-    // Step 236: t6 = x^0x30644e72e131a029b85045b68181585d97816a916871ca8d3
-    t6 = m.mul(t6, t7);
+/// The 6x+2 (the optimal ate pairing Miller loop length) in the non-adjacent form,
+/// from the most significant digit. The bn254 curve parameter x = 4965661367192848881.
+constexpr int8_t ATE_LOOP_COUNT_NAF[] = {1, 0, -1, 0, 1, 0, 0, 0, -1, 0, -1, 0, 0, 0, -1, 0, 1, 0,
+    -1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 0, -1, 0, 1, 0, 0, -1, 0, 0, 0, 0, -1, 0, 1, 0, 0, 0, -1,
+    0, -1, 0, 0, 1, 0, 0, 0, -1, 0, 0, -1, 0, 1, 0, 1, 0, 0, 0};
 
-    // Step 243: t6 = x^0x183227397098d014dc2822db40c0ac2ecbc0b548b438e546980
-    for (int i = 0; i < 7; ++i)
-        t6 = m.mul(t6, t6);
+/// The input of the Miller loop: the pair of the G1 and G2 points in the Montgomery form
+/// and the current Miller loop point (initially Q).
+struct MillerLoopPair
+{
+    uint256 xp;
+    uint256 yp;
+    Fp2 qx;
+    Fp2 qy;
+    ExtProjPoint t;
+};
+
+/// Computes the product of the Miller loops f_{6x+2,Q}(P) of all pairs
+/// including the two final lines with the Frobenius images of Q.
+/// The f² of the loop is shared by all pairs.
+Fp12 multi_miller_loop(std::span<MillerLoopPair> pairs) noexcept
+{
+    auto f = FP12_ONE;
+    for (size_t i = 1; i < std::size(ATE_LOOP_COUNT_NAF); ++i)
+    {
+        if (i != 1)
+            f = sqr(f);
+
+        for (auto& p : pairs)
+            f = mul_by_line(f, dbl_step(p.t, p.xp, p.yp));
+
+        if (const auto digit = ATE_LOOP_COUNT_NAF[i]; digit != 0)
+        {
+            for (auto& p : pairs)
+            {
+                const auto qy = digit > 0 ? p.qy : -p.qy;
+                f = mul_by_line(f, add_step(p.t, p.qx, qy, p.xp, p.yp));
+            }
+        }
+    }
+
+    for (auto& p : pairs)
+    {
+        // Q₁ = π(Q) = (q̄x⋅γ₁,₂, q̄y⋅γ₁,₃), -Q₂ = -π²(Q) = (qx⋅γ₂,₂, -qy⋅γ₂,₃) = (qx⋅γ₂,₂, qy).
+        const auto q1x = conj(p.qx) * FROBENIUS_COEFFS_1[1];
+        const auto q1y = conj(p.qy) * FROBENIUS_COEFFS_1[2];
+        f = mul_by_line(f, add_step(p.t, q1x, q1y, p.xp, p.yp));
+
+        const auto nq2x = p.qx * FROBENIUS_COEFFS_2[1];
+        f = mul_by_line(f, add_step(p.t, nq2x, p.qy, p.xp, p.yp));
+    }
+    return f;
+}
 
-    // Step 244: t5 = x^0x183227397098d014dc2822db40c0ac2ecbc0b548b438e5469e1
-    t5 = m.mul(t5, t6);
+/// Raises the element of the cyclotomic subgroup to the power of the curve parameter x.
+Fp12 cyclotomic_pow_x(const Fp12& a) noexcept
+{
+    static constexpr uint64_t X = 4965661367192848881;
+
+    auto r = a;
+    for (int i = 62 - std::countl_zero(X); i >= 0; --i)
+    {
+        r = cyclotomic_sqr(r);
+        if ((X >> i) & 1)
+            r = r * a;
+    }
+    return r;
+}
 
-    // Step 255: t5 = x^0xc19139cb84c680a6e14116da060561765e05aa45a1c72a34f0800
-    for (int i = 0; i < 11; ++i)
-        t5 = m.mul(t5, t5);
+/// Computes the final exponentiation f^((p¹²-1)/r).
+///
+/// The hard part (p⁴-p²+1)/r is computed with the addition chain from
+/// Scott, Benger, Charlemagne, Perez, Kachisa "On the final exponentiation for calculating
+/// pairings on ordinary elliptic curves", https://eprint.iacr.org/2008/490.
+Fp12 final_exp(const Fp12& f) noexcept
+{
+    // The easy part: f^((p⁶-1)(p²+1)).
+    auto t = conj(f) * inv(f);
+    t = frobenius2(t) * t;
+
+    // The hard part.
+    const auto fp = frobenius(t);
+    const auto fp2 = frobenius2(t);
+    const auto fp3 = frobenius(fp2);
+    const auto fu = cyclotomic_pow_x(t);
+    const auto fu2 = cyclotomic_pow_x(fu);
+    const auto fu3 = cyclotomic_pow_x(fu2);
+    const auto fu2p = frobenius(fu2);
+    const auto fu3p = frobenius(fu3);
+
+    const auto y0 = fp * fp2 * fp3;
+    const auto y1 = conj(t);
+    const auto y2 = frobenius2(fu2);
+    const auto y3 = conj(frobenius(fu));
+    const auto y4 = conj(fu * fu2p);
+    const auto y5 = conj(fu2);
+    const auto y6 = conj(fu3 * fu3p);
+
+    auto t0 = cyclotomic_sqr(y6) * y4 * y5;
+    auto t1 = y3 * y5 * t0;
+    t0 = t0 * y2;
+    t1 = cyclotomic_sqr(t1) * t0;
+    t1 = cyclotomic_sqr(t1);
+    t0 = t1 * y1;
+    t1 = t1 * y0;
+    t0 = cyclotomic_sqr(t0);
+    return t0 * t1;
+}
 
-    // Step 256: t4 = x^0xc19139cb84c680a6e14116da060561765e05aa45a1c72a34f0823
-    t4 = m.mul(t4, t5);
+/// Adds the points on the twisted curve. See ecc::add().
+ExtProjPoint add(const ExtProjPoint& p, const ExtProjPoint& q) noexcept
+{
+    // Renes, Costello, Batina "Complete addition formulas for prime order elliptic curves",
+    // https://eprint.iacr.org/2015/1060, Algorithm 7.
+    auto t0 = p.x * q.x;
+    auto t1 = p.y * q.y;
+    auto t2 = p.z * q.z;
+    auto t3 = (p.x + p.y) * (q.x + q.y) - (t0 + t1);
+    auto t4 = (p.y + p.z) * (q.y + q.z) - (t1 + t2);
+    auto y3 = (p.x + p.z) * (q.x + q.z) - (t0 + t2);
+    t0 = t0 + t0 + t0;
+    t2 = TWIST_B3 * t2;
+    auto z3 = t1 + t2;
+    t1 = t1 - t2;
+    y3 = TWIST_B3 * y3;
+    auto x3 = t3 * t1 - t4 * y3;
+    y3 = t1 * z3 + y3 * t0;
+    z3 = z3 * t4 + t0 * t3;
+    return {x3, y3, z3};
+}
 
-    // Step 268: t4 = x^0xc19139cb84c680a6e14116da060561765e05aa45a1c72a34f0823000
-    for (int i = 0; i < 12; ++i)
-        t4 = m.mul(t4, t4);
+/// Doubles the point on the twisted curve. See ecc::dbl().
+ExtProjPoint dbl(const ExtProjPoint& p) noexcept
+{
+    // Renes, Costello, Batina "Complete addition formulas for prime order elliptic curves",
+    // https://eprint.iacr.org/2015/1060, Algorithm 9.
+    const auto t0 = sqr(p.y);
+    auto z3 = t0 + t0;
+    z3 = z3 + z3;
+    z3 = z3 + z3;
+    auto t1 = p.y * p.z;
+    auto t2 = TWIST_B3 * sqr(p.z);
+    auto x3 = t2 * z3;
+    auto y3 = t0 + t2;
+    z3 = t1 * z3;
+    t2 = t2 + t2 + t2;
+    const auto t3 = t0 - t2;
+    y3 = t3 * y3 + x3;
+    t1 = p.x * p.y;
+    x3 = t3 * t1;
+    x3 = x3 + x3;
+    return {x3, y3, z3};
+}
 
-    // Step 269: t3 = x^0xc19139cb84c680a6e14116da060561765e05aa45a1c72a34f082305b
-    t3 = m.mul(t3, t4);
+/// Checks if the point on the twisted curve is in the G2 group (the subgroup of order r).
+///
+/// Uses the criterion ψ(Q) == [6x²]Q for BN curves where ψ is the untwist-Frobenius-twist
+/// endomorphism. Scott "A note on group membership tests for G1, G2 and GT on BLS
+/// pairing-friendly curves", https://eprint.iacr.org/2021/1130, Section 4.
+bool is_in_g2(const Fp2& qx, const Fp2& qy) noexcept
+{
+    static constexpr auto SIX_X_SQUARED = 0x6f4d8248eeb859fbf83e9682e87cfd46_u256;
+
+    const Fp2 one{Fp.to_mont(1), 0};
+    const ExtProjPoint q{qx, qy, one};
+
+    ExtProjPoint r{{}, one, {}};
+    for (int i = 255 - static_cast<int>(clz(SIX_X_SQUARED)); i >= 0; --i)
+    {
+        r = dbl(r);
+        if (((SIX_X_SQUARED >> i) & 1) != 0)
+            r = add(r, q);
+    }
+
+    // ψ(Q) = (q̄x⋅γ₁,₂, q̄y⋅γ₁,₃). Compare with r in projective coordinates.
+    const auto psi_x = conj(qx) * FROBENIUS_COEFFS_1[1];
+    const auto psi_y = conj(qy) * FROBENIUS_COEFFS_1[2];
+    return psi_x * r.z == r.x && psi_y * r.z == r.y;
+}
+}  // namespace
 
-    // Step 278: t3 = x^0x183227397098d014dc2822db40c0ac2ecbc0b548b438e5469e10460b600
-    for (int i = 0; i < 9; ++i)
-        t3 = m.mul(t3, t3);
+std::optional<bool> pairing_check(std::span<const std::pair<Point, ExtPoint>> pairs) noexcept
+{
+    const auto is_field_element = [](const uint256& x) noexcept { return x < FieldPrime; };
 
-    // Step 279: t2 = x^0x183227397098d014dc2822db40c0ac2ecbc0b548b438e5469e10460b6c3
-    t2 = m.mul(t2, t3);
+    std::vector<MillerLoopPair> loop_pairs;
+    loop_pairs.reserve(pairs.size());
+    for (const auto& [p, q] : pairs)
+    {
+        if (!is_field_element(p.x) || !is_field_element(p.y) || !is_field_element(q.x.first) ||
+            !is_field_element(q.x.second) || !is_field_element(q.y.first) ||
+            !is_field_element(q.y.second))
+            return std::nullopt;
 
-    // Step 287: t2 = x^0x183227397098d014dc2822db40c0ac2ecbc0b548b438e5469e10460b6c300
-    for (int i = 0; i < 8; ++i)
-        t2 = m.mul(t2, t2);
+        if (!validate(p))
+            return std::nullopt;
 
-    // Step 288: t1 = x^0x183227397098d014dc2822db40c0ac2ecbc0b548b438e5469e10460b6c3e7
-    t1 = m.mul(t1, t2);
+        if (q.is_inf())
+            continue;
 
-    // Step 295: t1 = x^0xc19139cb84c680a6e14116da060561765e05aa45a1c72a34f082305b61f380
-    for (int i = 0; i < 7; ++i)
-        t1 = m.mul(t1, t1);
+        const auto qx = to_mont(q.x.first, q.x.second);
+        const auto qy = to_mont(q.y.first, q.y.second);
+        if (sqr(qy) != sqr(qx) * qx + TWIST_B || !is_in_g2(qx, qy))
+            return std::nullopt;
 
-    // Step 296: t0 = x^0xc19139cb84c680a6e14116da060561765e05aa45a1c72a34f082305b61f3f5
-    t0 = m.mul(t0, t1);
+        if (p.is_inf())
+            continue;
 
-    // Step 302: t0 = x^0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd40
-    for (int i = 0; i < 6; ++i)
-        t0 = m.mul(t0, t0);
+        const Fp2 one{Fp.to_mont(1), 0};
+        loop_pairs.push_back({Fp.to_mont(p.x), Fp.to_mont(p.y), qx, qy, {qx, qy, one}});
+    }
 
-    // Step 303: z = x^0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd45
-    z = m.mul(z, t0);
+    if (loop_pairs.empty())
+        return true;
 
-    return z;
+    return final_exp(multi_miller_loop(loop_pairs)) == FP12_ONE;
 }
-
 }  // namespace evmmax::bn254
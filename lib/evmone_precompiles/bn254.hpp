@@ -4,6 +4,9 @@
 #pragma once
 
 #include "ecc.hpp"
+#include <optional>
+#include <span>
+#include <utility>
 
 namespace evmmax::bn254
 {
@@ -15,6 +18,26 @@ inline constexpr auto FieldPrime =
 
 using Point = ecc::Point<uint256>;
 
+/// The modular arithmetic of the bn254 prime field.
+///
+/// The FieldPrime is "sparse" (254 bits) so the specialized Montgomery arithmetic is used.
+using FieldArith = ModArith<uint256, SparseModulus>;
+
+/// The point of the G2 group: the point on the twisted curve y^2 = x^3 + 3/(9+u)
+/// over the Fp2 = Fp[u]/(u^2+1) field extension in affine coordinates.
+///
+/// The coordinates are the Fp2 elements c0 + c1⋅u represented as pairs {c0, c1}.
+struct ExtPoint
+{
+    std::pair<uint256, uint256> x;
+    std::pair<uint256, uint256> y;
+
+    friend constexpr bool operator==(const ExtPoint& a, const ExtPoint& b) noexcept = default;
+
+    /// Checks if the point represents the special "infinity" value.
+    [[nodiscard]] constexpr bool is_inf() const noexcept { return *this == ExtPoint{}; }
+};
+
 /// Validates that point is from the bn254 curve group
 ///
 /// Returns true if y^2 == x^3 + 3. Input is converted to the Montgomery form.
@@ -22,9 +45,9 @@ bool validate(const Point& pt) noexcept;
 
 /// Modular inversion for bn254 prime field.
 ///
-/// Computes 1/x mod P modular inversion by computing modular exponentiation x^(P-2),
-/// where P is ::FieldPrime.
-uint256 field_inv(const ModArith<uint256>& m, const uint256& x) noexcept;
+/// Computes 1/x mod P modular inversion using the constant-time safegcd algorithm
+/// (see evmmax::safegcd::inv()), where P is ::FieldPrime. The x is in Montgomery form.
+uint256 field_inv(const FieldArith& m, const uint256& x) noexcept;
 
 /// Addition in bn254 curve group.
 ///
@@ -36,4 +59,14 @@ Point add(const Point& pt1, const Point& pt2) noexcept;
 /// Computes [c]P for a point in affine coordinate on the bn254 curve,
 Point mul(const Point& pt, const uint256& c) noexcept;
 
+/// Pairing check in bn254 curve groups.
+///
+/// Checks if e(P₁, Q₁)⋅e(P₂, Q₂)⋅…⋅e(Pₙ, Qₙ) == 1 for the optimal ate pairing e
+/// (the ECPAIRING precompile, EIP-197). The Miller loops of all pairs are computed together
+/// and share a single final exponentiation. The pairs containing infinity are skipped.
+///
+/// Returns std::nullopt if any coordinate is not a field element, any P is not on the curve
+/// or any Q is not in the G2 group.
+std::optional<bool> pairing_check(std::span<const std::pair<Point, ExtPoint>> pairs) noexcept;
+
 }  // namespace evmmax::bn254
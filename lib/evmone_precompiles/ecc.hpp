@@ -4,6 +4,12 @@
 #pragma once
 
 #include <evmmax/evmmax.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 namespace evmmax::ecc
 {
@@ -36,22 +42,52 @@ struct ProjPoint
 
 static_assert(ProjPoint<unsigned>{}.is_inf());
 
-template <typename IntT>
-using InvFn = IntT (*)(const ModArith<IntT>&, const IntT& x) noexcept;
+template <typename IntT, typename KindT>
+using InvFn = IntT (*)(const ModArith<IntT, KindT>&, const IntT& x) noexcept;
 
 /// Converts an affine point to a projected point with coordinates in Montgomery form.
-template <typename IntT>
-inline ProjPoint<IntT> to_proj(const ModArith<IntT>& s, const Point<IntT>& p) noexcept
+template <typename IntT, typename KindT>
+constexpr ProjPoint<IntT> to_proj(const ModArith<IntT, KindT>& s, const Point<IntT>& p) noexcept
 {
     // FIXME: Add to_mont(1) to ModArith?
     // FIXME: Handle inf
     return {s.to_mont(p.x), s.to_mont(p.y), s.to_mont(1)};
 }
 
+/// Inverts the field elements in Montgomery form with a single inversion (Montgomery's trick).
+///
+/// The zero elements are left unchanged.
+template <typename IntT, typename KindT>
+void batch_inv(const ModArith<IntT, KindT>& s, InvFn<IntT, KindT> inv, std::span<IntT> xs) noexcept
+{
+    const auto one = s.to_mont(1);
+
+    // The prefix products of the non-zero elements.
+    std::vector<IntT> products(xs.size());
+    auto acc = one;
+    for (size_t i = 0; i < xs.size(); ++i)
+    {
+        if (xs[i] != 0)
+            acc = s.mul(acc, xs[i]);
+        products[i] = acc;
+    }
+
+    // Skip the inversion of one, e.g. when there are no non-zero elements.
+    auto acc_inv = (acc == one) ? one : inv(s, acc);
+    for (size_t i = xs.size(); i-- != 0;)
+    {
+        if (xs[i] == 0)
+            continue;
+        const auto x_inv = s.mul(acc_inv, i != 0 ? products[i - 1] : one);
+        acc_inv = s.mul(acc_inv, xs[i]);
+        xs[i] = x_inv;
+    }
+}
+
 /// Converts a projected point to an affine point.
-template <typename IntT>
+template <typename IntT, typename KindT>
 inline Point<IntT> to_affine(
-    const ModArith<IntT>& s, InvFn<IntT> inv, const ProjPoint<IntT>& p) noexcept
+    const ModArith<IntT, KindT>& s, InvFn<IntT, KindT> inv, const ProjPoint<IntT>& p) noexcept
 {
     // FIXME: Split to_affine() and to/from_mont(). This is not good idea.
     // FIXME: Add tests for inf.
@@ -59,8 +95,15 @@ inline Point<IntT> to_affine(
     return {s.from_mont(s.mul(p.x, z_inv)), s.from_mont(s.mul(p.y, z_inv))};
 }
 
-template <typename IntT, int A = 0>
-ProjPoint<IntT> add(const evmmax::ModArith<IntT>& s, const ProjPoint<IntT>& p,
+/// Negates the projected point: -(x, y, z) = (x, -y, z).
+template <typename IntT, typename KindT>
+constexpr ProjPoint<IntT> neg(const ModArith<IntT, KindT>& s, const ProjPoint<IntT>& p) noexcept
+{
+    return {p.x, s.sub(0, p.y), p.z};
+}
+
+template <typename IntT, typename KindT, int A = 0>
+constexpr ProjPoint<IntT> add(const evmmax::ModArith<IntT, KindT>& s, const ProjPoint<IntT>& p,
     const ProjPoint<IntT>& q, const IntT& b3) noexcept
 {
     static_assert(A == 0, "point addition procedure is simplified for a = 0");
@@ -124,9 +167,9 @@ ProjPoint<IntT> add(const evmmax::ModArith<IntT>& s, const ProjPoint<IntT>& p,
 }
 
 
-template <typename IntT, int A = 0>
-ProjPoint<IntT> dbl(
-    const evmmax::ModArith<IntT>& s, const ProjPoint<IntT>& p, const IntT& b3) noexcept
+template <typename IntT, typename KindT, int A = 0>
+constexpr ProjPoint<IntT> dbl(
+    const evmmax::ModArith<IntT, KindT>& s, const ProjPoint<IntT>& p, const IntT& b3) noexcept
 {
     static_assert(A == 0, "point doubling procedure is simplified for a = 0");
 
@@ -146,12 +189,12 @@ ProjPoint<IntT> dbl(
     IntT t1;
     IntT t2;
 
-    t0 = s.mul(y, y);    // 1
+    t0 = s.sqr(y);       // 1
     z3 = s.add(t0, t0);  // 2
     z3 = s.add(z3, z3);  // 3
     z3 = s.add(z3, z3);  // 4
     t1 = s.mul(y, z);    // 5
-    t2 = s.mul(z, z);    // 6
+    t2 = s.sqr(z);       // 6
     t2 = s.mul(b3, t2);  // 7
     x3 = s.mul(t2, z3);  // 8
     y3 = s.add(t0, t2);  // 9
@@ -168,35 +211,255 @@ ProjPoint<IntT> dbl(
     return {x3, y3, z3};
 }
 
-template <typename IntT, int A = 0>
-ProjPoint<IntT> mul(const evmmax::ModArith<IntT>& s, const ProjPoint<IntT>& z, const IntT& c,
-    const IntT& b3) noexcept
+/// The table of the odd multiples [1]P, [3]P, ..., [2N-1]P of a point P
+/// used by the wNAF scalar multiplication with the window of log₂(N) + 2 bits.
+template <typename IntT, size_t N>
+using OddMultiples = std::array<ProjPoint<IntT>, N>;
+
+/// Computes the OddMultiples table for the point P.
+template <size_t N, typename IntT, typename KindT>
+constexpr OddMultiples<IntT, N> odd_multiples(
+    const ModArith<IntT, KindT>& s, const ProjPoint<IntT>& p, const IntT& b3) noexcept
+{
+    OddMultiples<IntT, N> table;
+    table[0] = p;
+    const auto p2 = ecc::dbl(s, p, b3);
+    for (size_t i = 1; i < N; ++i)
+        table[i] = ecc::add(s, table[i - 1], p2, b3);
+    return table;
+}
+
+/// The width-W Non-Adjacent Form (wNAF) of a scalar c.
+///
+/// Each digit is either 0 or odd in the range (-2^(W-1), 2^(W-1)) and any W consecutive digits
+/// contain at most one non-zero digit. The digits are in the little-endian order and there is
+/// one digit more than the scalar bits, so c = ∑ digits[i]⋅2^i for any scalar value.
+template <unsigned W, typename IntT>
+constexpr std::array<int8_t, IntT::num_bits + 1> wnaf(const IntT& c) noexcept
 {
-    ProjPoint<IntT> p;
-    auto q = z;
-    auto first_significant_met = false;
+    static_assert(W >= 2 && W <= 8);
+    constexpr auto num_bits = IntT::num_bits;
 
-    for (int i = 255; i >= 0; --i)
+    std::array<int8_t, num_bits + 1> digits{};
+    unsigned carry = 0;
+    for (unsigned i = 0; i < num_bits;)
     {
-        const auto d = c & (IntT{1} << i);
-        if (d == 0)
+        // Skip the bit if, including the carry, it is zero.
+        if ((static_cast<unsigned>(c >> i) & 1) == carry)
         {
-            if (first_significant_met)
-            {
-                q = ecc::add(s, p, q, b3);
-                p = ecc::dbl(s, p, b3);
-            }
+            ++i;
+            continue;
         }
-        else
+
+        // Take the window of W bits (or fewer at the end), make the digit odd and signed
+        // by borrowing 2^W from the next window if the digit is too big.
+        const auto w = std::min(W, num_bits - i);
+        const auto word = (static_cast<unsigned>(c >> i) & ((1u << w) - 1)) + carry;
+        carry = (word >> (W - 1)) & 1;
+        digits[i] = static_cast<int8_t>(static_cast<int>(word) - static_cast<int>(carry << W));
+        i += w;
+    }
+    digits[num_bits] = static_cast<int8_t>(carry);
+    return digits;
+}
+
+/// Selects the wNAF digit's point [d]P from the OddMultiples table of P.
+template <typename IntT, typename KindT>
+constexpr ProjPoint<IntT> select(
+    const ModArith<IntT, KindT>& s, std::span<const ProjPoint<IntT>> table, int d) noexcept
+{
+    return d > 0 ? table[static_cast<size_t>(d / 2)] : neg(s, table[static_cast<size_t>(-d / 2)]);
+}
+
+/// The wNAF window size matching the OddMultiples table size N.
+template <size_t N>
+inline constexpr unsigned wnaf_window = static_cast<unsigned>(std::bit_width(N)) + 1;
+
+/// The term [c]P of a multi-scalar multiplication: the wNAF digits of c
+/// and the OddMultiples table of P.
+template <typename IntT>
+struct WnafTerm
+{
+    std::array<int8_t, IntT::num_bits + 1> digits;
+    std::span<const ProjPoint<IntT>> table;
+};
+
+/// Computes the sum of the terms ∑[cᵢ]Pᵢ with the Shamir/Straus interleaved wNAF method.
+///
+/// The doublings are shared by all the terms so the cost is dominated by
+/// the length of the longest scalar.
+template <typename IntT, typename KindT, size_t K, int A = 0>
+constexpr ProjPoint<IntT> msm(const ModArith<IntT, KindT>& s,
+    const std::array<WnafTerm<IntT>, K>& terms, const IntT& b3) noexcept
+{
+    const auto is_zero_at = [&terms](size_t i) noexcept {
+        return std::ranges::all_of(terms, [i](const auto& t) noexcept { return t.digits[i] == 0; });
+    };
+
+    ProjPoint<IntT> r;
+    auto i = IntT::num_bits + 1;
+    while (i != 0 && is_zero_at(i - 1))
+        --i;
+    while (i != 0)
+    {
+        --i;
+        r = ecc::dbl(s, r, b3);
+        for (const auto& t : terms)
         {
-            p = ecc::add(s, p, q, b3);
-            q = ecc::dbl(s, q, b3);
-            first_significant_met = true;
+            if (const int d = t.digits[i]; d != 0)
+                r = ecc::add(s, r, select<IntT>(s, t.table, d), b3);
         }
     }
+    return r;
+}
+
+/// Computes [c]P with the wNAF method, where the point P is given by its OddMultiples table.
+///
+/// This is the fixed-base multiplication when the table is precomputed
+/// (e.g. at compile time for the curve generator).
+template <typename IntT, typename KindT, size_t N, int A = 0>
+constexpr ProjPoint<IntT> mul(const ModArith<IntT, KindT>& s, const OddMultiples<IntT, N>& table,
+    const IntT& c, const IntT& b3) noexcept
+{
+    static_assert(std::has_single_bit(N));
+    return msm(s, std::array{WnafTerm<IntT>{wnaf<wnaf_window<N>>(c), table}}, b3);
+}
+
+/// Computes [c]P with the wNAF method (window of 5 bits).
+template <typename IntT, typename KindT, int A = 0>
+ProjPoint<IntT> mul(const evmmax::ModArith<IntT, KindT>& s, const ProjPoint<IntT>& p, const IntT& c,
+    const IntT& b3) noexcept
+{
+    return ecc::mul(s, odd_multiples<8>(s, p, b3), c, b3);
+}
+
+/// The GLV endomorphism parameters of a curve y² = x³ + b of the prime order n.
+///
+/// The endomorphism φ(x, y) = (β⋅x, y) = [λ](x, y) allows to split a scalar k into halves
+/// k ≡ k₁ + k₂⋅λ (mod n) using the short basis (a₁, b₁), (a₂, b₂) of the lattice
+/// {(a, b): a + b⋅λ ≡ 0 (mod n)}, where b₁ < 0 < b₂ and a₁⋅b₂ - a₂⋅b₁ = n.
+/// See "Guide to Elliptic Curve Cryptography", Algorithm 3.74.
+template <typename IntT>
+struct GLV
+{
+    IntT beta;  ///< The cube root of unity β in Montgomery form.
+
+    /// The lattice basis coordinates (in two's complement).
+    IntT a1;
+    IntT b1;
+    IntT a2;
+    IntT b2;
+
+    /// The rounding constants g₁ = round(2^shift⋅b₂/n), g₂ = round(-2^shift⋅b₁/n).
+    IntT g1;
+    IntT g2;
+    unsigned shift;
+};
+
+/// The scalar in the sign and magnitude representation.
+template <typename IntT>
+struct SignedScalar
+{
+    IntT abs;
+    bool neg = false;
+};
+
+/// Splits the scalar k into the halves k₁ and k₂ such that k ≡ k₁ + k₂⋅λ (mod n).
+template <typename IntT>
+constexpr std::array<SignedScalar<IntT>, 2> split(const GLV<IntT>& glv, const IntT& k) noexcept
+{
+    // cᵢ = round(k⋅gᵢ / 2^shift) approximates b₂⋅k/n and -b₁⋅k/n respectively.
+    const auto round_mul = [&](const IntT& g) noexcept {
+        const auto r = static_cast<IntT>(umul(k, g) >> (glv.shift - 1));
+        return (r >> 1) + (r & 1);
+    };
+    const auto c1 = round_mul(glv.g1);
+    const auto c2 = round_mul(glv.g2);
+
+    // The results are small signed numbers so the computation in two's complement is exact.
+    const auto to_signed = [](const IntT& x) noexcept {
+        const auto neg = (x >> (IntT::num_bits - 1)) != 0;
+        return SignedScalar<IntT>{neg ? -x : x, neg};
+    };
+    return {to_signed(k - c1 * glv.a1 - c2 * glv.a2), to_signed(-(c1 * glv.b1) - c2 * glv.b2)};
+}
+
+/// Computes the wNAF of the signed scalar.
+template <unsigned W, typename IntT>
+constexpr std::array<int8_t, IntT::num_bits + 1> wnaf(const SignedScalar<IntT>& c) noexcept
+{
+    auto digits = wnaf<W>(c.abs);
+    if (c.neg)
+    {
+        for (auto& d : digits)
+            d = static_cast<int8_t>(-d);
+    }
+    return digits;
+}
 
-    return p;
+/// Maps the OddMultiples table of P to the table of φ(P) = (β⋅x, y).
+template <typename IntT, typename KindT, size_t N>
+constexpr OddMultiples<IntT, N> endo(const ModArith<IntT, KindT>& s, const GLV<IntT>& glv,
+    const OddMultiples<IntT, N>& table) noexcept
+{
+    OddMultiples<IntT, N> r;
+    for (size_t i = 0; i < N; ++i)
+        r[i] = {s.mul(table[i].x, glv.beta), table[i].y, table[i].z};
+    return r;
 }
 
+/// Computes [c]P = [c₁]P + [c₂]φ(P) using the GLV endomorphism,
+/// where the point P is given by its OddMultiples table.
+///
+/// The point must be in the group of the order n.
+template <typename IntT, typename KindT, size_t N, int A = 0>
+ProjPoint<IntT> mul(const ModArith<IntT, KindT>& s, const OddMultiples<IntT, N>& table,
+    const IntT& c, const IntT& b3, const GLV<IntT>& glv) noexcept
+{
+    static_assert(std::has_single_bit(N));
+    constexpr auto W = wnaf_window<N>;
+    const auto [c1, c2] = split(glv, c);
+    const auto endo_table = endo(s, glv, table);
+    return msm(s,
+        std::array{WnafTerm<IntT>{wnaf<W>(c1), table}, WnafTerm<IntT>{wnaf<W>(c2), endo_table}},
+        b3);
+}
+
+/// Computes [c]P using the GLV endomorphism (window of 5 bits).
+///
+/// The point must be in the group of the order n.
+template <typename IntT, typename KindT, int A = 0>
+ProjPoint<IntT> mul(const ModArith<IntT, KindT>& s, const ProjPoint<IntT>& p, const IntT& c,
+    const IntT& b3, const GLV<IntT>& glv) noexcept
+{
+    return ecc::mul(s, odd_multiples<8>(s, p, b3), c, b3, glv);
+}
+
+/// Computes [u]G + [v]Q using the GLV endomorphism for both multiplications
+/// and the Shamir/Straus method for the resulting four half-size terms.
+///
+/// The point G is given by its (usually precomputed) OddMultiples table so it may use a wider
+/// window than Q. The points must be in the group of the order n.
+template <typename IntT, typename KindT, size_t N, int A = 0>
+ProjPoint<IntT> mul_add(const ModArith<IntT, KindT>& s, const OddMultiples<IntT, N>& g_table,
+    const IntT& u, const ProjPoint<IntT>& q, const IntT& v, const IntT& b3,
+    const GLV<IntT>& glv) noexcept
+{
+    static_assert(std::has_single_bit(N));
+    constexpr auto W = wnaf_window<N>;
+    const auto [u1, u2] = split(glv, u);
+    const auto [v1, v2] = split(glv, v);
+    const auto g_endo_table = endo(s, glv, g_table);
+    const auto q_table = odd_multiples<8>(s, q, b3);
+    const auto q_endo_table = endo(s, glv, q_table);
+    return msm(s,
+        std::array{
+            WnafTerm<IntT>{wnaf<W>(u1), g_table},
+            WnafTerm<IntT>{wnaf<W>(u2), g_endo_table},
+            WnafTerm<IntT>{wnaf<5>(v1), q_table},
+            WnafTerm<IntT>{wnaf<5>(v2), q_endo_table},
+        },
+        b3);
+}
 
 }  // namespace evmmax::ecc
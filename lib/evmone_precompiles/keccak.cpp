@@ -0,0 +1,415 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+/// @file
+/// Keccak-256 implementation with the multi-buffer (SIMD) variant.
+/// The permutation follows the "lane complementing"-free compact schedule
+/// from the Keccak Code Package (https://github.com/XKCP/XKCP).
+
+#include "keccak.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace evmone::crypto
+{
+namespace
+{
+/// The Keccak-256 rate (block size) in bytes.
+constexpr size_t RATE = 136;
+
+/// The number of the 64-bit words in a block.
+constexpr size_t RATE_WORDS = RATE / 8;
+
+constexpr uint64_t ROUND_CONSTANTS[24] = {
+    0x0000000000000001,
+    0x0000000000008082,
+    0x800000000000808a,
+    0x8000000080008000,
+    0x000000000000808b,
+    0x0000000080000001,
+    0x8000000080008081,
+    0x8000000000008009,
+    0x000000000000008a,
+    0x0000000000000088,
+    0x0000000080008009,
+    0x000000008000000a,
+    0x000000008000808b,
+    0x800000000000008b,
+    0x8000000000008089,
+    0x8000000000008003,
+    0x8000000000008002,
+    0x8000000000000080,
+    0x000000000000800a,
+    0x800000008000000a,
+    0x8000000080008081,
+    0x8000000000008080,
+    0x0000000080000001,
+    0x8000000080008008,
+};
+
+inline uint64_t load_le64(const std::byte* p) noexcept
+{
+    uint64_t w = 0;
+    if constexpr (std::endian::native == std::endian::little)
+        std::memcpy(&w, p, sizeof(w));
+    else
+    {
+        for (size_t i = 0; i < sizeof(w); ++i)
+            w |= uint64_t{static_cast<uint8_t>(p[i])} << (i * 8);
+    }
+    return w;
+}
+
+inline void store_le64(std::byte* p, uint64_t w) noexcept
+{
+    if constexpr (std::endian::native == std::endian::little)
+        std::memcpy(p, &w, sizeof(w));
+    else
+    {
+        for (size_t i = 0; i < sizeof(w); ++i)
+            p[i] = static_cast<std::byte>(w >> (i * 8));
+    }
+}
+
+#if defined(__GNUC__)
+// The vector lane types are only passed between always-inline functions
+// so the ABI change for vector arguments is not relevant.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/// Rotates left the 64-bit lanes. The L is uint64_t or a vector of uint64_t.
+template <typename L>
+[[gnu::always_inline]] inline L rol(L x, unsigned n) noexcept
+{
+    return (x << n) | (x >> (64 - n));
+}
+
+/// The Keccak-f[1600] permutation.
+///
+/// The L is the lane type: uint64_t for a single state or a vector of uint64_t
+/// (GCC/Clang vector extension) for multiple states permuted at once. The function is always
+/// inlined so the vector operations are compiled for the target of the caller.
+template <typename L>
+[[gnu::always_inline]] inline void keccakf1600(L st[25]) noexcept
+{
+    L Aba = st[0], Abe = st[1], Abi = st[2], Abo = st[3], Abu = st[4];
+    L Aga = st[5], Age = st[6], Agi = st[7], Ago = st[8], Agu = st[9];
+    L Aka = st[10], Ake = st[11], Aki = st[12], Ako = st[13], Aku = st[14];
+    L Ama = st[15], Ame = st[16], Ami = st[17], Amo = st[18], Amu = st[19];
+    L Asa = st[20], Ase = st[21], Asi = st[22], Aso = st[23], Asu = st[24];
+
+    for (const auto rc : ROUND_CONSTANTS)
+    {
+        // θ step.
+        const L Ca = Aba ^ Aga ^ Aka ^ Ama ^ Asa;
+        const L Ce = Abe ^ Age ^ Ake ^ Ame ^ Ase;
+        const L Ci = Abi ^ Agi ^ Aki ^ Ami ^ Asi;
+        const L Co = Abo ^ Ago ^ Ako ^ Amo ^ Aso;
+        const L Cu = Abu ^ Agu ^ Aku ^ Amu ^ Asu;
+        const L Da = Cu ^ rol(Ce, 1);
+        const L De = Ca ^ rol(Ci, 1);
+        const L Di = Ce ^ rol(Co, 1);
+        const L Do = Ci ^ rol(Cu, 1);
+        const L Du = Co ^ rol(Ca, 1);
+
+        // ρ and π steps.
+        const L Bba = Aba ^ Da;
+        const L Bbe = rol(Age ^ De, 44);
+        const L Bbi = rol(Aki ^ Di, 43);
+        const L Bbo = rol(Amo ^ Do, 21);
+        const L Bbu = rol(Asu ^ Du, 14);
+        const L Bga = rol(Abo ^ Do, 28);
+        const L Bge = rol(Agu ^ Du, 20);
+        const L Bgi = rol(Aka ^ Da, 3);
+        const L Bgo = rol(Ame ^ De, 45);
+        const L Bgu = rol(Asi ^ Di, 61);
+        const L Bka = rol(Abe ^ De, 1);
+        const L Bke = rol(Agi ^ Di, 6);
+        const L Bki = rol(Ako ^ Do, 25);
+        const L Bko = rol(Amu ^ Du, 8);
+        const L Bku = rol(Asa ^ Da, 18);
+        const L Bma = rol(Abu ^ Du, 27);
+        const L Bme = rol(Aga ^ Da, 36);
+        const L Bmi = rol(Ake ^ De, 10);
+        const L Bmo = rol(Ami ^ Di, 15);
+        const L Bmu = rol(Aso ^ Do, 56);
+        const L Bsa = rol(Abi ^ Di, 62);
+        const L Bse = rol(Ago ^ Do, 55);
+        const L Bsi = rol(Aku ^ Du, 39);
+        const L Bso = rol(Ama ^ Da, 41);
+        const L Bsu = rol(Ase ^ De, 2);
+
+        // χ and ι steps.
+        Aba = Bba ^ (~Bbe & Bbi) ^ rc;
+        Abe = Bbe ^ (~Bbi & Bbo);
+        Abi = Bbi ^ (~Bbo & Bbu);
+        Abo = Bbo ^ (~Bbu & Bba);
+        Abu = Bbu ^ (~Bba & Bbe);
+        Aga = Bga ^ (~Bge & Bgi);
+        Age = Bge ^ (~Bgi & Bgo);
+        Agi = Bgi ^ (~Bgo & Bgu);
+        Ago = Bgo ^ (~Bgu & Bga);
+        Agu = Bgu ^ (~Bga & Bge);
+        Aka = Bka ^ (~Bke & Bki);
+        Ake = Bke ^ (~Bki & Bko);
+        Aki = Bki ^ (~Bko & Bku);
+        Ako = Bko ^ (~Bku & Bka);
+        Aku = Bku ^ (~Bka & Bke);
+        Ama = Bma ^ (~Bme & Bmi);
+        Ame = Bme ^ (~Bmi & Bmo);
+        Ami = Bmi ^ (~Bmo & Bmu);
+        Amo = Bmo ^ (~Bmu & Bma);
+        Amu = Bmu ^ (~Bma & Bme);
+        Asa = Bsa ^ (~Bse & Bsi);
+        Ase = Bse ^ (~Bsi & Bso);
+        Asi = Bsi ^ (~Bso & Bsu);
+        Aso = Bso ^ (~Bsu & Bsa);
+        Asu = Bsu ^ (~Bsa & Bse);
+    }
+
+    st[0] = Aba, st[1] = Abe, st[2] = Abi, st[3] = Abo, st[4] = Abu;
+    st[5] = Aga, st[6] = Age, st[7] = Agi, st[8] = Ago, st[9] = Agu;
+    st[10] = Aka, st[11] = Ake, st[12] = Aki, st[13] = Ako, st[14] = Aku;
+    st[15] = Ama, st[16] = Ame, st[17] = Ami, st[18] = Amo, st[19] = Amu;
+    st[20] = Asa, st[21] = Ase, st[22] = Asi, st[23] = Aso, st[24] = Asu;
+}
+
+/// Returns the word of the padded message at the given offset (multiple of 8).
+/// The word is padded with the Keccak pad10*1 rule if it reaches the end of the message.
+inline uint64_t padded_word(const std::byte* data, size_t size, size_t offset) noexcept
+{
+    if (offset + 8 <= size)
+        return load_le64(data + offset);
+
+    std::byte w[8]{};
+    if (offset < size)
+        std::memcpy(w, data + offset, size - offset);
+    if (offset <= size && size < offset + 8)
+        w[size - offset] = std::byte{0x01};
+    const auto last = (size / RATE + 1) * RATE - 8;
+    if (offset == last)
+        w[7] |= std::byte{0x80};
+    return load_le64(w);
+}
+
+/// The Keccak-256 of a single input.
+[[gnu::always_inline]] inline void keccak256_implementation(
+    std::byte hash[KECCAK256_HASH_SIZE], const std::byte* data, size_t size) noexcept
+{
+    uint64_t st[25]{};
+
+    for (; size >= RATE; data += RATE, size -= RATE)
+    {
+        for (size_t i = 0; i < RATE_WORDS; ++i)
+            st[i] ^= load_le64(data + i * 8);
+        keccakf1600(st);
+    }
+
+    // The last (padded) block. Short inputs (the most common case) go directly here.
+    // Only the words covering the input are loaded.
+    const auto num_full_words = size / 8;
+    for (size_t i = 0; i < num_full_words; ++i)
+        st[i] ^= load_le64(data + i * 8);
+    st[num_full_words] ^= padded_word(data, size, num_full_words * 8) & ~(uint64_t{0x80} << 56);
+    st[RATE_WORDS - 1] ^= uint64_t{0x80} << 56;
+    keccakf1600(st);
+
+    for (size_t i = 0; i < KECCAK256_HASH_SIZE / 8; ++i)
+        store_le64(hash + i * 8, st[i]);
+}
+
+/// The multi-buffer Keccak-256 of W inputs at once.
+///
+/// The V is the vector of W uint64_t lanes. The inputs of different lengths are processed
+/// in lockstep: the digest of an input is taken after its last block is absorbed.
+template <typename V, size_t W>
+[[gnu::always_inline]] inline void keccak256_lanes(std::byte* const hashes[W],
+    const std::byte* const data[W], const size_t sizes[W]) noexcept
+{
+    static_assert(sizeof(V) == W * sizeof(uint64_t));
+
+    size_t num_blocks[W];
+    for (size_t l = 0; l < W; ++l)
+        num_blocks[l] = sizes[l] / RATE + 1;
+    const auto max_blocks = *std::max_element(num_blocks, num_blocks + W);
+
+    V st[25]{};
+    for (size_t b = 0; b < max_blocks; ++b)
+    {
+        for (size_t i = 0; i < RATE_WORDS; ++i)
+        {
+            uint64_t words[W]{};
+            for (size_t l = 0; l < W; ++l)
+            {
+                if (b < num_blocks[l])
+                    words[l] = padded_word(data[l], sizes[l], b * RATE + i * 8);
+            }
+            V v;
+            std::memcpy(&v, words, sizeof(v));
+            st[i] ^= v;
+        }
+
+        keccakf1600(st);
+
+        for (size_t l = 0; l < W; ++l)
+        {
+            if (b + 1 != num_blocks[l])
+                continue;
+            for (size_t i = 0; i < KECCAK256_HASH_SIZE / 8; ++i)
+                store_le64(hashes[l] + i * 8, st[i][l]);
+        }
+    }
+}
+
+/// Hashes the batch in groups of W inputs using keccak256_lanes().
+/// The missing inputs of the last group are replaced with the empty ones.
+template <typename V, size_t W>
+[[gnu::always_inline]] inline void keccak256_batch_implementation(std::byte* hashes,
+    const std::byte* const* data, const size_t* sizes, size_t count) noexcept
+{
+    std::byte unused_hash[KECCAK256_HASH_SIZE];
+    for (size_t first = 0; first < count; first += W)
+    {
+        std::byte* group_hashes[W];
+        const std::byte* group_data[W];
+        size_t group_sizes[W];
+        for (size_t l = 0; l < W; ++l)
+        {
+            const auto i = first + l;
+            const auto valid = i < count;
+            group_hashes[l] = valid ? hashes + i * KECCAK256_HASH_SIZE : unused_hash;
+            group_data[l] = valid ? data[i] : nullptr;
+            group_sizes[l] = valid ? sizes[i] : 0;
+        }
+        keccak256_lanes<V, W>(group_hashes, group_data, group_sizes);
+    }
+}
+
+void keccak256_generic(
+    std::byte hash[KECCAK256_HASH_SIZE], const std::byte* data, size_t size) noexcept
+{
+    keccak256_implementation(hash, data, size);
+}
+
+void keccak256_batch_generic(std::byte* hashes, const std::byte* const* data, const size_t* sizes,
+    size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        keccak256_implementation(hashes + i * KECCAK256_HASH_SIZE, data[i], sizes[i]);
+}
+
+void (*keccak256_best)(std::byte hash[KECCAK256_HASH_SIZE], const std::byte* data,
+    size_t size) noexcept = keccak256_generic;
+
+void (*keccak256_batch_best)(std::byte* hashes, const std::byte* const* data, const size_t* sizes,
+    size_t count) noexcept = keccak256_batch_generic;
+
+#if defined(__x86_64__)
+
+__attribute__((target("bmi,bmi2"))) void keccak256_x86_bmi(
+    std::byte hash[KECCAK256_HASH_SIZE], const std::byte* data, size_t size) noexcept
+{
+    keccak256_implementation(hash, data, size);
+}
+
+__attribute__((target("bmi,bmi2"))) void keccak256_batch_x86_bmi(std::byte* hashes,
+    const std::byte* const* data, const size_t* sizes, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        keccak256_implementation(hashes + i * KECCAK256_HASH_SIZE, data[i], sizes[i]);
+}
+
+using u64x4 = uint64_t __attribute__((vector_size(32)));
+using u64x8 = uint64_t __attribute__((vector_size(64)));
+
+__attribute__((target("avx2"))) void keccak256_batch_x86_avx2(std::byte* hashes,
+    const std::byte* const* data, const size_t* sizes, size_t count) noexcept
+{
+    keccak256_batch_implementation<u64x4, 4>(hashes, data, sizes, count);
+}
+
+__attribute__((target("avx512f"))) void keccak256_batch_x86_avx512(std::byte* hashes,
+    const std::byte* const* data, const size_t* sizes, size_t count) noexcept
+{
+    keccak256_batch_implementation<u64x8, 8>(hashes, data, sizes, count);
+}
+
+bool has_avx2() noexcept
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+bool has_avx512() noexcept
+{
+    return __builtin_cpu_supports("avx512f");
+}
+
+__attribute__((constructor)) void select_keccak256_implementation() noexcept
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2"))
+    {
+        keccak256_best = keccak256_x86_bmi;
+        keccak256_batch_best = keccak256_batch_x86_bmi;
+    }
+    if (has_avx2())
+        keccak256_batch_best = keccak256_batch_x86_avx2;
+    if (has_avx512())
+        keccak256_batch_best = keccak256_batch_x86_avx512;
+}
+
+#endif  // defined(__x86_64__)
+}  // namespace
+
+void keccak256(std::byte hash[KECCAK256_HASH_SIZE], const std::byte* data, size_t size) noexcept
+{
+    keccak256_best(hash, data, size);
+}
+
+void keccak256_batch(std::byte* hashes, const std::byte* const* data, const size_t* sizes,
+    size_t count) noexcept
+{
+    // A single input doesn't benefit from the multi-buffer implementation.
+    if (count == 1)
+        return keccak256_best(hashes, data[0], sizes[0]);
+    keccak256_batch_best(hashes, data, sizes, count);
+}
+
+bool is_supported(Keccak256BatchImpl impl) noexcept
+{
+    switch (impl)
+    {
+    case Keccak256BatchImpl::scalar:
+        return true;
+#if defined(__x86_64__)
+    case Keccak256BatchImpl::avx2:
+        return has_avx2();
+    case Keccak256BatchImpl::avx512:
+        return has_avx512();
+#endif
+    default:
+        return false;
+    }
+}
+
+void keccak256_batch(Keccak256BatchImpl impl, std::byte* hashes, const std::byte* const* data,
+    const size_t* sizes, size_t count) noexcept
+{
+    assert(is_supported(impl));
+    switch (impl)
+    {
+#if defined(__x86_64__)
+    case Keccak256BatchImpl::avx2:
+        return keccak256_batch_x86_avx2(hashes, data, sizes, count);
+    case Keccak256BatchImpl::avx512:
+        return keccak256_batch_x86_avx512(hashes, data, sizes, count);
+#endif
+    default:
+        return keccak256_batch_generic(hashes, data, sizes, count);
+    }
+}
+}  // namespace evmone::crypto
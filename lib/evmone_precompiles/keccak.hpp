@@ -0,0 +1,49 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+
+namespace evmone::crypto
+{
+/// The size (32 bytes) of the Keccak-256 message digest.
+static constexpr std::size_t KECCAK256_HASH_SIZE = 256 / 8;
+
+/// Computes the Keccak-256 hash function.
+///
+/// @param[out] hash  The result message digest is written to the provided memory.
+/// @param      data  The input data.
+/// @param      size  The size of the input data.
+void keccak256(std::byte hash[KECCAK256_HASH_SIZE], const std::byte* data, size_t size) noexcept;
+
+/// Computes the Keccak-256 hashes of multiple independent inputs.
+///
+/// The inputs are hashed in groups by the multi-buffer implementation processing 4 (AVX2)
+/// or 8 (AVX-512) inputs at once, if the CPU supports it. The implementation is selected
+/// at runtime. Otherwise, the inputs are hashed one by one.
+///
+/// @param[out] hashes  The result message digests: count * KECCAK256_HASH_SIZE bytes.
+/// @param      data    The pointers to the count input data.
+/// @param      sizes   The sizes of the count input data.
+/// @param      count   The number of the inputs.
+void keccak256_batch(std::byte* hashes, const std::byte* const* data, const size_t* sizes,
+    size_t count) noexcept;
+
+/// The implementations of keccak256_batch() by the number of inputs hashed at once.
+enum class Keccak256BatchImpl
+{
+    scalar,  ///< One input at a time.
+    avx2,    ///< 4 inputs at once.
+    avx512,  ///< 8 inputs at once.
+};
+
+/// Checks if the keccak256_batch() implementation is supported by the CPU.
+bool is_supported(Keccak256BatchImpl impl) noexcept;
+
+/// Computes the Keccak-256 hashes of multiple independent inputs with the given implementation,
+/// instead of the one selected at runtime. The implementation must be supported by the CPU.
+/// This is meant for testing and benchmarking.
+void keccak256_batch(Keccak256BatchImpl impl, std::byte* hashes, const std::byte* const* data,
+    const size_t* sizes, size_t count) noexcept;
+}  // namespace evmone::crypto
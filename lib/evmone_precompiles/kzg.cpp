@@ -5,8 +5,13 @@
 #include "kzg.hpp"
 #include <blst.h>
 #include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <span>
+#include <vector>
 
 namespace evmone::crypto
 {
@@ -119,25 +124,35 @@ bool pairings_verify(
     blst_miller_loop(&right, &b2, &b1);
     return blst_fp12_finalverify(&left, &right);
 }
-}  // namespace
 
-bool kzg_verify_proof(const std::byte versioned_hash[VERSIONED_HASH_SIZE], const std::byte z[32],
-    const std::byte y[32], const std::byte commitment[48], const std::byte proof[48]) noexcept
+/// The decoded and validated inputs of the KZG proof verification.
+struct Proof
+{
+    blst_scalar z;
+    blst_scalar y;
+    blst_p1_affine C;
+    blst_p1_affine Pi;
+};
+
+/// Checks the versioned hash of the commitment and decodes and validates the rest of the inputs.
+std::optional<Proof> decode_proof(const std::byte versioned_hash[VERSIONED_HASH_SIZE],
+    const std::byte z[32], const std::byte y[32], const std::byte commitment[48],
+    const std::byte proof[48]) noexcept
 {
     std::byte computed_versioned_hash[32];
     sha256(computed_versioned_hash, commitment, 48);
     computed_versioned_hash[0] = VERSIONED_HASH_VERSION_KZG;
     if (!std::ranges::equal(std::span{versioned_hash, 32}, computed_versioned_hash))
-        return false;
+        return std::nullopt;
 
     // Load and validate scalars z and y.
     // TODO(C++26): The span construction can be done as std::snap(z, std::c_<32>).
     const auto zz = validate_scalar(std::span<const std::byte, 32>{z, 32});
     if (!zz)
-        return false;
+        return std::nullopt;
     const auto yy = validate_scalar(std::span<const std::byte, 32>{y, 32});
     if (!yy)
-        return false;
+        return std::nullopt;
 
     // Uncompress and validate the points C (representing the polynomial commitment)
     // and Pi (representing the proof). They both are valid to be points at infinity
@@ -145,24 +160,206 @@ bool kzg_verify_proof(const std::byte versioned_hash[VERSIONED_HASH_SIZE], const
     // see https://hackmd.io/@kevaundray/kzg-is-zero-proof-sound
     const auto C = validate_G1(std::span<const std::byte, 48>{commitment, 48});
     if (!C)
-        return false;
+        return std::nullopt;
     const auto Pi = validate_G1(std::span<const std::byte, 48>{proof, 48});
     if (!Pi)
-        return false;
+        return std::nullopt;
+
+    return Proof{*zz, *yy, *C, *Pi};
+}
+
+std::optional<Proof> decode_proof(const KZGProofInput& input) noexcept
+{
+    return decode_proof(input.versioned_hash, input.z, input.y, input.commitment, input.proof);
+}
 
+/// Verifies the single decoded proof.
+bool verify_proof(const Proof& proof) noexcept
+{
     // Compute -Y as [y * -1]₁.
-    const auto neg_Y = mult(G1_GENERATOR_NEGATIVE, *yy);
+    const auto neg_Y = mult(G1_GENERATOR_NEGATIVE, proof.y);
 
     // Compute C - Y. It can happen that C == -Y so doubling may be needed.
-    const auto C_sub_Y = add_or_double(*C, neg_Y);
+    const auto C_sub_Y = add_or_double(proof.C, neg_Y);
 
     // Compute -Z as [z * -1]₂.
-    const auto neg_Z = mult(G2_GENERATOR_NEGATIVE, *zz);
+    const auto neg_Z = mult(G2_GENERATOR_NEGATIVE, proof.z);
 
     // Compute X - Z which is [s - z]₂.
     const auto X_sub_Z = add_or_double(KZG_SETUP_G2_1, neg_Z);
 
     // e(C - [y]₁, [1]₂) =? e(Pi, [s - z]₂)
-    return pairings_verify(C_sub_Y, *Pi, X_sub_Z);
+    return pairings_verify(C_sub_Y, proof.Pi, X_sub_Z);
+}
+
+/// Number of bits of the random coefficients of the batch verification.
+/// The probability of accepting a batch with an invalid proof is 2⁻¹²⁸.
+constexpr size_t BATCH_COEFFICIENT_BITS = 128;
+
+/// Computes the multi-scalar multiplication Σ sᵢ⋅Pᵢ for the scalars of at most nbits bits.
+/// The points at infinity are skipped.
+blst_p1 msm(std::span<const blst_p1_affine> points, std::span<const blst_scalar> scalars,
+    size_t nbits) noexcept
+{
+    assert(points.size() == scalars.size());
+
+    std::vector<blst_p1_affine> p;
+    std::vector<blst_scalar> s;
+    p.reserve(points.size());
+    s.reserve(scalars.size());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        if (blst_p1_affine_is_inf(&points[i]))
+            continue;
+        p.push_back(points[i]);
+        s.push_back(scalars[i]);
+    }
+
+    blst_p1 out{};  // The point at infinity.
+    if (p.empty())
+        return out;
+
+    // The contiguous arrays are passed as the arrays of pointers terminated by the null pointer.
+    const blst_p1_affine* const points_ptrs[] = {p.data(), nullptr};
+    const uint8_t* const scalars_ptrs[] = {s.data()->b, nullptr};
+    const auto scratch_size = blst_p1s_mult_pippenger_scratch_sizeof(p.size()) / sizeof(limb_t);
+    const auto scratch_space = std::make_unique_for_overwrite<limb_t[]>(scratch_size);
+    blst_p1s_mult_pippenger(&out, points_ptrs, p.size(), scalars_ptrs, nbits, scratch_space.get());
+    return out;
+}
+
+/// Verifies the decoded proofs with the single pairing check.
+///
+/// For the proofs (Cᵢ, zᵢ, yᵢ, Piᵢ) and the random coefficients rᵢ the individual checks
+/// e(Cᵢ - [yᵢ]₁, [1]₂) = e(Piᵢ, [s - zᵢ]₂), rewritten as
+/// e(Cᵢ - [yᵢ]₁ + zᵢ⋅Piᵢ, [1]₂) = e(Piᵢ, [s]₂), are combined into
+/// e(Σ rᵢ⋅Cᵢ + Σ rᵢzᵢ⋅Piᵢ - [Σ rᵢyᵢ]₁, [1]₂) = e(Σ rᵢ⋅Piᵢ, [s]₂).
+/// The coefficients are derived from the seed, which must commit to all the inputs.
+bool verify_proof_batch(
+    std::span<const Proof> proofs, const std::byte seed[SHA256_HASH_SIZE]) noexcept
+{
+    const auto n = proofs.size();
+
+    // The points [C..., Pi...] and their scalars [r..., r⋅z...].
+    std::vector<blst_p1_affine> points(2 * n);
+    std::vector<blst_scalar> scalars(2 * n);
+    intx::uint256 y_sum;
+    for (size_t i = 0; i < n; ++i)
+    {
+        // rᵢ = SHA256(seed || i) truncated to 128 bits.
+        std::byte preimage[SHA256_HASH_SIZE + sizeof(uint64_t)];
+        std::memcpy(preimage, seed, SHA256_HASH_SIZE);
+        for (size_t j = 0; j < sizeof(uint64_t); ++j)
+            preimage[SHA256_HASH_SIZE + j] = static_cast<std::byte>(i >> (8 * j));
+        std::byte h[SHA256_HASH_SIZE];
+        sha256(h, preimage, sizeof(preimage));
+
+        auto& r = scalars[i];
+        r = {};
+        std::memcpy(r.b, h, BATCH_COEFFICIENT_BITS / 8);
+        const auto rr = intx::le::load<intx::uint256>(r.b);
+
+        const auto& p = proofs[i];
+        points[i] = p.C;
+        points[n + i] = p.Pi;
+        const auto rz = intx::mulmod(rr, intx::le::load<intx::uint256>(p.z.b), BLS_MODULUS);
+        intx::le::store(scalars[n + i].b, rz);
+        const auto ry = intx::mulmod(rr, intx::le::load<intx::uint256>(p.y.b), BLS_MODULUS);
+        y_sum = intx::addmod(y_sum, ry, BLS_MODULUS);
+    }
+
+    // Σ rᵢ⋅Cᵢ + Σ rᵢzᵢ⋅Piᵢ
+    const auto lhs_msm = msm(points, scalars, BLS_MODULUS_BITS);
+
+    // - [Σ rᵢyᵢ]₁
+    blst_scalar y_sum_scalar;
+    intx::le::store(y_sum_scalar.b, y_sum);
+    const auto neg_Y = mult(G1_GENERATOR_NEGATIVE, y_sum_scalar);
+
+    blst_p1 lhs;
+    blst_p1_add_or_double(&lhs, &lhs_msm, &neg_Y);
+    blst_p1_affine lhs_affine;
+    blst_p1_to_affine(&lhs_affine, &lhs);
+
+    // Σ rᵢ⋅Piᵢ
+    const auto rhs = msm(std::span{points}.subspan(n), std::span{scalars}.first(n),
+        BATCH_COEFFICIENT_BITS);
+    blst_p1_affine rhs_affine;
+    blst_p1_to_affine(&rhs_affine, &rhs);
+
+    return pairings_verify(lhs_affine, rhs_affine, KZG_SETUP_G2_1);
+}
+
+/// Computes the seed of the batch verification coefficients (Fiat–Shamir): the hash of all
+/// the inputs, so the coefficients cannot be known before the inputs are fixed.
+void batch_seed(std::byte seed[SHA256_HASH_SIZE], std::span<const KZGProofInput> inputs) noexcept
+{
+    sha256(seed, reinterpret_cast<const std::byte*>(inputs.data()), inputs.size_bytes());
+}
+}  // namespace
+
+bool kzg_verify_proof(const std::byte versioned_hash[VERSIONED_HASH_SIZE], const std::byte z[32],
+    const std::byte y[32], const std::byte commitment[48], const std::byte proof[48]) noexcept
+{
+    const auto p = decode_proof(versioned_hash, z, y, commitment, proof);
+    return p && verify_proof(*p);
+}
+
+bool kzg_verify_proof_batch(std::span<const KZGProofInput> inputs) noexcept
+{
+    std::vector<Proof> proofs;
+    proofs.reserve(inputs.size());
+    for (const auto& input : inputs)
+    {
+        const auto p = decode_proof(input);
+        if (!p)
+            return false;
+        proofs.push_back(*p);
+    }
+
+    if (proofs.empty())
+        return true;
+    if (proofs.size() == 1)
+        return verify_proof(proofs[0]);
+
+    std::byte seed[SHA256_HASH_SIZE];
+    batch_seed(seed, inputs);
+    return verify_proof_batch(proofs, seed);
+}
+
+bool kzg_verify_proofs(std::span<const KZGProofInput> inputs, std::span<bool> valid) noexcept
+{
+    assert(inputs.size() == valid.size());
+
+    // The decoded proofs and their indexes in the inputs.
+    std::vector<Proof> proofs;
+    std::vector<size_t> indexes;
+    proofs.reserve(inputs.size());
+    indexes.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        const auto p = decode_proof(inputs[i]);
+        valid[i] = p.has_value();
+        if (p)
+        {
+            proofs.push_back(*p);
+            indexes.push_back(i);
+        }
+    }
+
+    if (proofs.size() > 1)
+    {
+        std::byte seed[SHA256_HASH_SIZE];
+        batch_seed(seed, inputs);
+        if (verify_proof_batch(proofs, seed))
+            return proofs.size() == inputs.size();
+    }
+
+    // The batch check has failed so at least one of the proofs is invalid.
+    // Verify them one by one to find which.
+    for (size_t k = 0; k < proofs.size(); ++k)
+        valid[indexes[k]] = verify_proof(proofs[k]);
+
+    return std::ranges::all_of(valid, std::identity{});
 }
 }  // namespace evmone::crypto
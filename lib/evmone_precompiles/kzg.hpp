@@ -5,6 +5,7 @@
 #pragma once
 #include "sha256.hpp"
 #include <intx/intx.hpp>
+#include <span>
 
 namespace evmone::crypto
 {
@@ -27,6 +28,35 @@ constexpr auto BLS_MODULUS =
 constexpr size_t BLS_MODULUS_BITS = 255;
 static_assert((BLS_MODULUS >> BLS_MODULUS_BITS) == 0);
 
+/// The inputs of the KZG proof verification, in the layout of the point evaluation precompile
+/// input (EIP-4844).
+struct KZGProofInput
+{
+    std::byte versioned_hash[VERSIONED_HASH_SIZE];
+    std::byte z[32];
+    std::byte y[32];
+    std::byte commitment[48];
+    std::byte proof[48];
+
+    bool operator==(const KZGProofInput&) const = default;
+};
+static_assert(sizeof(KZGProofInput) == 192);
+
 bool kzg_verify_proof(const std::byte versioned_hash[VERSIONED_HASH_SIZE], const std::byte z[32],
     const std::byte y[32], const std::byte commitment[48], const std::byte proof[48]) noexcept;
+
+/// Verifies the KZG proofs in a batch.
+///
+/// The pairing checks of the proofs are aggregated with random linear combination
+/// into a single one, so the cost of the batch is dominated by two multi-scalar multiplications
+/// instead of two pairings per proof. The random coefficients are derived from the inputs
+/// (Fiat–Shamir). Returns true if all the proofs are valid (also for the empty batch).
+bool kzg_verify_proof_batch(std::span<const KZGProofInput> inputs) noexcept;
+
+/// Verifies the KZG proofs and reports the result of every proof in the valid span
+/// (of the same size as inputs).
+///
+/// The proofs are verified in a batch first. If the batch check fails, the proofs are verified
+/// one by one to find the invalid ones. Returns true if all the proofs are valid.
+bool kzg_verify_proofs(std::span<const KZGProofInput> inputs, std::span<bool> valid) noexcept;
 }  // namespace evmone::crypto
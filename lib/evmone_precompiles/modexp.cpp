@@ -0,0 +1,492 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "modexp.hpp"
+#include <evmmax/evmmax.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <tuple>
+#include <vector>
+
+namespace evmone::crypto
+{
+namespace
+{
+/// The little-endian 64-bit words of a natural number.
+using Words = std::vector<uint64_t>;
+
+/// Computes a⋅b + c + d (cannot overflow 128 bits). Returns the {hi, lo} words.
+inline std::pair<uint64_t, uint64_t> mul_add(
+    uint64_t a, uint64_t b, uint64_t c, uint64_t d) noexcept
+{
+    const auto p = intx::umul(a, b) + c + d;
+    return {p[1], p[0]};
+}
+
+/// Loads the big-endian bytes into the words. The bytes not fitting the words are ignored.
+void load(std::span<uint64_t> words, std::span<const uint8_t> bytes) noexcept
+{
+    std::ranges::fill(words, 0);
+    const auto n = std::min(bytes.size(), words.size() * 8);
+    for (size_t i = 0; i < n; ++i)
+        words[i / 8] |= uint64_t{bytes[bytes.size() - 1 - i]} << (i % 8 * 8);
+}
+
+/// Stores the words as big-endian bytes filling the whole output (zero-padded).
+void store(std::span<uint8_t> output, std::span<const uint64_t> words) noexcept
+{
+    for (size_t i = 0; i < output.size(); ++i)
+    {
+        const auto w = i / 8 < words.size() ? words[i / 8] : 0;
+        output[output.size() - 1 - i] = static_cast<uint8_t>(w >> (i % 8 * 8));
+    }
+}
+
+/// Computes the r.size() lowest words of x⋅y.
+void mul_lo(
+    std::span<uint64_t> r, std::span<const uint64_t> x, std::span<const uint64_t> y) noexcept
+{
+    std::ranges::fill(r, 0);
+    for (size_t i = 0; i < std::min(x.size(), r.size()); ++i)
+    {
+        uint64_t c = 0;
+        for (size_t j = 0; j < y.size() && i + j < r.size(); ++j)
+            std::tie(c, r[i + j]) = mul_add(x[i], y[j], r[i + j], c);
+        if (i + y.size() < r.size())
+            r[i + y.size()] = c;
+    }
+}
+
+/// Computes r = x + y. Returns the carry. The r, x and y must have the same size.
+bool add(std::span<uint64_t> r, std::span<const uint64_t> x, std::span<const uint64_t> y) noexcept
+{
+    bool carry = false;
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        const auto s = intx::addc(x[i], y[i], carry);
+        r[i] = s.value;
+        carry = s.carry;
+    }
+    return carry;
+}
+
+/// Computes r = x - y. Returns the borrow. The r, x and y must have the same size.
+bool sub(std::span<uint64_t> r, std::span<const uint64_t> x, std::span<const uint64_t> y) noexcept
+{
+    bool borrow = false;
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        const auto d = intx::subc(x[i], y[i], borrow);
+        r[i] = d.value;
+        borrow = d.carry;
+    }
+    return borrow;
+}
+
+/// Selects the sliding window size by the exponent bit length.
+/// The thresholds balance the precomputation against the number of multiplications.
+constexpr size_t window_size(size_t exp_bits) noexcept
+{
+    if (exp_bits > 671)
+        return 6;
+    if (exp_bits > 239)
+        return 5;
+    if (exp_bits > 79)
+        return 4;
+    if (exp_bits > 23)
+        return 3;
+    return 1;
+}
+
+/// Computes base^exp using the left-to-right sliding window exponentiation.
+///
+/// The Arith provides the multiplication and the one value (in the Montgomery form
+/// if the Arith uses it). The exp is a big-endian number.
+template <typename Arith>
+typename Arith::Value pow(
+    const Arith& arith, const typename Arith::Value& base, std::span<const uint8_t> exp)
+{
+    const auto exp_begin = std::ranges::find_if(exp, [](auto b) { return b != 0; });
+    exp = exp.subspan(static_cast<size_t>(exp_begin - exp.begin()));
+    if (exp.empty())
+        return arith.one();
+
+    const auto num_bits = exp.size() * 8 - static_cast<size_t>(std::countl_zero(exp[0]));
+    const auto bit = [exp](size_t i) noexcept {
+        return (exp[exp.size() - 1 - i / 8] >> (i % 8)) & 1u;
+    };
+
+    // Precompute the odd powers: base, base^3, base^5, ..., base^(2^window - 1).
+    const auto window = window_size(num_bits);
+    std::vector<typename Arith::Value> odd_powers(size_t{1} << (window - 1));
+    odd_powers[0] = base;
+    if (odd_powers.size() > 1)
+    {
+        const auto base_squared = arith.mul(base, base);
+        for (size_t i = 1; i < odd_powers.size(); ++i)
+            odd_powers[i] = arith.mul(odd_powers[i - 1], base_squared);
+    }
+
+    // The exponent bits are processed from the top: zero bits one by one and
+    // the windows of at most the window size bits starting and ending with a one bit.
+    typename Arith::Value r;
+    bool is_one = true;
+    for (size_t i = num_bits; i != 0;)
+    {
+        if (bit(i - 1) == 0)
+        {
+            r = arith.mul(r, r);
+            --i;
+            continue;
+        }
+
+        auto low = i > window ? i - window : 0;
+        while (bit(low) == 0)
+            ++low;
+
+        unsigned value = 0;
+        for (auto j = i; j != low; --j)
+            value = (value << 1) | bit(j - 1);
+
+        if (is_one)
+        {
+            r = odd_powers[value >> 1];
+            is_one = false;
+        }
+        else
+        {
+            for (auto j = low; j != i; ++j)
+                r = arith.mul(r, r);
+            r = arith.mul(r, odd_powers[value >> 1]);
+        }
+        i = low;
+    }
+    return r;
+}
+
+/// The Montgomery modular arithmetic for fixed-size odd modulus using evmmax::ModArith.
+template <typename UintT>
+class FixedModArith
+{
+    evmmax::ModArith<UintT> m_arith;
+
+    static UintT to_uint(std::span<const uint64_t> words) noexcept
+    {
+        assert(words.size() <= UintT::num_words);
+        UintT x{};
+        for (size_t i = 0; i < words.size(); ++i)
+            x[i] = words[i];
+        return x;
+    }
+
+public:
+    using Value = UintT;
+
+    explicit FixedModArith(std::span<const uint64_t> mod) noexcept : m_arith{to_uint(mod)} {}
+
+    Value one() const noexcept { return m_arith.to_mont(1); }
+
+    Value mul(const Value& x, const Value& y) const noexcept { return m_arith.mul(x, y); }
+
+    /// Loads the big-endian number of any length to the Montgomery form (reducing it modulo mod).
+    /// This is the Horner's scheme by the words of the UintT size: acc = acc⋅R + chunk.
+    Value load(std::span<const uint8_t> bytes) const noexcept
+    {
+        static constexpr auto CHUNK_SIZE = sizeof(UintT);
+        Value acc{};
+        uint64_t chunk[UintT::num_words];
+        auto chunk_len = bytes.size() % CHUNK_SIZE;
+        if (chunk_len == 0)
+            chunk_len = CHUNK_SIZE;
+        for (size_t pos = 0; pos < bytes.size(); pos += chunk_len, chunk_len = CHUNK_SIZE)
+        {
+            crypto::load(chunk, bytes.subspan(pos, chunk_len));
+            acc = m_arith.add(m_arith.to_mont(acc), m_arith.to_mont(to_uint(chunk)));
+        }
+        return acc;
+    }
+
+    /// Converts the value from the Montgomery form to words.
+    Words result(const Value& x) const
+    {
+        const auto r = m_arith.from_mont(x);
+        Words words(UintT::num_words);
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] = r[i];
+        return words;
+    }
+};
+
+/// The Montgomery modular arithmetic for odd modulus of any number of words.
+///
+/// This is the dynamic-size variant of evmmax::ModArith used for moduli
+/// not fitting any of the fixed sizes.
+class DynModArith
+{
+    Words m_mod;
+    Words m_r_squared;  ///< R² % mod.
+    uint64_t m_mod_inv = 0;  ///< The modulus inversion: mod⋅N' = 2⁶⁴-1.
+
+public:
+    using Value = Words;
+
+    explicit DynModArith(std::span<const uint64_t> mod)
+      : m_mod{mod.begin(), mod.end()}, m_r_squared(mod.size())
+    {
+        assert(!m_mod.empty() && (m_mod[0] & 1) != 0);
+
+        // The Newton's iteration for the inverse doubling the number of correct bits:
+        // x⋅mod₀ ≡ 1 mod 2³ for odd mod₀, then 2⁶, 2¹², 2²⁴, 2⁴⁸ and 2⁹⁶.
+        auto inv = m_mod[0];
+        for (int i = 0; i < 5; ++i)
+            inv *= 2 - m_mod[0] * inv;
+        m_mod_inv = 0 - inv;
+
+        // R² % mod by doubling 1 2⋅num_bits times.
+        m_r_squared[0] = 1;
+        for (size_t i = 0; i < 2 * 64 * m_mod.size(); ++i)
+            m_r_squared = add(m_r_squared, m_r_squared);
+    }
+
+    /// Performs a modular addition. It is required that x < mod and y < mod.
+    Value add(const Value& x, const Value& y) const
+    {
+        Value s(x.size());
+        const auto carry = crypto::add(s, x, y);
+        Value d(x.size());
+        const auto borrow = crypto::sub(d, s, m_mod);
+        return (!carry && borrow) ? s : d;
+    }
+
+    /// Performs a Montgomery modular multiplication (CIOS, see evmmax::ModArith::mul()).
+    /// It is required that x⋅y < mod⋅R.
+    Value mul(const Value& x, const Value& y) const
+    {
+        const auto n = m_mod.size();
+        Words t(n + 2);
+        for (size_t i = 0; i != n; ++i)
+        {
+            uint64_t c = 0;
+            for (size_t j = 0; j != n; ++j)
+                std::tie(c, t[j]) = mul_add(x[j], y[i], t[j], c);
+            auto tmp = intx::addc(t[n], c);
+            t[n] = tmp.value;
+            t[n + 1] = tmp.carry;
+
+            const auto m = t[0] * m_mod_inv;
+            std::tie(c, std::ignore) = mul_add(m, m_mod[0], t[0], 0);
+            for (size_t j = 1; j != n; ++j)
+                std::tie(c, t[j - 1]) = mul_add(m, m_mod[j], t[j], c);
+            tmp = intx::addc(t[n], c);
+            t[n - 1] = tmp.value;
+            t[n] = t[n + 1] + tmp.carry;
+        }
+
+        Value r(t.begin(), t.begin() + static_cast<ptrdiff_t>(n));
+        Value d(n);
+        if (const auto borrow = crypto::sub(d, r, m_mod); t[n] != 0 || !borrow)
+            return d;
+        return r;
+    }
+
+    Value to_mont(const Value& x) const { return mul(x, m_r_squared); }
+
+    Value one() const
+    {
+        Value x(m_mod.size());
+        x[0] = 1;
+        return to_mont(x);
+    }
+
+    /// Loads the big-endian number of any length to the Montgomery form (reducing it modulo mod).
+    /// This is the Horner's scheme by the chunks of the modulus size: acc = acc⋅R + chunk.
+    Value load(std::span<const uint8_t> bytes) const
+    {
+        const auto chunk_size = m_mod.size() * 8;
+        Value acc(m_mod.size());
+        Value chunk(m_mod.size());
+        auto chunk_len = bytes.size() % chunk_size;
+        if (chunk_len == 0)
+            chunk_len = chunk_size;
+        for (size_t pos = 0; pos < bytes.size(); pos += chunk_len, chunk_len = chunk_size)
+        {
+            crypto::load(chunk, bytes.subspan(pos, chunk_len));
+            acc = add(to_mont(acc), to_mont(chunk));
+        }
+        return acc;
+    }
+
+    /// Converts the value from the Montgomery form.
+    Words result(const Value& x) const
+    {
+        Value unit(m_mod.size());
+        unit[0] = 1;
+        return mul(x, unit);
+    }
+};
+
+/// The arithmetic modulo 2^k (the even part of a modulus).
+class Pow2Arith
+{
+    size_t m_num_words;
+    uint64_t m_top_mask;
+
+    void truncate(Words& x) const noexcept { x.back() &= m_top_mask; }
+
+public:
+    using Value = Words;
+
+    explicit Pow2Arith(size_t k) noexcept
+      : m_num_words{(k + 63) / 64},
+        m_top_mask{k % 64 == 0 ? ~uint64_t{0} : (uint64_t{1} << (k % 64)) - 1}
+    {
+        assert(k != 0);
+    }
+
+    Value one() const
+    {
+        Value x(m_num_words);
+        x[0] = 1;
+        truncate(x);
+        return x;
+    }
+
+    Value mul(const Value& x, const Value& y) const
+    {
+        Value r(m_num_words);
+        mul_lo(r, x, y);
+        truncate(r);
+        return r;
+    }
+
+    Value sub(const Value& x, const Value& y) const
+    {
+        Value r(m_num_words);
+        crypto::sub(r, std::span{x}.first(m_num_words), std::span{y}.first(m_num_words));
+        truncate(r);
+        return r;
+    }
+
+    /// Computes the inverse of the odd x modulo 2^k by the Newton's iteration:
+    /// inv = inv⋅(2 - x⋅inv) doubles the number of correct bits starting from 3.
+    Value inv(const Value& odd) const
+    {
+        Value x(m_num_words);
+        std::copy_n(odd.begin(), std::min(odd.size(), m_num_words), x.begin());
+        truncate(x);
+
+        auto two = one();
+        two[0] <<= 1;
+        truncate(two);
+
+        auto r = x;
+        for (size_t bits = 3; bits < 64 * m_num_words; bits *= 2)
+            r = mul(r, sub(two, mul(x, r)));
+        return r;
+    }
+
+    Value load(std::span<const uint8_t> bytes) const
+    {
+        Value x(m_num_words);
+        crypto::load(x, bytes);
+        truncate(x);
+        return x;
+    }
+
+    Words result(const Value& x) const { return x; }
+};
+
+template <typename Arith>
+Words modexp_with(const Arith& arith, std::span<const uint8_t> base, std::span<const uint8_t> exp)
+{
+    return arith.result(pow(arith, arith.load(base), exp));
+}
+
+/// Computes base^exp % mod for the odd mod. The fixed-size arithmetic is used for
+/// the common sizes up to 4096 bits. The result has at least as many words as the mod.
+Words modexp_odd(
+    std::span<const uint64_t> mod, std::span<const uint8_t> base, std::span<const uint8_t> exp)
+{
+    const auto n = mod.size();
+    if (n <= 4)
+        return modexp_with(FixedModArith<intx::uint256>{mod}, base, exp);
+    if (n <= 8)
+        return modexp_with(FixedModArith<intx::uint512>{mod}, base, exp);
+    if (n <= 16)
+        return modexp_with(FixedModArith<intx::uint<1024>>{mod}, base, exp);
+    if (n <= 32)
+        return modexp_with(FixedModArith<intx::uint<2048>>{mod}, base, exp);
+    if (n <= 64)
+        return modexp_with(FixedModArith<intx::uint<4096>>{mod}, base, exp);
+    return modexp_with(DynModArith{mod}, base, exp);
+}
+
+/// Computes base^exp % mod for the even mod = mod_odd⋅2^k.
+///
+/// The results x₁ = base^exp % mod_odd and x₂ = base^exp % 2^k are combined
+/// with the CRT: x = x₁ + mod_odd⋅((x₂ - x₁)⋅mod_odd⁻¹ % 2^k).
+Words modexp_even(
+    std::span<const uint64_t> mod, std::span<const uint8_t> base, std::span<const uint8_t> exp)
+{
+    const auto n = mod.size();
+
+    size_t k = 0;
+    while (mod[k / 64] == 0)
+        k += 64;
+    k += static_cast<size_t>(std::countr_zero(mod[k / 64]));
+
+    // mod_odd = mod >> k.
+    Words mod_odd(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const auto lo_index = i + k / 64;
+        const auto lo = lo_index < n ? mod[lo_index] >> (k % 64) : 0;
+        const auto hi = (k % 64 != 0 && lo_index + 1 < n) ? mod[lo_index + 1] << (64 - k % 64) : 0;
+        mod_odd[i] = lo | hi;
+    }
+    while (mod_odd.size() > 1 && mod_odd.back() == 0)
+        mod_odd.pop_back();
+
+    const Pow2Arith pow2{k};
+    auto x2 = modexp_with(pow2, base, exp);
+
+    if (mod_odd.size() == 1 && mod_odd[0] == 1)
+    {
+        x2.resize(n);
+        return x2;
+    }
+
+    auto x1 = modexp_odd(mod_odd, base, exp);
+    x1.resize(std::max(x1.size(), x2.size()));
+    const auto y = pow2.mul(pow2.sub(x2, x1), pow2.inv(mod_odd));
+
+    // The result x < mod so it fits n words.
+    x1.resize(n);
+    Words t(n);
+    mul_lo(t, mod_odd, y);
+    Words x(n);
+    add(x, x1, t);
+    return x;
+}
+}  // namespace
+
+void modexp(std::span<const uint8_t> base, std::span<const uint8_t> exp,
+    std::span<const uint8_t> mod, uint8_t* output) noexcept
+{
+    const auto output_span = std::span{output, mod.size()};
+
+    const auto mod_begin = std::ranges::find_if(mod, [](auto b) { return b != 0; });
+    const auto mod_trimmed = mod.subspan(static_cast<size_t>(mod_begin - mod.begin()));
+    if (mod_trimmed.empty())
+        return store(output_span, {});
+
+    Words mod_words((mod_trimmed.size() + 7) / 8);
+    load(mod_words, mod_trimmed);
+
+    const auto result = (mod_words[0] & 1) != 0 ? modexp_odd(mod_words, base, exp) :
+                                                  modexp_even(mod_words, base, exp);
+    store(output_span, result);
+}
+}  // namespace evmone::crypto
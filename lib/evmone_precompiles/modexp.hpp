@@ -0,0 +1,17 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace evmone::crypto
+{
+/// Computes the modular exponentiation base^exp % mod (the MODEXP precompile, EIP-198).
+///
+/// All numbers are big-endian of any length. The result is written to the output
+/// which must have the size of the mod. The result for the zero modulus is zero.
+void modexp(std::span<const uint8_t> base, std::span<const uint8_t> exp,
+    std::span<const uint8_t> mod, uint8_t* output) noexcept;
+}  // namespace evmone::crypto
@@ -7,6 +7,8 @@
 #include <ethash/hash_types.hpp>
 #include <evmc/evmc.hpp>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace evmmax::secp256k1
 {
@@ -22,12 +24,18 @@ inline constexpr auto Order =
 
 using Point = ecc::Point<uint256>;
 
+/// The modular arithmetic of the secp256k1 prime field.
+///
+/// The FieldPrime is the pseudo-Mersenne prime 2²⁵⁶ - 2³² - 977 so the values are
+/// not in Montgomery form and the multiplication uses the dedicated reduction.
+using FieldArith = ModArith<uint256, PseudoMersenneModulus<0x1000003d1>>;
+
 
 /// Modular inversion for secp256k1 prime field.
 ///
-/// Computes 1/x mod P modular inversion by computing modular exponentiation x^(P-2),
-/// where P is ::FieldPrime.
-uint256 field_inv(const ModArith<uint256>& m, const uint256& x) noexcept;
+/// Computes 1/x mod P modular inversion using the constant-time safegcd algorithm
+/// (see evmmax::safegcd::inv()), where P is ::FieldPrime.
+uint256 field_inv(const FieldArith& m, const uint256& x) noexcept;
 
 /// Square root for secp256k1 prime field.
 ///
@@ -35,17 +43,16 @@ uint256 field_inv(const ModArith<uint256>& m, const uint256& x) noexcept;
 /// where P is ::FieldPrime.
 ///
 /// @return Square root of x if it exists, std::nullopt otherwise.
-std::optional<uint256> field_sqrt(const ModArith<uint256>& m, const uint256& x) noexcept;
+std::optional<uint256> field_sqrt(const FieldArith& m, const uint256& x) noexcept;
 
 /// Inversion modulo order of secp256k1.
 ///
-/// Computes 1/x mod N modular inversion by computing modular exponentiation x^(N-2),
-/// where N is ::Order.
+/// Computes 1/x mod N modular inversion using the constant-time safegcd algorithm
+/// (see evmmax::safegcd::inv()), where N is ::Order. The x is in Montgomery form.
 uint256 scalar_inv(const ModArith<uint256>& m, const uint256& x) noexcept;
 
 /// Calculate y coordinate of a point having x coordinate and y parity.
-std::optional<uint256> calculate_y(
-    const ModArith<uint256>& m, const uint256& x, bool y_parity) noexcept;
+std::optional<uint256> calculate_y(const FieldArith& m, const uint256& x, bool y_parity) noexcept;
 
 /// Addition in secp256k1.
 ///
@@ -66,4 +73,23 @@ std::optional<Point> secp256k1_ecdsa_recover(
 std::optional<evmc::address> ecrecover(
     const ethash::hash256& e, const uint256& r, const uint256& s, bool v) noexcept;
 
+/// The input of the ECDSA public key recovery: the message hash and the signature.
+struct EcrecoverInput
+{
+    ethash::hash256 hash;
+    uint256 r;
+    uint256 s;
+    bool v = false;
+};
+
+/// Batch version of ecrecover().
+///
+/// Recovers the addresses for multiple signatures. The scalar inversions of r and the field
+/// inversions converting the public keys to affine coordinates are shared across all
+/// the signatures by Montgomery's trick.
+///
+/// @return The recovered addresses in the inputs order,
+///         std::nullopt for the invalid signatures.
+std::vector<std::optional<evmc::address>> ecrecover_batch(std::span<const EcrecoverInput> inputs);
+
 }  // namespace evmmax::secp256k1
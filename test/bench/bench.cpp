@@ -4,6 +4,7 @@
 
 #include "../statetest/statetest.hpp"
 #include "helpers.hpp"
+#include "state_benchmarks.hpp"
 #include "synthetic_benchmarks.hpp"
 #include <benchmark/benchmark.h>
 #include <evmc/evmc.hpp>
@@ -276,6 +277,7 @@ int main(int argc, char** argv)
         registered_vms["bnocgoto"] = evmc::VM{evmc_create_evmone(), {{"cgoto", "no"}}};
         register_benchmarks(benchmark_cases);
         register_synthetic_benchmarks();
+        register_state_benchmarks();
         RunSpecifiedBenchmarks();
         return 0;
     }
@@ -0,0 +1,175 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "state_benchmarks.hpp"
+#include "helpers.hpp"
+#include "test/state/block_state.hpp"
+#include "test/state/keccak_memo.hpp"
+#include "test/state/state.hpp"
+#include "test/state/test_state.hpp"
+#include "test/utils/bytecode.hpp"
+#include <evmone/evmone.h>
+
+using namespace benchmark;
+
+namespace evmone::test
+{
+namespace
+{
+/// Executes the block of transactions in the benchmark loop.
+void execute_block(State& bench_state, evmc::VM& vm, const TestState& pre,
+    std::span<const state::Transaction> txs, const state::BlockInfo& block)
+{
+    for ([[maybe_unused]] auto _ : bench_state)
+    {
+        state::BlockState block_state{pre};
+        for (const auto& tx : txs)
+        {
+            auto res = state::transition(block_state, block, tx, EVMC_CANCUN, vm, block.gas_limit,
+                state::BlockInfo::MAX_BLOB_GAS_PER_BLOCK);
+            const auto receipt = get_if<state::TransactionReceipt>(&res);
+            if (receipt == nullptr)
+                return bench_state.SkipWithError("invalid transaction");
+            block_state.apply(receipt->state_diff);
+        }
+        auto diff = block_state.build_diff();
+        DoNotOptimize(diff);
+    }
+    bench_state.counters["tx_rate"] = Counter(
+        static_cast<double>(txs.size() * bench_state.iterations()), Counter::kIsRate);
+}
+
+/// Executes the block of transactions, each calling the contract which increments
+/// many storage slots. This mostly exercises the Host storage access.
+void storage_heavy_block(State& bench_state, evmc::VM& vm)
+{
+    static constexpr auto Contract = 0xc0_address;
+    static constexpr size_t num_txs = 100;
+    static constexpr size_t num_slots = 50;
+    static constexpr int64_t tx_gas_limit = 5'000'000;
+
+    bytecode code;
+    for (size_t i = 0; i < num_slots; ++i)
+        code += sstore(i, add(sload(i), 1));
+
+    TestState pre{{Contract, {.code = code}}};
+    std::vector<state::Transaction> txs;
+    for (size_t i = 0; i < num_txs; ++i)
+    {
+        address sender{0x5e_address};
+        sender.bytes[0] = static_cast<uint8_t>(i);
+        pre[sender] = {.balance = 1};
+        txs.push_back({.gas_limit = tx_gas_limit, .sender = sender, .to = Contract});
+    }
+    const state::BlockInfo block{.gas_limit = static_cast<int64_t>(num_txs) * tx_gas_limit};
+    execute_block(bench_state, vm, pre, txs, block);
+}
+
+/// Executes the block of ERC-20 transferFrom(from, to, 1) transactions.
+/// The Solidity-like token contract computes the mapping storage locations
+/// keccak256(key ‖ slot) repeatedly for the same keys (for SLOAD and then SSTORE).
+void erc20_block(State& bench_state, evmc::VM& vm)
+{
+    static constexpr auto Token = 0x7070_address;
+    static constexpr size_t num_txs = 100;
+    static constexpr size_t num_holders = 10;
+    static constexpr int64_t tx_gas_limit = 200'000;
+
+    // balances: mapping(address => uint256) at slot 0.
+    const auto balance_slot = [](const bytecode& owner) {
+        return mstore(0, owner) + mstore(32, 0) + keccak256(0, 64);
+    };
+    // allowances: mapping(address => mapping(address => uint256)) at slot 1.
+    const auto allowance_slot = [](const bytecode& owner, const bytecode& spender) {
+        return mstore(0, owner) + mstore(32, 1) + keccak256(0, 64) + push(32) + OP_MSTORE +
+               mstore(0, spender) + keccak256(0, 64);
+    };
+    const auto from = calldataload(0);
+    const auto to = calldataload(32);
+    const auto allowance = allowance_slot(from, OP_CALLER);
+    const auto code = sstore(allowance, push(1) + sload(allowance) + OP_SUB) +
+                      sstore(balance_slot(from), push(1) + sload(balance_slot(from)) + OP_SUB) +
+                      sstore(balance_slot(to), add(sload(balance_slot(to)), 1));
+
+    TestState pre{{Token, {.code = code}}};
+    std::vector<state::Transaction> txs;
+    for (size_t i = 0; i < num_txs; ++i)
+    {
+        address sender{0x5e_address};
+        sender.bytes[0] = static_cast<uint8_t>(i);
+        pre[sender] = {.balance = 1};
+
+        // The call data: the ABI-encoded "from" and "to" token holders.
+        bytes data(64, 0);
+        data[31] = static_cast<uint8_t>(i % num_holders + 1);
+        data[63] = static_cast<uint8_t>((i + 1) % num_holders + 1);
+        txs.push_back({.data = data, .gas_limit = tx_gas_limit, .sender = sender, .to = Token});
+    }
+    const state::BlockInfo block{.gas_limit = static_cast<int64_t>(num_txs) * tx_gas_limit};
+    execute_block(bench_state, vm, pre, txs, block);
+}
+
+/// Executes the block of transactions, each deploying the EIP-1167 minimal proxy clone
+/// with the CREATE2 factory. The initcode and the runtime code of the clones are hashed
+/// in every transaction: the hit rate of the Keccak memo is reported.
+void clone_factory_block(State& bench_state, evmc::VM& vm)
+{
+    static constexpr auto Factory = 0xfac7_address;
+    static constexpr size_t num_txs = 100;
+    static constexpr int64_t tx_gas_limit = 200'000;
+
+    // The clone initcode is the call data. The salt is the caller, unique for every tx.
+    const auto code =
+        calldatacopy(0, 0, calldatasize()) + create2().input(0, calldatasize()).salt(OP_CALLER);
+    const auto initcode =
+        "3d602d80600a3d3981f3363d3d373d3d3d363d73bebebebebebebebebebebebebebebebebebebebe"
+        "5af43d82803e903d91602b57fd5bf3"_hex;
+
+    TestState pre{{Factory, {.code = code}}};
+    std::vector<state::Transaction> txs;
+    for (size_t i = 0; i < num_txs; ++i)
+    {
+        address sender{0x5e_address};
+        sender.bytes[0] = static_cast<uint8_t>(i);
+        pre[sender] = {.balance = 1};
+        txs.push_back(
+            {.data = initcode, .gas_limit = tx_gas_limit, .sender = sender, .to = Factory});
+    }
+    const state::BlockInfo block{.gas_limit = static_cast<int64_t>(num_txs) * tx_gas_limit};
+
+    auto& memo = state::KeccakMemo::local();
+    memo.reset_stats();
+    execute_block(bench_state, vm, pre, txs, block);
+    const auto [hits, misses] = memo.stats();
+    bench_state.counters["keccak_memo_hit_rate"] =
+        Counter(static_cast<double>(hits) / static_cast<double>(hits + misses));
+}
+}  // namespace
+
+void register_state_benchmarks()
+{
+    for (auto& [vm_name, vm] : registered_vms)
+    {
+        RegisterBenchmark(std::string{vm_name} + "/state/storage_heavy_block",
+            [&vm_ = vm](State& state) { storage_heavy_block(state, vm_); })
+            ->Unit(kMillisecond);
+        RegisterBenchmark(std::string{vm_name} + "/state/erc20_block",
+            [&vm_ = vm](State& state) { erc20_block(state, vm_); })
+            ->Unit(kMillisecond);
+        RegisterBenchmark(std::string{vm_name} + "/state/clone_factory_block",
+            [&vm_ = vm](State& state) { clone_factory_block(state, vm_); })
+            ->Unit(kMillisecond);
+    }
+
+    // Baseline with the KECCAK256 cache to compare with "baseline/state/erc20_block".
+    static evmc::VM bkcache_vm{evmc_create_evmone(), {{"keccak_cache", ""}}};
+    RegisterBenchmark("bkcache/state/erc20_block", [](State& state) {
+        erc20_block(state, bkcache_vm);
+        const auto& cache = *static_cast<evmone::VM*>(bkcache_vm.get_raw_pointer())->keccak_cache;
+        const auto [hits, misses] = cache.stats();
+        state.counters["keccak_cache_hit_rate"] =
+            Counter(static_cast<double>(hits) / static_cast<double>(hits + misses));
+    })->Unit(kMillisecond);
+}
+}  // namespace evmone::test
@@ -17,10 +17,16 @@ class BlockchainGTest : public testing::Test
 {
     fs::path m_json_test_file;
     evmc::VM& m_vm;
+    std::span<evmc::VM> m_workers;
+    bool m_recover_senders;
 
 public:
-    explicit BlockchainGTest(fs::path json_test_file, evmc::VM& vm) noexcept
-      : m_json_test_file{std::move(json_test_file)}, m_vm{vm}
+    explicit BlockchainGTest(fs::path json_test_file, evmc::VM& vm, std::span<evmc::VM> workers,
+        bool recover_senders) noexcept
+      : m_json_test_file{std::move(json_test_file)},
+        m_vm{vm},
+        m_workers{workers},
+        m_recover_senders{recover_senders}
     {}
 
     void TestBody() final
@@ -29,7 +35,8 @@ public:
 
         try
         {
-            evmone::test::run_blockchain_tests(evmone::test::load_blockchain_tests(f), m_vm);
+            evmone::test::run_blockchain_tests(
+                evmone::test::load_blockchain_tests(f), m_vm, m_workers, m_recover_senders);
         }
         catch (const evmone::test::UnsupportedTestFeature& ex)
         {
@@ -38,14 +45,18 @@ public:
     }
 };
 
-void register_test(const std::string& suite_name, const fs::path& file, evmc::VM& vm)
+void register_test(const std::string& suite_name, const fs::path& file, evmc::VM& vm,
+    std::span<evmc::VM> workers, bool recover_senders)
 {
     testing::RegisterTest(suite_name.c_str(), file.stem().string().c_str(), nullptr, nullptr,
         file.string().c_str(), 0,
-        [file, &vm]() -> testing::Test* { return new BlockchainGTest(file, vm); });
+        [file, &vm, workers, recover_senders]() -> testing::Test* {
+            return new BlockchainGTest(file, vm, workers, recover_senders);
+        });
 }
 
-void register_test_files(const fs::path& root, evmc::VM& vm)
+void register_test_files(
+    const fs::path& root, evmc::VM& vm, std::span<evmc::VM> workers, bool recover_senders)
 {
     if (is_directory(root))
     {
@@ -57,11 +68,12 @@ void register_test_files(const fs::path& root, evmc::VM& vm)
         std::sort(test_files.begin(), test_files.end());
 
         for (const auto& p : test_files)
-            register_test(fs::relative(p, root).parent_path().string(), p, vm);
+            register_test(
+                fs::relative(p, root).parent_path().string(), p, vm, workers, recover_senders);
     }
     else  // Treat as a file.
     {
-        register_test(root.parent_path().string(), root, vm);
+        register_test(root.parent_path().string(), root, vm, workers, recover_senders);
     }
 }
 }  // namespace
@@ -85,6 +97,17 @@ int main(int argc, char* argv[])
         bool trace_flag = false;
         app.add_flag("--trace", trace_flag, "Enable EVM tracing");
 
+        unsigned jobs = 1;
+        app.add_option("-j,--jobs", jobs,
+               "Number of threads executing block transactions speculatively in parallel")
+            ->check(CLI::PositiveNumber)
+            ->excludes("--trace");
+
+        bool recover_senders = false;
+        app.add_flag("--recover-senders", recover_senders,
+            "Execute transactions with the senders recovered from the signatures "
+            "and reject transactions with invalid signatures");
+
         CLI11_PARSE(app, argc, argv);
 
         evmc::VM vm{evmc_create_evmone()};
@@ -92,8 +115,16 @@ int main(int argc, char* argv[])
         if (trace_flag)
             vm.set_option("trace", "1");
 
+        std::vector<evmc::VM> workers;
+        if (jobs > 1)
+        {
+            workers.reserve(jobs);
+            for (unsigned i = 0; i < jobs; ++i)
+                workers.emplace_back(evmc_create_evmone());
+        }
+
         for (const auto& p : paths)
-            register_test_files(p, vm);
+            register_test_files(p, vm, workers, recover_senders);
 
         return RUN_ALL_TESTS();
     }
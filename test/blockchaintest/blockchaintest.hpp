@@ -70,6 +70,14 @@ struct BlockchainTest
 
 std::vector<BlockchainTest> load_blockchain_tests(std::istream& input);
 
-void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm);
+/// Runs the blockchain tests.
+///
+/// If the worker VMs are provided, the transactions of every block are first executed
+/// speculatively in parallel, one worker thread per VM.
+/// If recover_senders is set, the transactions are executed with the senders recovered
+/// from the signatures instead of the ones from the test, and the transactions with invalid
+/// signatures are rejected.
+void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm,
+    std::span<evmc::VM> workers = {}, bool recover_senders = false);
 
 }  // namespace evmone::test
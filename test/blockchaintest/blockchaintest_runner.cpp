@@ -2,8 +2,13 @@
 // Copyright 2023 The evmone Authors.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "../state/block_commitments.hpp"
+#include "../state/block_state.hpp"
 #include "../state/mpt_hash.hpp"
 #include "../state/rlp.hpp"
+#include "../state/speculative_execution.hpp"
+#include "../state/state.hpp"
+#include "../state/tx_preparation.hpp"
 #include "../test/statetest/statetest.hpp"
 #include "blockchaintest.hpp"
 #include <gtest/gtest.h>
@@ -23,17 +28,43 @@ struct TransitionResult
     std::vector<state::TransactionReceipt> receipts;
     std::vector<RejectedTransaction> rejected;
     int64_t gas_used;
-    state::BloomFilter bloom;
+    state::BlockCommitments commitments;
 };
 
 namespace
 {
-TransitionResult apply_block(TestState& state, evmc::VM& vm, const state::BlockInfo& block,
-    const std::vector<state::Transaction>& txs, evmc_revision rev,
-    std::optional<int64_t> block_reward)
+TransitionResult apply_block(TestState& state, evmc::VM& vm, std::span<evmc::VM> workers,
+    const state::BlockInfo& block, const std::vector<state::Transaction>& block_txs,
+    evmc_revision rev, std::optional<int64_t> block_reward, bool recover_senders)
 {
     system_call(state, block, rev, vm);
 
+    // Hash the transactions and, if requested, recover the senders in parallel
+    // ahead of the execution.
+    const auto num_threads = std::max(workers.size(), size_t{1});
+    auto prepared = state::prepare_transactions(block_txs, rev, recover_senders, num_threads);
+
+    // Execute the transactions with the recovered senders instead of the ones from the test.
+    std::span<const state::Transaction> txs = block_txs;
+    std::vector<state::Transaction> recovered_txs;
+    if (recover_senders)
+    {
+        recovered_txs = block_txs;
+        for (size_t i = 0; i < recovered_txs.size(); ++i)
+        {
+            if (prepared[i].sender.has_value())
+                recovered_txs[i].sender = *prepared[i].sender;
+        }
+        txs = recovered_txs;
+    }
+
+    // Verify the KZG proofs of the direct point evaluation precompile calls in a batch.
+    state::prevalidate_point_evaluations(txs, rev);
+
+    std::vector<SpeculativeTransition> speculations;
+    if (!workers.empty() && txs.size() > 1)
+        speculations = speculate(state, block, txs, rev, workers);
+
     std::vector<state::Log> txs_logs;
     int64_t block_gas_left = block.gas_limit;
     int64_t blob_gas_left = state::BlockInfo::MAX_BLOB_GAS_PER_BLOCK;
@@ -43,12 +74,39 @@ TransitionResult apply_block(TestState& state, evmc::VM& vm, const state::BlockI
 
     int64_t cumulative_gas_used = 0;
 
+    // Since Byzantium the receipts don't have the post-transaction state root.
+    // The transactions are then executed on the block-scoped state
+    // and the state is updated once with the diff of the whole block.
+    std::optional<state::BlockState> block_state;
+    if (rev >= EVMC_BYZANTIUM)
+        block_state.emplace(state);
+
     for (size_t i = 0; i < txs.size(); ++i)
     {
         const auto& tx = txs[i];
 
-        const auto computed_tx_hash = keccak256(rlp::encode(tx));
-        auto res = test::transition(state, block, tx, rev, vm, block_gas_left, blob_gas_left);
+        const auto execute =
+            [&](auto& s) -> std::variant<state::TransactionReceipt, std::error_code> {
+            if (!speculations.empty())
+            {
+                return test::transition(s, block, tx, rev, vm, block_gas_left, blob_gas_left,
+                    std::move(speculations[i]));
+            }
+            auto r = state::transition(s, block, tx, rev, vm, block_gas_left, blob_gas_left);
+            if (const auto receipt = get_if<state::TransactionReceipt>(&r))
+                s.apply(receipt->state_diff);
+            return r;
+        };
+
+        const auto& computed_tx_hash = prepared[i].hash;
+        if (recover_senders && !prepared[i].sender.has_value())
+        {
+            rejected_txs.push_back(
+                {computed_tx_hash, i, make_error_code(state::INVALID_SIGNATURE).message()});
+            continue;
+        }
+
+        auto res = block_state.has_value() ? execute(*block_state) : execute(state);
 
         if (holds_alternative<std::error_code>(res))
         {
@@ -73,10 +131,19 @@ TransitionResult apply_block(TestState& state, evmc::VM& vm, const state::BlockI
         }
     }
 
+    if (block_state.has_value())
+        state.apply(block_state->build_diff());
+
     test::finalize(state, rev, block.coinbase, block_reward, block.ommers, block.withdrawals);
 
-    const auto bloom = compute_bloom_filter(receipts);
-    return {std::move(receipts), std::move(rejected_txs), cumulative_gas_used, bloom};
+    std::vector<bytes> encoded_txs;
+    encoded_txs.reserve(prepared.size());
+    for (auto& p : prepared)
+        encoded_txs.emplace_back(std::move(p.rlp));
+    auto commitments =
+        state::compute_block_commitments(encoded_txs, receipts, block.withdrawals, num_threads);
+
+    return {std::move(receipts), std::move(rejected_txs), cumulative_gas_used, commitments};
 }
 
 std::optional<int64_t> mining_reward(evmc_revision rev) noexcept
@@ -116,7 +183,8 @@ std::string print_state(const TestState& s)
 }
 }  // namespace
 
-void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm)
+void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm,
+    std::span<evmc::VM> workers, bool recover_senders)
 {
     for (size_t case_index = 0; case_index != tests.size(); ++case_index)
     {
@@ -147,8 +215,8 @@ void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm)
 
             const auto rev = c.rev.get_revision(bi.timestamp);
 
-            const auto res =
-                apply_block(state, vm, bi, test_block.transactions, rev, mining_reward(rev));
+            const auto res = apply_block(state, vm, workers, bi, test_block.transactions, rev,
+                mining_reward(rev), recover_senders);
 
             known_block_hashes[test_block.expected_block_header.block_number] =
                 test_block.expected_block_header.hash;
@@ -160,17 +228,17 @@ void run_blockchain_tests(std::span<const BlockchainTest> tests, evmc::VM& vm)
 
             if (rev >= EVMC_SHANGHAI)
             {
-                EXPECT_EQ(state::mpt_hash(test_block.block_info.withdrawals),
+                EXPECT_EQ(res.commitments.withdrawals_root,
                     test_block.expected_block_header.withdrawal_root);
             }
 
-            EXPECT_EQ(state::mpt_hash(test_block.transactions),
+            EXPECT_EQ(res.commitments.transactions_root,
                 test_block.expected_block_header.transactions_root);
             EXPECT_EQ(
-                state::mpt_hash(res.receipts), test_block.expected_block_header.receipts_root);
+                res.commitments.receipts_root, test_block.expected_block_header.receipts_root);
             EXPECT_EQ(res.gas_used, test_block.expected_block_header.gas_used);
-            EXPECT_EQ(
-                bytes_view{res.bloom}, bytes_view{test_block.expected_block_header.logs_bloom});
+            EXPECT_EQ(bytes_view{res.commitments.logs_bloom},
+                bytes_view{test_block.expected_block_header.logs_bloom});
 
             // TODO: Add difficulty calculation verification.
         }
@@ -0,0 +1,60 @@
+// evmone-eccfuzz: LibFuzzer based differential testing of the elliptic curve arithmetic.
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone_precompiles/bn254.hpp>
+#include <evmone_precompiles/secp256k1.hpp>
+#include <cstdlib>
+
+namespace
+{
+using namespace intx;
+
+/// Checks the multiplication using the GLV endomorphism against the plain wNAF multiplication.
+template <typename MulFn, typename KindT>
+void check_mul(MulFn mul, evmmax::ecc::InvFn<uint256, KindT> inv, const uint256& field_prime,
+    const uint256& b, const evmmax::ecc::Point<uint256>& generator, const uint256& a,
+    const uint256& k) noexcept
+{
+    const evmmax::ModArith<uint256, KindT> Fp{field_prime};
+    const auto b3 = Fp.to_mont(b * 3);
+
+    // Get a valid point from the generator.
+    const auto p = mul(generator, a);
+    if (p.is_inf())
+        return;
+
+    evmmax::ecc::Point<uint256> expected;
+    if (k != 0)
+    {
+        const auto r = evmmax::ecc::mul(Fp, evmmax::ecc::to_proj(Fp, p), k, b3);
+        expected = evmmax::ecc::to_affine(Fp, inv, r);
+    }
+    if (mul(p, k) != expected)
+        std::abort();
+}
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t data_size) noexcept
+{
+    if (data_size != 1 + 2 * sizeof(uint256))
+        return -1;
+
+    const auto a = be::unsafe::load<uint256>(&data[1]);
+    const auto k = be::unsafe::load<uint256>(&data[1 + sizeof(uint256)]);
+
+    if (data[0] % 2 == 0)
+    {
+        namespace secp256k1 = evmmax::secp256k1;
+        const secp256k1::Point g{
+            0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798_u256,
+            0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8_u256};
+        check_mul(secp256k1::mul, secp256k1::field_inv, secp256k1::FieldPrime, 7, g, a, k);
+    }
+    else
+    {
+        namespace bn254 = evmmax::bn254;
+        check_mul(bn254::mul, bn254::field_inv, bn254::FieldPrime, 3, {1, 2}, a, k);
+    }
+    return 0;
+}
@@ -4,6 +4,7 @@
 
 #include <benchmark/benchmark.h>
 #include <evmmax/evmmax.hpp>
+#include <evmmax/safegcd.hpp>
 
 using namespace intx;
 
@@ -12,10 +13,13 @@ namespace
 constexpr auto bn254 = 0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47_u256;
 constexpr auto secp256k1 = 0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f_u256;
 
-template <typename UintT, const UintT& Mod>
+using evmmax::SparseModulus;
+using Secp256k1Modulus = evmmax::PseudoMersenneModulus<0x1000003d1>;
+
+template <typename UintT, const UintT& Mod, typename KindT = evmmax::GenericModulus>
 void evmmax_add(benchmark::State& state)
 {
-    const evmmax::ModArith<UintT> m{Mod};
+    const evmmax::ModArith<UintT, KindT> m{Mod};
     auto a = Mod / 2;
     auto b = Mod / 3;
 
@@ -26,10 +30,10 @@ void evmmax_add(benchmark::State& state)
     }
 }
 
-template <typename UintT, const UintT& Mod>
+template <typename UintT, const UintT& Mod, typename KindT = evmmax::GenericModulus>
 void evmmax_sub(benchmark::State& state)
 {
-    const evmmax::ModArith<UintT> m{Mod};
+    const evmmax::ModArith<UintT, KindT> m{Mod};
     auto a = Mod / 2;
     auto b = Mod / 3;
 
@@ -40,10 +44,10 @@ void evmmax_sub(benchmark::State& state)
     }
 }
 
-template <typename UintT, const UintT& Mod>
+template <typename UintT, const UintT& Mod, typename KindT = evmmax::GenericModulus>
 void evmmax_mul(benchmark::State& state)
 {
-    const evmmax::ModArith<UintT> m{Mod};
+    const evmmax::ModArith<UintT, KindT> m{Mod};
     auto a = m.to_mont(Mod / 2);
     auto b = m.to_mont(Mod / 3);
 
@@ -53,11 +57,95 @@ void evmmax_mul(benchmark::State& state)
         b = m.mul(b, a);
     }
 }
+
+template <typename UintT, const UintT& Mod, typename KindT = evmmax::GenericModulus>
+void evmmax_sqr(benchmark::State& state)
+{
+    const evmmax::ModArith<UintT, KindT> m{Mod};
+    auto a = m.to_mont(Mod / 2);
+
+    while (state.KeepRunningBatch(2))
+    {
+        a = m.sqr(a);
+        a = m.sqr(a);
+    }
+}
+
+template <const uint256& Mod, typename KindT = evmmax::GenericModulus>
+void evmmax_inv(benchmark::State& state)
+{
+    const evmmax::ModArith<uint256, KindT> m{Mod};
+    auto a = m.to_mont(Mod / 2);
+
+    while (state.KeepRunningBatch(2))
+    {
+        a = evmmax::safegcd::inv(m, a);
+        a = evmmax::safegcd::inv(m, a);
+    }
+}
+
+/// The Fermat inversion x⁻¹ = x^(p-2) in the secp256k1 field with the addition chain
+/// (255 squares, 15 multiplications) generated by github.com/mmcloughlin/addchain v0.4.0.
+/// This is the baseline for the safegcd inversion which replaced it.
+template <typename KindT>
+uint256 fermat_inv_secp256k1(const evmmax::ModArith<uint256, KindT>& m, const uint256& x) noexcept
+{
+    const auto sqr_n = [&m](uint256 t, int n) noexcept {
+        for (int i = 0; i < n; ++i)
+            t = m.sqr(t);
+        return t;
+    };
+
+    const auto _10 = m.sqr(x);
+    const auto _100 = m.sqr(_10);
+    const auto _101 = m.mul(x, _100);
+    const auto _111 = m.mul(_10, _101);
+    const auto _1110 = m.sqr(_111);
+    const auto _111111 = m.mul(_111, sqr_n(_1110, 2));
+    const auto i13 = m.mul(sqr_n(_111111, 4), _1110);
+    const auto x12 = m.mul(sqr_n(i13, 2), _111);
+    const auto x22 = m.mul(m.mul(sqr_n(x12, 10), i13), x);
+    const auto i29 = m.sqr(x22);
+    const auto i31 = sqr_n(i29, 2);
+    const auto i54 = m.mul(sqr_n(i31, 22), i31);
+    const auto i122 = m.mul(sqr_n(m.mul(sqr_n(i54, 20), i29), 46), i54);
+    const auto x223 = m.mul(m.mul(sqr_n(i122, 110), i122), _111);
+    const auto i269 = sqr_n(m.mul(sqr_n(m.mul(sqr_n(x223, 23), x22), 7), _101), 3);
+    return m.mul(_101, i269);
+}
+
+template <typename KindT = evmmax::GenericModulus>
+void evmmax_inv_fermat_secp256k1(benchmark::State& state)
+{
+    const evmmax::ModArith<uint256, KindT> m{secp256k1};
+    auto a = m.to_mont(secp256k1 / 2);
+
+    while (state.KeepRunningBatch(2))
+    {
+        a = fermat_inv_secp256k1(m, a);
+        a = fermat_inv_secp256k1(m, a);
+    }
+}
 }  // namespace
 
 BENCHMARK_TEMPLATE(evmmax_add, uint256, bn254);
+BENCHMARK_TEMPLATE(evmmax_add, uint256, bn254, SparseModulus);
 BENCHMARK_TEMPLATE(evmmax_add, uint256, secp256k1);
+BENCHMARK_TEMPLATE(evmmax_add, uint256, secp256k1, Secp256k1Modulus);
 BENCHMARK_TEMPLATE(evmmax_sub, uint256, bn254);
+BENCHMARK_TEMPLATE(evmmax_sub, uint256, bn254, SparseModulus);
 BENCHMARK_TEMPLATE(evmmax_sub, uint256, secp256k1);
+BENCHMARK_TEMPLATE(evmmax_sub, uint256, secp256k1, Secp256k1Modulus);
 BENCHMARK_TEMPLATE(evmmax_mul, uint256, bn254);
+BENCHMARK_TEMPLATE(evmmax_mul, uint256, bn254, SparseModulus);
 BENCHMARK_TEMPLATE(evmmax_mul, uint256, secp256k1);
+BENCHMARK_TEMPLATE(evmmax_mul, uint256, secp256k1, Secp256k1Modulus);
+BENCHMARK_TEMPLATE(evmmax_sqr, uint256, bn254);
+BENCHMARK_TEMPLATE(evmmax_sqr, uint256, bn254, SparseModulus);
+BENCHMARK_TEMPLATE(evmmax_sqr, uint256, secp256k1);
+BENCHMARK_TEMPLATE(evmmax_sqr, uint256, secp256k1, Secp256k1Modulus);
+BENCHMARK_TEMPLATE(evmmax_inv, bn254, SparseModulus);
+BENCHMARK_TEMPLATE(evmmax_inv, secp256k1);
+BENCHMARK_TEMPLATE(evmmax_inv, secp256k1, Secp256k1Modulus);
+BENCHMARK_TEMPLATE(evmmax_inv_fermat_secp256k1, evmmax::GenericModulus);
+BENCHMARK_TEMPLATE(evmmax_inv_fermat_secp256k1, Secp256k1Modulus);
@@ -4,9 +4,14 @@
 
 #include "../utils/utils.hpp"
 #include <benchmark/benchmark.h>
+#include <evmone_precompiles/bls.hpp>
+#include <evmone_precompiles/kzg.hpp>
+#include <evmone_precompiles/secp256k1.hpp>
 #include <state/precompiles.hpp>
 #include <state/precompiles_internal.hpp>
 #include <array>
+#include <cassert>
+#include <cstring>
 #include <memory>
 
 #ifdef EVMONE_PRECOMPILES_SILKPRE
@@ -28,13 +33,19 @@ constexpr auto analyze<PrecompileId::identity> = identity_analyze;
 template <>
 constexpr auto analyze<PrecompileId::ecrecover> = ecrecover_analyze;
 template <>
+constexpr auto analyze<PrecompileId::expmod> = expmod_analyze;
+template <>
 constexpr auto analyze<PrecompileId::ecadd> = ecadd_analyze;
 template <>
 constexpr auto analyze<PrecompileId::ecmul> = ecmul_analyze;
 template <>
-[[maybe_unused]] constexpr auto analyze<PrecompileId::ecpairing> = ecpairing_analyze;
+constexpr auto analyze<PrecompileId::ecpairing> = ecpairing_analyze;
 template <>
 constexpr auto analyze<PrecompileId::point_evaluation> = point_evaluation_analyze;
+template <>
+constexpr auto analyze<PrecompileId::bls12_g1msm> = bls12_g1msm_analyze;
+template <>
+constexpr auto analyze<PrecompileId::bls12_g2msm> = bls12_g2msm_analyze;
 
 template <PrecompileId>
 const inline std::array inputs{0};
@@ -104,6 +115,18 @@ const inline std::array inputs<PrecompileId::ecmul>{
     "30543adffffd27f2c512df127e6bbf0463986e439ba55bbd668ca5ae649c3de71525e19d26d342eaa4201d3311cbea20aea70c6293823d58f69bc154a672dd7a18089d4e577b2312bc6b0fdf414b55a27f85eda857c40ccbf6aee4eda308b6ee"_hex,
 };
 
+template <>
+const inline std::array inputs<PrecompileId::expmod>{
+    // Odd moduli of 256, 512, 1024, 2048 and 4096 bits and an even modulus of 1024 bits,
+    // all with 256-bit exponents.
+    "0000000000000000000000000000000000000000000000000000000000000020000000000000000000000000000000000000000000000000000000000000002000000000000000000000000000000000000000000000000000000000000000202ebd16556e8b973f328aefad4a79328787c0d9f60d93bb5174e775817a748114889702f27cf8b9b099cf3b9907f8f793c295a531d357886c6245fe76e8337761fcda9f0bbe7a30bdabb09c6119d2ee9c7b00b455b622fd3f928a1a030d9001eb"_hex,
+    "0000000000000000000000000000000000000000000000000000000000000040000000000000000000000000000000000000000000000000000000000000002000000000000000000000000000000000000000000000000000000000000000405cf1e412d17067d579f3e3a348af8df9ea96b89d1cda9d7e20f33a1e6be5ca906ffbe28bbdab9cf481bb4dc831daff528b7b136c6405e9f0388f6834ae268848c8a9ac17f4aeb19cf1641fce3af89e6d0c379dfeb1c8693952f857c860e70a8c98619945fd12ea210e69ad85adb34db1ee2aedff19aef1c49ac6ff0f9ec8cf413c1430dd5364b18040c7202c56e7530497f8416ec1384c9194716078e6edea37"_hex,
+    "000000000000000000000000000000000000000000000000000000000000008000000000000000000000000000000000000000000000000000000000000000200000000000000000000000000000000000000000000000000000000000000080187489076766a8198d9965119ac393fceeca0b57cb06373e180f52961d05b4c5e832126cb882eb76b112bd3db13a25f8da4f2f80caad3368914e58f6a56a074a209a9e031b559fb7bdff8a37395156389468b0b90607d55623f503d946136bbf7442c83f2ea793ba884284db63eabd2af496e8ad032d379bf2981677a0808181c51b99a3bb1446cfe766f95396c25c199d085ba8100ac82aa0ca46bd50bbcbe881e8f0300a243a1b9c256bedc4da27f92643e0a5972664513506460bdf2f59f86e299f18de0379a01a9d9bc0fef814236120fdaf560985e93ac607b173e6c0abaaa7b9e955b78a75cebded1c7cb34138276afc3c9b8eec487e501e915fa08b708575448ae20c309de0a58a223b945b2b6a65fbe20e642284110e1b5b3340320b"_hex,
+    "0000000000000000000000000000000000000000000000000000000000000100000000000000000000000000000000000000000000000000000000000000002000000000000000000000000000000000000000000000000000000000000001005922f39fa4cc245bae54472e4861da9b136965788ae2107cea01c91377cae371f8c93fd0187de2a912ec272c80696386ffa10ccabec5f22531f0321ac82d64a495ed0b693015ee0f34c9c2de929234510e7d0ef84004dbdb1edf3aa374504b832b8b3cb17cfe3e0bf4a6dfc3be0bc8c57a41547f43408d5bcd714213503a2f782b1876f2c47778f3dc22a388018e0bec28134f68cd8bc59523e82705282410eae3be11bc1ee7621e5110c0c570157ef572540ed18124d52b41baf7dba764ec822fa490b5e9992693b919632494e5f141d5dca1913634ef26f819af039ea66a605ad71cad7bd82a90331405dbbf71acc26dffb4cbf400fda7f443dee2430f0885a928289549ee762126087c327914652523b79c22afe216b5b52884feda2c0e01913cb8e6fb964746a0a54a34800f9934fc7eba6165fbb752fd0a8d4388d77d5926a2e08f7dfa9ab04ebe7e6967f1632692fd18384ff74baa9e3dc0e620ece6d9e4eb0a3c8cbe0d274d21db1e388151a2f53f4b280bc3da1ac5e67ec03543b0a3ed938d67db2f87c9f1d4c3c8583c8841086277ed59a6d4f284c2f5653a24ef191a55f93c5fde47c5d9ffc8ca630af56d426f465b4aa1a0cdfc75dae57a8851f57ff217c0351720fa593ff0e0580c4ee421adb2da83b3ed010f70f467ab7324108b54ffe9b25d8ff5950f61775de8da5603e7243a6cbb594cf03cbaa5e27d3a53557f4596fc305ebcdd6e51be2bd86ca6712a7756e32a99141e57a6955d2688d7"_hex,
+    "000000000000000000000000000000000000000000000000000000000000020000000000000000000000000000000000000000000000000000000000000000200000000000000000000000000000000000000000000000000000000000000200f1a2aa3ae1a11d3a2e153185922c49c03c5c10d818a46b3c15db49230effce2ddea00bf44731f4bde5e0294d462cb54befad3b9135717edf48398a402125db68a78c6205a86d755e006f22ac0921ab7150b2a7465087b1be2f86167511e9468b4df7f57b3cffb935397c3037ccc6958bd78c35ccebe8b880c4c8057403e721c7e7e58708a4a319ae378eec6f3c38cbc950c28e968ca438f335474aae5c7da3943cbd77731c61b9c8b64741597986edec5b5d0e818f3cb0cff31d2e5d8df25dcde7cf1b62949ba9a70650a05d4df41b5168aeec68135df86eca13fa266085daf00694130bca96593fa73e9700b4ec52b8f6df32c83980d4dbcffe52e7066e71ebd34bb3594900c2c0842958a18083f3df593905c12276fea0aaed5ae9bca3883375b04fdcf920c5d2264463e97b49d171ff066ae53e2f226755836cb37c61b60f5a2ffa3a7751aa0bedf35cae1cd841b1fca524af0988457541d19a626311be59049ec2698d98b7f8240fa574a5806ac88a19587709663bfe497500841c5dcd0870959e1cfddf6069cda84aad7f5df15ad27990a3c648458ecaeec56631c4ad438f13e11b4d97043989142f4edc8a96c3d5ab40ffcb341fa59ec8e608ef7cf0565acda4b06431303e3e11f582715b9ce6c376b675e25943ffd952add116d67920815d262de0527675b6db6a3134858be580fbc821f0b1952753a7c2b712ba96efe79c144410c9800050af8ce261646323c227af12f8db9ad5b09b62d969908f7aaa845df38eb7d50457eb0757114e2b8f85d401a368f5b54e0caab9800c47c432c4241bf1df43bf4ba5a99970a4123a49c650cd1b4a4b2811177b76b4da0e83b3f1c795ef6b3fdddea422cc13b6f3b0da6da6fb0a1f0a507607b6f7d97f0da23298c990638f66828a11f10777d3fcecd6bc215149f62d28aecce2c94359c93cb2338b4b883ac824e0d7e380009e78760efada3203c31ea1752b3a520218bb0539bacf5a73de7c0db540fb5e3262a09c18a6e14cb9167811d3d9a14edc9b803befd48b22c52da0e2d3a3064fde2ad458213a0f9585306e942ec7159a6d0e6e6a6359eeb1bced1335e9999e9d903911103576942ac6da702d1bd104818b162c2cdb464f5946bc55ae2c2eab25459c7b04850fb76bcb159b0ee8967f942077ff6b7c02e21b12765848c14f1b107ce0f19de96e166ce227ae61052c7a3604360bd43cac029e50993af02257a31fe60cb8a17e9013159cb9b8f775116b368917303932f00261d328ac8d39603d5088a31f80695ed3560e57410dacfc4459ef6c5caae8cb931b702e3cc8924a57b658716b9876ba61fd202e6a7dec426d1dff86f5dee35ce1fadf3ef2e2c7aba2bf64030b70045e5628d9c5df1f3dd1400964b278e95e4fefcd33ee486ce915dfcf8f7065f887d8575589cd6e24e35c14f86211bf593cf3503b4f35ebc05687b0bce10466f26ec7d957903d2321208f0b7c644e8c6853"_hex,
+    "000000000000000000000000000000000000000000000000000000000000008000000000000000000000000000000000000000000000000000000000000000200000000000000000000000000000000000000000000000000000000000000080881469d29d19cb64a67f0422c21427213fbdd2bb4f92a6830b547c3c4f8b9a5f2897ec908b58aa8bd2b90e2ccfe1bc5f62a005e6ea1fb21a908dc0bec4896f6d0ab2f50b606b01cd7a60c577c16c2e5ff01b3b0e887ad0e8d83e5083956d0546751097ee133930462e8bc1a51afc65ef250a8ce1d28613844065ce0aba5fa75bb4a42d1726728a49756a8c13d61f5a0cef0f74bb1805f6857814fbcbb1300058c4457749fd04bd6e962dcba32d2f8fae7826bb77b812f0979d92a62446bc5979876c2131517a0be410b181392e5b13b6f05293b45eae3298d62a374d58bb47e63e951f504de75f253fdb79a4fea05f8e2aeb4107a7f7e7d2af1e1d7a7441b0f450af3c862a4c07d37c7b7194bdacf4f8217e41b3244bf82eaa0b3e07af25a000"_hex,
+};
+
 template <>
 const inline std::array inputs<PrecompileId::ecpairing>{
     "07ef2650307493a16aca9e26a19d6743fff6625c3d8e54d72066927275b5f1eb0e1c313e3efebda72ff799f0290c8da3ddde69186bd55847394e2aad3c0116410055091d6ff0c5409deb107db7771636f49a4f35b8fd67b521529cf750bfd30d25bbf84313e421938a91a38cc2a6ec95231804b8bf4beee4fe918dcff2c62cfb2e7ef6b31b4bed556d3ae77b6bbc156b145d1a8c3589c3d62e3fa3aecb968bb5260c78f7e4f3da71284d1d94afb6f4baed9a897e3713952cd4f94870a43d8ea8"_hex
@@ -178,12 +201,42 @@ namespace bench_ecrecovery
 {
 constexpr auto evmmax_cpp = ecrecover_execute;
 BENCHMARK_TEMPLATE(precompile, PrecompileId::ecrecover, evmmax_cpp);
+
+/// Benchmarks evmmax::secp256k1::ecrecover_batch() for all the ecrecover inputs at once.
+void evmmax_cpp_batch(benchmark::State& state)
+{
+    std::vector<evmmax::secp256k1::EcrecoverInput> batch;
+    for (const auto& input : inputs<PrecompileId::ecrecover>)
+    {
+        uint8_t buffer[128]{};
+        std::memcpy(buffer, input.data(), std::min(input.size(), std::size(buffer)));
+        auto& in = batch.emplace_back();
+        std::memcpy(in.hash.bytes, buffer, sizeof(in.hash));
+        in.v = intx::be::unsafe::load<intx::uint256>(&buffer[32]) == 28;
+        in.r = intx::be::unsafe::load<intx::uint256>(&buffer[64]);
+        in.s = intx::be::unsafe::load<intx::uint256>(&buffer[96]);
+    }
+
+    while (state.KeepRunningBatch(static_cast<benchmark::IterationCount>(batch.size())))
+        benchmark::DoNotOptimize(evmmax::secp256k1::ecrecover_batch(batch));
+}
+BENCHMARK(evmmax_cpp_batch);
 #ifdef EVMONE_PRECOMPILES_SILKPRE
 constexpr auto libsecp256k1 = silkpre_ecrecover_execute;
 BENCHMARK_TEMPLATE(precompile, PrecompileId::ecrecover, libsecp256k1);
 #endif
 }  // namespace bench_ecrecovery
 
+namespace bench_expmod
+{
+constexpr auto evmmax_cpp = expmod_execute;
+BENCHMARK_TEMPLATE(precompile, PrecompileId::expmod, evmmax_cpp);
+#ifdef EVMONE_PRECOMPILES_SILKPRE
+constexpr auto silkpre = silkpre_expmod_execute;
+BENCHMARK_TEMPLATE(precompile, PrecompileId::expmod, silkpre);
+#endif
+}  // namespace bench_expmod
+
 namespace bench_ecadd
 {
 constexpr auto evmmax_cpp = ecadd_execute;
@@ -206,6 +259,8 @@ BENCHMARK_TEMPLATE(precompile, PrecompileId::ecmul, libff);
 
 namespace bench_ecpairing
 {
+constexpr auto evmmax_cpp = ecpairing_execute;
+BENCHMARK_TEMPLATE(precompile, PrecompileId::ecpairing, evmmax_cpp);
 #ifdef EVMONE_PRECOMPILES_SILKPRE
 constexpr auto libff = silkpre_ecpairing_execute;
 BENCHMARK_TEMPLATE(precompile, PrecompileId::ecpairing, libff);
@@ -216,8 +271,127 @@ namespace bench_kzg
 {
 constexpr auto evmone_blst = point_evaluation_execute;
 BENCHMARK_TEMPLATE(precompile, PrecompileId::point_evaluation, evmone_blst);
+
+/// Benchmarks evmone::crypto::kzg_verify_proof_batch() for all the point evaluation inputs at once.
+void evmone_blst_batch(benchmark::State& state)
+{
+    std::vector<evmone::crypto::KZGProofInput> batch;
+    for (const auto& input : inputs<PrecompileId::point_evaluation>)
+    {
+        assert(input.size() == sizeof(evmone::crypto::KZGProofInput));
+        std::memcpy(&batch.emplace_back(), input.data(), input.size());
+    }
+
+    while (state.KeepRunningBatch(static_cast<benchmark::IterationCount>(batch.size())))
+    {
+        if (!evmone::crypto::kzg_verify_proof_batch(batch)) [[unlikely]]
+        {
+            state.SkipWithError("invalid result");
+            return;
+        }
+    }
+}
+BENCHMARK(evmone_blst_batch);
 }  // namespace bench_kzg
 
+namespace bench_bls
+{
+/// The encoded generators of the BLS12-381 G1 and G2 groups.
+const auto G1 =
+    "0000000000000000000000000000000017f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb0000000000000000000000000000000008b3f481e3aaa0f1a09e30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1"_hex;
+const auto G2 =
+    "00000000000000000000000000000000024aa2b2f08f0a91260805272dc51051c6e47ad4fa403b02b4510b647ae3d1770bac0326a805bbefd48056c8c121bdb80000000000000000000000000000000013e02b6052719f607dacd3a088274f65596bd0d09920b61ab5da61bbdc7f5049334cf11213945d57e5ac7d055d042b7e000000000000000000000000000000000ce5d527727d6e118cc9cdc6da2e351aadfd9baa8cbdd3a76d429a695160d12c923ac9cc3baca289e193548608b82801000000000000000000000000000000000606c4a02ea734cc32acd2b02bc28b99cb3e287e85a763af267492ab572e99ab3f370d275cec1da1aaa9075ff05f79be"_hex;
+
+/// Creates the MSM input of the n distinct points [i+1]G with the pseudo-random scalars.
+bytes msm_input(PrecompileId id, size_t n)
+{
+    const auto& g = id == PrecompileId::bls12_g1msm ? G1 : G2;
+    const auto point_size = g.size();
+    const auto mul = id == PrecompileId::bls12_g1msm ? evmone::crypto::bls::g1_mul :
+                                                       evmone::crypto::bls::g2_mul;
+
+    bytes input;
+    uint64_t seed = 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint8_t factor[32]{};
+        intx::be::unsafe::store(factor, intx::uint256{i + 1});
+        uint8_t point[256];
+        [[maybe_unused]] const auto ok =
+            mul(point, &point[point_size / 2], g.data(), &g[point_size / 2], factor);
+        assert(ok);
+        input.append(point, point_size);
+
+        for (size_t j = 0; j < 32; ++j)
+        {
+            seed = seed * 6364136223846793005 + 1442695040888963407;  // LCG from PCG.
+            input.push_back(static_cast<uint8_t>(seed >> 56));
+        }
+    }
+    return input;
+}
+
+/// Benchmarks the MSM precompile for the number of points given as the argument.
+template <PrecompileId Id, ExecuteFn Fn>
+void msm(benchmark::State& state)
+{
+    const auto input = msm_input(Id, static_cast<size_t>(state.range(0)));
+    const auto [gas_cost, max_output_size] = analyze<Id>(input, EVMC_LATEST_STABLE_REVISION);
+    const auto output = std::make_unique_for_overwrite<uint8_t[]>(max_output_size);
+
+    for ([[maybe_unused]] auto _ : state)
+    {
+        const auto r = Fn(input.data(), input.size(), output.get(), max_output_size);
+        if (r.status_code != EVMC_SUCCESS) [[unlikely]]
+        {
+            state.SkipWithError("invalid result");
+            return;
+        }
+    }
+
+    using benchmark::Counter;
+    state.counters["gas_used"] = Counter(static_cast<double>(gas_cost));
+    state.counters["gas_rate"] = Counter(
+        static_cast<double>(gas_cost) * static_cast<double>(state.iterations()), Counter::kIsRate);
+}
+
+constexpr auto evmone_blst_g1 = bls12_g1msm_execute;
+BENCHMARK_TEMPLATE(msm, PrecompileId::bls12_g1msm, evmone_blst_g1)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128)
+    ->Arg(512);
+constexpr auto evmone_blst_g2 = bls12_g2msm_execute;
+BENCHMARK_TEMPLATE(msm, PrecompileId::bls12_g2msm, evmone_blst_g2)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(128)
+    ->Arg(512);
+
+/// The MSM with the computation split between 4 threads. The precompiles use only the calling one.
+template <size_t PointSize, auto MsmFn>
+ExecutionResult msm_4_threads(
+    const uint8_t* input, size_t input_size, uint8_t* output, size_t /*output_size*/) noexcept
+{
+    if (!MsmFn(output, &output[PointSize / 2], input, input_size, 4))
+        return {EVMC_PRECOMPILE_FAILURE, 0};
+    return {EVMC_SUCCESS, PointSize};
+}
+
+constexpr auto evmone_blst_g1_4_threads = msm_4_threads<128, evmone::crypto::bls::g1_msm>;
+BENCHMARK_TEMPLATE(msm, PrecompileId::bls12_g1msm, evmone_blst_g1_4_threads)
+    ->Arg(32)
+    ->Arg(128)
+    ->Arg(512);
+constexpr auto evmone_blst_g2_4_threads = msm_4_threads<256, evmone::crypto::bls::g2_msm>;
+BENCHMARK_TEMPLATE(msm, PrecompileId::bls12_g2msm, evmone_blst_g2_4_threads)
+    ->Arg(32)
+    ->Arg(128)
+    ->Arg(512);
+}  // namespace bench_bls
+
 }  // namespace
 
 BENCHMARK_MAIN();
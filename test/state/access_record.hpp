@@ -0,0 +1,38 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <evmc/evmc.hpp>
+#include <set>
+
+namespace evmone::state
+{
+using evmc::address;
+using evmc::bytes32;
+
+/// The record of the state accessed by a transaction.
+///
+/// It is collected by the Host during the transaction execution, if requested
+/// in state::transition(). It is meant to be the input for conflict detection between
+/// transactions, warming state caches and generating EIP-2930 access lists.
+struct AccessRecord
+{
+    /// The accounts read, including the non-existing ones.
+    std::set<address> accounts_read;
+
+    /// The accounts modified, touched, created or destructed.
+    /// This may include accounts which modifications have been reverted.
+    std::set<address> accounts_written;
+
+    /// The storage entries read.
+    std::set<std::pair<address, bytes32>> storage_read;
+
+    /// The storage entries modified.
+    /// This may include entries which modifications have been reverted.
+    std::set<std::pair<address, bytes32>> storage_written;
+
+    /// The accounts which code has been loaded.
+    std::set<address> code_loaded;
+};
+}  // namespace evmone::state
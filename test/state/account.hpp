@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "code_store.hpp"
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
 #include <unordered_map>
@@ -53,11 +54,11 @@ struct Account
     /// The EIP-1153 transient (transaction-level lifetime) storage.
     std::unordered_map<bytes32, bytes32> transient_storage;
 
-    /// The cache of the account code.
+    /// The account code, shared with the other accounts having the same code.
     ///
     /// Check code_hash to know if an account code is empty.
-    /// Empty here only means it has not been loaded from the initial storage.
-    bytes code;
+    /// Null here only means it has not been loaded from the initial storage.
+    std::shared_ptr<const CodeStore::Entry> code;
 
     /// The account has been destructed and should be erased at the end of a transaction.
     bool destructed = false;
@@ -0,0 +1,74 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "block_commitments.hpp"
+#include "mpt_hash.hpp"
+#include "parallel_for.hpp"
+#include "rlp.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+namespace evmone::state
+{
+namespace
+{
+/// The number of receipts encoded by a single task.
+constexpr size_t RECEIPTS_CHUNK_SIZE = 64;
+
+/// The minimum number of receipts for computing the commitments in parallel.
+/// The commitments of smaller blocks are computed faster than the threads are started.
+constexpr size_t PARALLEL_MIN_RECEIPTS = 128;
+}  // namespace
+
+BlockCommitments compute_block_commitments(std::span<const bytes> encoded_txs,
+    std::span<const TransactionReceipt> receipts, std::span<const Withdrawal> withdrawals,
+    size_t num_threads)
+{
+    if (receipts.size() < PARALLEL_MIN_RECEIPTS)
+        num_threads = 1;
+
+    const auto num_chunks = (receipts.size() + RECEIPTS_CHUNK_SIZE - 1) / RECEIPTS_CHUNK_SIZE;
+    std::vector<bytes> encoded_receipts(receipts.size());
+    std::vector<BloomFilter> chunk_blooms(num_chunks);
+    std::atomic<size_t> chunks_left = num_chunks;
+
+    BlockCommitments c;
+    const auto commit_receipts = [&] {
+        for (const auto& bloom : chunk_blooms)
+        {
+            std::transform(std::begin(c.logs_bloom.bytes), std::end(c.logs_bloom.bytes),
+                bloom.bytes, c.logs_bloom.bytes, std::bit_or<>());
+        }
+        c.receipts_root = mpt_hash_encoded(encoded_receipts);
+    };
+
+    // The tasks: the transactions trie, the withdrawals trie and the chunks of receipts.
+    // The receipts are encoded and their blooms combined per chunk. The thread finishing
+    // the last chunk builds the receipts trie while the others build the remaining tries.
+    parallel_for(2 + num_chunks, num_threads, [&](size_t t) {
+        if (t == 0)
+            c.transactions_root = mpt_hash_encoded(encoded_txs);
+        else if (t == 1)
+            c.withdrawals_root = mpt_hash(withdrawals);
+        else
+        {
+            const auto chunk = t - 2;
+            const auto offset = chunk * RECEIPTS_CHUNK_SIZE;
+            const auto chunk_receipts =
+                receipts.subspan(offset, std::min(RECEIPTS_CHUNK_SIZE, receipts.size() - offset));
+            for (size_t i = 0; i < chunk_receipts.size(); ++i)
+                encoded_receipts[offset + i] = rlp::encode(chunk_receipts[i]);
+            chunk_blooms[chunk] = compute_bloom_filter(chunk_receipts);
+
+            if (chunks_left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                commit_receipts();
+        }
+    });
+    if (num_chunks == 0)
+        commit_receipts();
+
+    return c;
+}
+}  // namespace evmone::state
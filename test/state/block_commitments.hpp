@@ -0,0 +1,32 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "block.hpp"
+#include "bloom_filter.hpp"
+#include "transaction.hpp"
+#include <span>
+
+namespace evmone::state
+{
+/// The block header values committing to the block body and to the transactions execution results.
+struct BlockCommitments
+{
+    hash256 transactions_root;
+    hash256 receipts_root;
+    hash256 withdrawals_root;
+    BloomFilter logs_bloom;
+};
+
+/// Computes the block commitments after the block execution.
+///
+/// The transactions are given already RLP-encoded (see prepare_transactions()).
+/// The receipts are encoded in parallel, then the tries are built concurrently.
+/// The logs bloom is the OR of the receipts' bloom filters.
+/// The work is done by num_threads threads (including the calling one),
+/// but the commitments of small blocks are computed by the calling thread only.
+[[nodiscard]] BlockCommitments compute_block_commitments(std::span<const bytes> encoded_txs,
+    std::span<const TransactionReceipt> receipts, std::span<const Withdrawal> withdrawals,
+    size_t num_threads);
+}  // namespace evmone::state
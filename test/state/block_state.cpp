@@ -0,0 +1,110 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "block_state.hpp"
+#include "account.hpp"
+#include "hash_utils.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace evmone::state
+{
+namespace
+{
+constexpr auto EMPTY_CODE_HASH = Account::EMPTY_CODE_HASH;
+}  // namespace
+
+BlockState::Entry& BlockState::load(const address& addr) const
+{
+    const auto [it, inserted] = m_entries.try_emplace(addr);
+    if (inserted)
+        it->second.account = m_base.get_account(addr);
+    return it->second;
+}
+
+void BlockState::apply(const StateDiff& diff)
+{
+    // The deletions go first: an account can be deleted and then created again.
+    for (const auto& addr : diff.deleted_accounts)
+        m_entries[addr] = {.code = bytes{}, .deleted = true};
+
+    for (const auto& m : diff.modified_accounts)
+    {
+        auto& e = load(m.addr);
+        auto code_hash = e.account.has_value() ? e.account->code_hash : EMPTY_CODE_HASH;
+        if (!m.code.empty())
+        {
+            code_hash = keccak256(m.code);
+            e.code = m.code;
+            e.code_modified = true;
+        }
+
+        // The storage is modified only by the account's code so an account with storage
+        // is never empty. Therefore, it doesn't matter that has_storage is conservatively
+        // left set when all the entries get deleted.
+        const auto has_storage = (e.account.has_value() && e.account->has_storage) ||
+                                 std::ranges::any_of(m.modified_storage,
+                                     [](const auto& kv) noexcept { return !is_zero(kv.second); });
+        e.account = Account{m.nonce, m.balance, code_hash, has_storage};
+
+        for (const auto& [k, v] : m.modified_storage)
+            e.storage.insert_or_assign(k, StorageEntry{v, true});
+        e.modified = true;
+    }
+}
+
+StateDiff BlockState::build_diff() const
+{
+    StateDiff diff;
+    for (const auto& [addr, e] : m_entries)
+    {
+        if (e.deleted)
+            diff.deleted_accounts.emplace_back(addr);
+        if (!e.modified)
+            continue;
+
+        assert(e.account.has_value());
+        // NOLINTNEXTLINE(modernize-use-emplace)
+        auto& a = diff.modified_accounts.emplace_back(
+            StateDiff::Entry{addr, e.account->nonce, e.account->balance});
+        if (e.code_modified)
+            a.code = *e.code;
+        for (const auto& [k, s] : e.storage)
+        {
+            if (s.modified)
+                a.modified_storage.emplace_back(k, s.value);
+        }
+    }
+    return diff;
+}
+
+std::optional<StateView::Account> BlockState::get_account(const address& addr) const noexcept
+{
+    return load(addr).account;
+}
+
+bytes BlockState::get_account_code(const address& addr) const noexcept
+{
+    auto& e = load(addr);
+    if (!e.code.has_value())
+    {
+        e.code = (e.account.has_value() && e.account->code_hash != EMPTY_CODE_HASH) ?
+                     m_base.get_account_code(addr) :
+                     bytes{};
+    }
+    return *e.code;
+}
+
+bytes32 BlockState::get_storage(const address& addr, const bytes32& key) const noexcept
+{
+    auto& e = load(addr);
+    if (const auto it = e.storage.find(key); it != e.storage.end())
+        return it->second.value;
+    if (!e.account.has_value() || e.deleted)
+        return {};
+    const auto value = m_base.get_storage(addr, key);
+    e.storage.try_emplace(key, StorageEntry{value});
+    return value;
+}
+}  // namespace evmone::state
@@ -0,0 +1,78 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "state_diff.hpp"
+#include "state_view.hpp"
+#include <unordered_map>
+
+namespace evmone::state
+{
+/// The block-scoped state: the view of the state during the execution of a block.
+///
+/// It keeps the accounts, code and storage entries read from the underlying state
+/// and the changes made by the transactions of the block. Therefore, the transactions
+/// don't fetch the same data from the underlying state again and the underlying state
+/// is updated only once, with the merged diff of the whole block.
+///
+/// The data is cached also in the const getters. They must not be called concurrently.
+class BlockState : public StateView
+{
+    /// The cached storage entry.
+    struct StorageEntry
+    {
+        bytes32 value;
+
+        /// The entry has been modified in the block.
+        bool modified = false;
+    };
+
+    /// The account loaded or modified in the block.
+    struct Entry
+    {
+        /// The account, nullopt if it doesn't exist.
+        std::optional<Account> account;
+
+        /// The account code, nullopt if not loaded yet.
+        std::optional<bytes> code;
+
+        /// The loaded and modified storage entries.
+        std::unordered_map<bytes32, StorageEntry> storage;
+
+        /// The account has been deleted in the block (and possibly created again).
+        /// Its storage in the underlying state is not accessible any more.
+        bool deleted = false;
+
+        /// The account has been modified in the block (after the last deletion).
+        bool modified = false;
+
+        /// The account code has been set in the block.
+        bool code_modified = false;
+    };
+
+    /// The underlying state, i.e. the state before the block.
+    const StateView& m_base;
+
+    /// The accounts loaded or modified: address => entry.
+    mutable std::unordered_map<address, Entry> m_entries;
+
+    Entry& load(const address& addr) const;
+
+public:
+    explicit BlockState(const StateView& base) noexcept : m_base{base} {}
+
+    /// Applies the state changes, e.g. of the transaction just executed on this state.
+    void apply(const StateDiff& diff);
+
+    /// Builds the diff of all the changes applied since the beginning of the block.
+    [[nodiscard]] StateDiff build_diff() const;
+
+    std::optional<Account> get_account(const address& addr) const noexcept override;
+    bytes get_account_code(const address& addr) const noexcept override;
+    bytes32 get_storage(const address& addr, const bytes32& key) const noexcept override;
+
+    /// Returns the code store of the underlying state.
+    CodeStore* code_store() const noexcept override { return m_base.code_store(); }
+};
+}  // namespace evmone::state
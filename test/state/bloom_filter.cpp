@@ -4,19 +4,18 @@
 
 #include "bloom_filter.hpp"
 #include "transaction.hpp"
+#include <algorithm>
 
 namespace evmone::state
 {
 
 namespace
 {
-/// Adds an entry to the bloom filter.
+/// Adds an entry to the bloom filter given the hash of the entry.
 /// based on
 /// https://ethereum.github.io/execution-specs/autoapi/ethereum/shanghai/bloom/index.html#add-to-bloom
-inline void add_to(BloomFilter& bf, const bytes_view& entry)
+inline void add_to(BloomFilter& bf, const hash256& hash) noexcept
 {
-    const auto hash = keccak256(entry);
-
     // take the least significant 11-bits of the first three 16-bit values
     for (const auto i : {0, 2, 4})
     {
@@ -30,16 +29,27 @@ inline void add_to(BloomFilter& bf, const bytes_view& entry)
 
 }  // namespace
 
-BloomFilter compute_bloom_filter(std::span<const Log> logs) noexcept
+BloomFilter compute_bloom_filter(std::span<const Log> logs)
 {
-    BloomFilter res;
+    // Gather all the entries first. The logs often share the emitting contract address
+    // and the event signature (the first topic) so the duplicates are removed
+    // before hashing. The bloom filter doesn't depend on the order of the entries.
+    std::vector<bytes_view> entries;
     for (const auto& log : logs)
     {
-        add_to(res, log.addr);
-        for (const auto& topic : log.topics)
-            add_to(res, topic);
+        entries.emplace_back(log.addr);
+        entries.insert(entries.end(), log.topics.begin(), log.topics.end());
     }
+    std::ranges::sort(entries);
+    const auto [last, _] = std::ranges::unique(entries);
+    entries.erase(last, entries.end());
 
+    std::vector<hash256> hashes(entries.size());
+    keccak256_batch(hashes, entries);
+
+    BloomFilter res;
+    for (const auto& hash : hashes)
+        add_to(res, hash);
     return res;
 }
 
@@ -23,7 +23,7 @@ struct BloomFilter
 
 /// Computes combined bloom fitter for set of logs.
 /// It's used to compute bloom filter for single transaction.
-[[nodiscard]] BloomFilter compute_bloom_filter(std::span<const Log> logs) noexcept;
+[[nodiscard]] BloomFilter compute_bloom_filter(std::span<const Log> logs);
 
 /// Computes combined bloom fitter for set of TransactionReceipts
 /// It's used to compute bloom filter for a block.
@@ -0,0 +1,41 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "code_store.hpp"
+#include <algorithm>
+
+namespace evmone::state
+{
+std::shared_ptr<const CodeStore::Entry> CodeStore::find(const bytes32& code_hash) const
+{
+    const std::shared_lock lock{m_mutex};
+    const auto it = m_entries.find(code_hash);
+    return it != m_entries.end() ? it->second.lock() : nullptr;
+}
+
+std::shared_ptr<const CodeStore::Entry> CodeStore::insert(const bytes32& code_hash, bytes&& code)
+{
+    const std::lock_guard lock{m_mutex};
+    auto& slot = m_entries[code_hash];
+    if (auto entry = slot.lock())
+        return entry;
+
+    auto entry = std::make_shared<const Entry>(std::move(code));
+    slot = entry;
+
+    if (m_entries.size() >= m_purge_threshold)
+    {
+        std::erase_if(m_entries, [](const auto& kv) noexcept { return kv.second.expired(); });
+        m_purge_threshold = std::max(m_purge_threshold, m_entries.size() * 2);
+    }
+    return entry;
+}
+
+size_t CodeStore::size() const
+{
+    const std::shared_lock lock{m_mutex};
+    return static_cast<size_t>(std::ranges::count_if(
+        m_entries, [](const auto& kv) noexcept { return !kv.second.expired(); }));
+}
+}  // namespace evmone::state
@@ -0,0 +1,60 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <evmc/evmc.hpp>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace evmone::state
+{
+using evmc::bytes;
+using evmc::bytes32;
+using evmc::bytes_view;
+
+/// The store of the account code deduplicated by the code hash.
+///
+/// The entries are immutable and reference counted: they live as long as any account
+/// (or anyone else) holds them. Many accounts (e.g. EIP-1167 proxies) share the same code,
+/// so the code is loaded and stored only once. The store is thread-safe: the lookups
+/// of the existing entries take only a shared lock.
+///
+/// The store is owned by the root state (e.g. TestState) and reached by State
+/// through StateView::code_store().
+class CodeStore
+{
+public:
+    /// The shared code.
+    class Entry
+    {
+        bytes m_code;
+
+    public:
+        explicit Entry(bytes code) noexcept : m_code{std::move(code)} {}
+
+        /// The code. The view is valid as long as the entry.
+        [[nodiscard]] bytes_view code() const noexcept { return m_code; }
+    };
+
+    /// Returns the entry of the code with the given hash. Null if not in the store.
+    [[nodiscard]] std::shared_ptr<const Entry> find(const bytes32& code_hash) const;
+
+    /// Returns the entry of the code with the given hash. The code is inserted if the hash
+    /// is not in the store yet; otherwise the code is ignored and the existing entry is returned.
+    [[nodiscard]] std::shared_ptr<const Entry> insert(const bytes32& code_hash, bytes&& code);
+
+    /// Returns the number of the entries in use.
+    [[nodiscard]] size_t size() const;
+
+private:
+    mutable std::shared_mutex m_mutex;
+
+    /// The entries: code hash => entry. The expired entries are removed from time to time.
+    std::unordered_map<bytes32, std::weak_ptr<const Entry>> m_entries;
+
+    /// The number of entries after which the expired ones are removed.
+    size_t m_purge_threshold = 1024;
+};
+}  // namespace evmone::state
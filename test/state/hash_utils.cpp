@@ -2,6 +2,44 @@
 // Copyright 2023 The evmone Authors.
 // SPDX-License-Identifier: Apache-2.0
 #include "hash_utils.hpp"
+#include <evmone_precompiles/keccak.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace evmone
+{
+hash256 keccak256(bytes_view data) noexcept
+{
+    static_assert(sizeof(hash256) == crypto::KECCAK256_HASH_SIZE);
+    hash256 hash;
+    crypto::keccak256(reinterpret_cast<std::byte*>(hash.bytes),
+        reinterpret_cast<const std::byte*>(data.data()), data.size());
+    return hash;
+}
+
+void keccak256_batch(std::span<hash256> hashes, std::span<const bytes_view> inputs) noexcept
+{
+    assert(hashes.size() == inputs.size());
+    static_assert(sizeof(hash256) == crypto::KECCAK256_HASH_SIZE);
+
+    // The inputs are passed to the multi-buffer implementation in chunks
+    // to avoid allocations. The chunk is a multiple of the SIMD lane width
+    // and fits the children of an MPT branch node at once.
+    static constexpr size_t CHUNK_SIZE = 16;
+    const std::byte* data[CHUNK_SIZE];
+    size_t sizes[CHUNK_SIZE];
+    for (size_t offset = 0; offset < inputs.size(); offset += CHUNK_SIZE)
+    {
+        const auto count = std::min(CHUNK_SIZE, inputs.size() - offset);
+        for (size_t i = 0; i < count; ++i)
+        {
+            data[i] = reinterpret_cast<const std::byte*>(inputs[offset + i].data());
+            sizes[i] = inputs[offset + i].size();
+        }
+        crypto::keccak256_batch(reinterpret_cast<std::byte*>(&hashes[offset]), data, sizes, count);
+    }
+}
+}  // namespace evmone
 
 std::ostream& operator<<(std::ostream& out, const evmone::address& a)
 {
@@ -8,6 +8,7 @@
 #include <evmc/evmc.hpp>
 #include <evmc/hex.hpp>
 #include <bit>
+#include <span>
 
 namespace evmone
 {
@@ -26,11 +27,16 @@ using hash256 = bytes32;
 static constexpr auto EmptyListHash =
     0x1dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347_bytes32;
 
-/// Computes Keccak hash out of input bytes (wrapper of ethash::keccak256).
-inline hash256 keccak256(bytes_view data) noexcept
-{
-    return std::bit_cast<hash256>(ethash::keccak256(data.data(), data.size()));
-}
+/// Computes Keccak hash out of input bytes (wrapper of crypto::keccak256).
+///
+/// The implementation optimized for the CPU is selected at runtime.
+hash256 keccak256(bytes_view data) noexcept;
+
+/// Computes Keccak hashes of multiple independent inputs.
+///
+/// Uses the multi-buffer implementation hashing several inputs at once if the CPU supports it.
+/// The hashes and inputs must have the same size.
+void keccak256_batch(std::span<hash256> hashes, std::span<const bytes_view> inputs) noexcept;
 }  // namespace evmone
 
 std::ostream& operator<<(std::ostream& out, const evmone::address& a);
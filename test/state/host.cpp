@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "host.hpp"
+#include "keccak_memo.hpp"
 #include "precompiles.hpp"
 #include "rlp.hpp"
 #include <evmone/constants.hpp>
@@ -10,15 +11,59 @@
 
 namespace evmone::state
 {
+void Host::record_account_read(const address& addr) const noexcept
+{
+    if (m_access_record != nullptr) [[unlikely]]
+        m_access_record->accounts_read.insert(addr);
+}
+
+void Host::record_account_write(const address& addr) const noexcept
+{
+    if (m_access_record != nullptr) [[unlikely]]
+        m_access_record->accounts_written.insert(addr);
+}
+
+void Host::record_storage_read(const address& addr, const bytes32& key) const noexcept
+{
+    if (m_access_record != nullptr) [[unlikely]]
+        m_access_record->storage_read.emplace(addr, key);
+}
+
+void Host::record_storage_write(const address& addr, const bytes32& key) const noexcept
+{
+    if (m_access_record != nullptr) [[unlikely]]
+        m_access_record->storage_written.emplace(addr, key);
+}
+
+void Host::record_code_load(const address& addr) const noexcept
+{
+    if (m_access_record != nullptr) [[unlikely]]
+    {
+        m_access_record->accounts_read.insert(addr);
+        m_access_record->code_loaded.insert(addr);
+    }
+}
+
 bool Host::account_exists(const address& addr) const noexcept
 {
+    record_account_read(addr);
     const auto* const acc = m_state.find(addr);
     return acc != nullptr && (m_rev < EVMC_SPURIOUS_DRAGON || !acc->is_empty());
 }
 
+StorageValue& Host::storage_slot(const address& addr, const bytes32& key) const noexcept
+{
+    // Mix the last bytes: the keys are small numbers or hashes, the addresses are mostly hashes.
+    auto& e = m_slot_cache[(key.bytes[31] ^ key.bytes[30] ^ addr.bytes[19]) % m_slot_cache.size()];
+    if (e.epoch != m_slot_cache_epoch || e.key != key || e.addr != addr)
+        e = {addr, key, &m_state.get_storage(addr, key), m_slot_cache_epoch};
+    return *e.slot;
+}
+
 bytes32 Host::get_storage(const address& addr, const bytes32& key) const noexcept
 {
-    return m_state.get_storage(addr, key).current;
+    record_storage_read(addr, key);
+    return storage_slot(addr, key).current;
 }
 
 evmc_storage_status Host::set_storage(
@@ -27,8 +72,10 @@ evmc_storage_status Host::set_storage(
     // Follow EVMC documentation https://evmc.ethereum.org/storagestatus.html#autotoc_md3
     // and EIP-2200 specification https://eips.ethereum.org/EIPS/eip-2200.
 
-    auto& storage_slot = m_state.get_storage(addr, key);
-    const auto& [current, original, _] = storage_slot;
+    record_storage_read(addr, key);
+    record_storage_write(addr, key);
+    auto& slot = storage_slot(addr, key);
+    const auto& [current, original, _] = slot;
 
     const auto dirty = original != current;
     const auto restored = original == value;
@@ -64,13 +111,14 @@ evmc_storage_status Host::set_storage(
 
     // In Berlin this is handled in access_storage().
     if (m_rev < EVMC_BERLIN)
-        m_state.journal_storage_change(addr, key, storage_slot);
-    storage_slot.current = value;  // Update current value.
+        m_state.journal_storage_change(addr, key, slot);
+    slot.current = value;  // Update current value.
     return status;
 }
 
 uint256be Host::get_balance(const address& addr) const noexcept
 {
+    record_account_read(addr);
     const auto* const acc = m_state.find(addr);
     return (acc != nullptr) ? intx::be::store<uint256be>(acc->balance) : uint256be{};
 }
@@ -109,19 +157,20 @@ bytes_view extcode(bytes_view code) noexcept
 
 size_t Host::get_code_size(const address& addr) const noexcept
 {
+    record_code_load(addr);
     const auto raw_code = m_state.get_code(addr);
     return extcode(raw_code).size();
 }
 
 bytes32 Host::get_code_hash(const address& addr) const noexcept
 {
-    const auto* const acc = m_state.find(addr);
+    record_code_load(addr);
+    auto* const acc = m_state.find(addr);
     if (acc == nullptr || acc->is_empty())
         return {};
 
     // Load code and check if not EOF.
-    // TODO: Optimize the second account lookup here.
-    if (is_eof_container(m_state.get_code(addr)))
+    if (is_eof_container(m_state.get_code(addr, *acc)))
         return EOF_CODE_HASH_SENTINEL;
 
     return acc->code_hash;
@@ -130,6 +179,7 @@ bytes32 Host::get_code_hash(const address& addr) const noexcept
 size_t Host::copy_code(const address& addr, size_t code_offset, uint8_t* buffer_data,
     size_t buffer_size) const noexcept
 {
+    record_code_load(addr);
     const auto raw_code = m_state.get_code(addr);
     const auto code = extcode(raw_code);
     const auto code_slice = code.substr(std::min(code_offset, code.size()));
@@ -140,6 +190,10 @@ size_t Host::copy_code(const address& addr, size_t code_offset, uint8_t* buffer_
 
 bool Host::selfdestruct(const address& addr, const address& beneficiary) noexcept
 {
+    record_account_read(addr);
+    record_account_write(addr);
+    record_account_read(beneficiary);
+    record_account_write(beneficiary);
     if (m_state.find(beneficiary) == nullptr)
         m_state.journal_create(beneficiary, false);
     auto& acc = m_state.get(addr);
@@ -190,7 +244,8 @@ address compute_create_address(const address& sender, uint64_t sender_nonce) noe
 address compute_create2_address(
     const address& sender, const bytes32& salt, bytes_view init_code) noexcept
 {
-    const auto init_code_hash = keccak256(init_code);
+    // The factories deploy many clones with the same initcode, so the hash is memoized.
+    const auto init_code_hash = KeccakMemo::local().keccak256(init_code);
     uint8_t buffer[1 + sizeof(sender) + sizeof(salt) + sizeof(init_code_hash)];
     static_assert(std::size(buffer) == 85);
     auto it = std::begin(buffer);
@@ -209,6 +264,7 @@ std::optional<evmc_message> Host::prepare_message(evmc_message msg) noexcept
     if (msg.depth == 0 || msg.kind == EVMC_CREATE || msg.kind == EVMC_CREATE2 ||
         msg.kind == EVMC_EOFCREATE)
     {
+        record_account_read(msg.sender);
         auto& sender_acc = m_state.get(msg.sender);
 
         // EIP-2681 (already checked for depth 0 during transaction validation).
@@ -217,6 +273,7 @@ std::optional<evmc_message> Host::prepare_message(evmc_message msg) noexcept
 
         if (msg.depth != 0)
         {
+            record_account_write(msg.sender);
             m_state.journal_bump_nonce(msg.sender);
             ++sender_acc.nonce;  // Bump sender nonce.
         }
@@ -292,6 +349,9 @@ evmc::Result Host::create(const evmc_message& msg) noexcept
 {
     assert(msg.kind == EVMC_CREATE || msg.kind == EVMC_CREATE2 || msg.kind == EVMC_EOFCREATE);
 
+    record_account_read(msg.recipient);
+    record_account_write(msg.recipient);
+    record_account_write(msg.sender);
     auto* new_acc = m_state.find(msg.recipient);
     const bool new_acc_exists = new_acc != nullptr;
     if (!new_acc_exists)
@@ -325,7 +385,7 @@ evmc::Result Host::create(const evmc_message& msg) noexcept
         create_msg.input_size = 0;
     }
 
-    auto result = m_vm.execute(*this, m_rev, create_msg, initcode.data(), initcode.size());
+    auto result = execute_code(create_msg, initcode);
     if (result.status_code != EVMC_SUCCESS)
     {
         result.create_address = msg.recipient;
@@ -372,8 +432,8 @@ evmc::Result Host::create(const evmc_message& msg) noexcept
         }
     }
 
-    new_acc->code_hash = keccak256(code);
-    new_acc->code = code;
+    new_acc->code_hash = KeccakMemo::local().keccak256(code);
+    new_acc->code = m_state.store_code(new_acc->code_hash, bytes{code});
 
     return evmc::Result{result.status_code, gas_left, result.gas_refund, msg.recipient};
 }
@@ -385,6 +445,10 @@ evmc::Result Host::execute_message(const evmc_message& msg) noexcept
 
     if (msg.kind == EVMC_CALL)
     {
+        record_account_read(msg.recipient);
+        record_account_write(msg.recipient);
+        if (!evmc::is_zero(msg.value))
+            record_account_write(msg.sender);
         const auto exists = m_state.find(msg.recipient) != nullptr;
         if (!exists)
             m_state.journal_create(msg.recipient, exists);
@@ -416,8 +480,94 @@ evmc::Result Host::execute_message(const evmc_message& msg) noexcept
         return call_precompile(m_rev, msg);
 
     // TODO: get_code() performs the account lookup. Add a way to get an account with code?
+    record_code_load(msg.code_address);
     const auto code = m_state.get_code(msg.code_address);
+    return execute_code(msg, code);
+}
+
+evmc::Result Host::execute_code(const evmc_message& msg, bytes_view code) noexcept
+{
+#ifdef EVMONE_STATE_DIRECT_HOST
+    return m_vm.execute(direct_interface(), reinterpret_cast<evmc_host_context*>(this), m_rev, msg,
+        code.data(), code.size());
+#else
     return m_vm.execute(*this, m_rev, msg, code.data(), code.size());
+#endif
+}
+
+const evmc_host_interface& Host::direct_interface() noexcept
+{
+    // The methods are called by qualified names so the calls are not virtual
+    // and can be inlined into these wrappers.
+    static constexpr auto host = [](evmc_host_context* ctx) noexcept {
+        return reinterpret_cast<Host*>(ctx);
+    };
+    static constexpr auto addr = [](const evmc_address* a) noexcept -> const address& {
+        return *static_cast<const address*>(a);
+    };
+    static constexpr auto b32 = [](const evmc_bytes32* b) noexcept -> const bytes32& {
+        return *static_cast<const bytes32*>(b);
+    };
+
+    static constexpr evmc_host_interface direct{
+        .account_exists = [](evmc_host_context* ctx, const evmc_address* a) noexcept {
+            return host(ctx)->Host::account_exists(addr(a));
+        },
+        .get_storage = [](evmc_host_context* ctx, const evmc_address* a,
+                           const evmc_bytes32* key) noexcept -> evmc_bytes32 {
+            return host(ctx)->Host::get_storage(addr(a), b32(key));
+        },
+        .set_storage = [](evmc_host_context* ctx, const evmc_address* a, const evmc_bytes32* key,
+                           const evmc_bytes32* value) noexcept {
+            return host(ctx)->Host::set_storage(addr(a), b32(key), b32(value));
+        },
+        .get_balance = [](evmc_host_context* ctx, const evmc_address* a) noexcept
+            -> evmc_uint256be { return host(ctx)->Host::get_balance(addr(a)); },
+        .get_code_size = [](evmc_host_context* ctx, const evmc_address* a) noexcept {
+            return host(ctx)->Host::get_code_size(addr(a));
+        },
+        .get_code_hash = [](evmc_host_context* ctx, const evmc_address* a) noexcept
+            -> evmc_bytes32 { return host(ctx)->Host::get_code_hash(addr(a)); },
+        .copy_code = [](evmc_host_context* ctx, const evmc_address* a, size_t code_offset,
+                         uint8_t* buffer_data, size_t buffer_size) noexcept {
+            return host(ctx)->Host::copy_code(addr(a), code_offset, buffer_data, buffer_size);
+        },
+        .selfdestruct = [](evmc_host_context* ctx, const evmc_address* a,
+                            const evmc_address* beneficiary) noexcept {
+            return host(ctx)->Host::selfdestruct(addr(a), addr(beneficiary));
+        },
+        .call = [](evmc_host_context* ctx, const evmc_message* msg) noexcept {
+            return host(ctx)->Host::call(*msg).release_raw();
+        },
+        .get_tx_context = [](evmc_host_context* ctx) noexcept {
+            return host(ctx)->Host::get_tx_context();
+        },
+        .get_block_hash = [](evmc_host_context* ctx, int64_t number) noexcept -> evmc_bytes32 {
+            return host(ctx)->Host::get_block_hash(number);
+        },
+        .emit_log = [](evmc_host_context* ctx, const evmc_address* a, const uint8_t* data,
+                        size_t data_size, const evmc_bytes32 topics[],
+                        size_t topics_count) noexcept {
+            host(ctx)->Host::emit_log(
+                addr(a), data, data_size, static_cast<const bytes32*>(topics), topics_count);
+        },
+        .access_account = [](evmc_host_context* ctx, const evmc_address* a) noexcept {
+            return host(ctx)->Host::access_account(addr(a));
+        },
+        .access_storage = [](evmc_host_context* ctx, const evmc_address* a,
+                              const evmc_bytes32* key) noexcept {
+            return host(ctx)->Host::access_storage(addr(a), b32(key));
+        },
+        .get_transient_storage = [](evmc_host_context* ctx, const evmc_address* a,
+                                     const evmc_bytes32* key) noexcept -> evmc_bytes32 {
+            return host(ctx)->Host::get_transient_storage(addr(a), b32(key));
+        },
+        .set_transient_storage = [](evmc_host_context* ctx, const evmc_address* a,
+                                     const evmc_bytes32* key, const evmc_bytes32* value) noexcept {
+            host(ctx)->Host::set_transient_storage(addr(a), b32(key), b32(value));
+        },
+    };
+    return direct;
 }
 
 evmc::Result Host::call(const evmc_message& orig_msg) noexcept
@@ -434,11 +584,14 @@ evmc::Result Host::call(const evmc_message& orig_msg) noexcept
     if (result.status_code != EVMC_SUCCESS)
     {
         static constexpr auto addr_03 = 0x03_address;
+        record_account_read(addr_03);
+        record_account_write(addr_03);
         auto* const acc_03 = m_state.find(addr_03);
         const auto is_03_touched = acc_03 != nullptr && acc_03->erase_if_empty;
 
         // Revert.
         m_state.rollback(state_checkpoint);
+        ++m_slot_cache_epoch;  // The rollback may erase accounts with the cached slots.
         m_logs.resize(logs_checkpoint);
 
         // The 0x03 quirk: the touch on this address is never reverted.
@@ -496,6 +649,7 @@ evmc_access_status Host::access_account(const address& addr) noexcept
     if (m_rev < EVMC_BERLIN)
         return EVMC_ACCESS_COLD;  // Ignore before Berlin.
 
+    record_account_read(addr);
     auto& acc = m_state.get_or_insert(addr, {.erase_if_empty = true});
 
     if (acc.access_status == EVMC_ACCESS_WARM || is_precompile(m_rev, addr))
@@ -508,9 +662,10 @@ evmc_access_status Host::access_account(const address& addr) noexcept
 
 evmc_access_status Host::access_storage(const address& addr, const bytes32& key) noexcept
 {
-    auto& storage_slot = m_state.get_storage(addr, key);
-    m_state.journal_storage_change(addr, key, storage_slot);
-    return std::exchange(storage_slot.access_status, EVMC_ACCESS_WARM);
+    record_storage_read(addr, key);
+    auto& slot = storage_slot(addr, key);
+    m_state.journal_storage_change(addr, key, slot);
+    return std::exchange(slot.access_status, EVMC_ACCESS_WARM);
 }
 
 
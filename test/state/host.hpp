@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include "access_record.hpp"
 #include "state.hpp"
+#include <array>
 #include <optional>
 
 namespace evmone::state
@@ -35,12 +37,32 @@ using evmc::uint256be;
 
 class Host : public evmc::Host
 {
+    /// The entry of the storage slot cache.
+    struct CachedSlot
+    {
+        address addr;
+        bytes32 key;
+
+        /// The slot in the State. Valid only if the epoch matches Host::m_slot_cache_epoch.
+        StorageValue* slot = nullptr;
+        uint32_t epoch = 0;
+    };
+
     evmc_revision m_rev;
     evmc::VM& m_vm;
     State& m_state;
     const BlockInfo& m_block;
     const Transaction& m_tx;
     std::vector<Log> m_logs;
+    AccessRecord* m_access_record = nullptr;
+
+    /// The direct-mapped cache of the recently accessed storage slots: (address, key) => slot.
+    ///
+    /// It makes the read-modify-write patterns (SLOAD + SSTORE of the same slot) do the State
+    /// lookups only once. The slots in the State are stable until a rollback,
+    /// which invalidates the whole cache by bumping the epoch.
+    mutable std::array<CachedSlot, 64> m_slot_cache;
+    uint32_t m_slot_cache_epoch = 1;
 
 public:
     Host(evmc_revision rev, evmc::VM& vm, State& state, const BlockInfo& block,
@@ -50,6 +72,9 @@ public:
 
     [[nodiscard]] std::vector<Log>&& take_logs() noexcept { return std::move(m_logs); }
 
+    /// Starts recording the state accesses to the given record. The nullptr stops recording.
+    void record_accesses(AccessRecord* record) noexcept { m_access_record = record; }
+
     evmc::Result call(const evmc_message& msg) noexcept override;
 
 private:
@@ -102,5 +127,21 @@ private:
     std::optional<evmc_message> prepare_message(evmc_message msg) noexcept;
 
     evmc::Result execute_message(const evmc_message& msg) noexcept;
+
+    /// Returns the storage slot from the State, using the slot cache.
+    StorageValue& storage_slot(const address& addr, const bytes32& key) const noexcept;
+
+    /// Executes the code in the VM with this Host.
+    evmc::Result execute_code(const evmc_message& msg, bytes_view code) noexcept;
+
+    /// The EVMC host interface calling the Host methods directly, without the virtual dispatch.
+    /// Used instead of the generic evmc::Host::get_interface() if EVMONE_STATE_DIRECT_HOST is set.
+    static const evmc_host_interface& direct_interface() noexcept;
+
+    void record_account_read(const address& addr) const noexcept;
+    void record_account_write(const address& addr) const noexcept;
+    void record_storage_read(const address& addr, const bytes32& key) const noexcept;
+    void record_storage_write(const address& addr, const bytes32& key) const noexcept;
+    void record_code_load(const address& addr) const noexcept;
 };
 }  // namespace evmone::state
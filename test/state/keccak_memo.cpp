@@ -0,0 +1,42 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "keccak_memo.hpp"
+#include <string_view>
+
+namespace evmone::state
+{
+KeccakMemo& KeccakMemo::local() noexcept
+{
+    // Thread-local, so the transactions executed in parallel don't contend.
+    thread_local KeccakMemo memo;
+    return memo;
+}
+
+hash256 KeccakMemo::keccak256(bytes_view data)
+{
+    if (data.size() < MIN_SIZE || data.size() > MAX_SIZE)
+        return evmone::keccak256(data);
+
+    const auto key =
+        std::hash<std::string_view>{}({reinterpret_cast<const char*>(data.data()), data.size()});
+    auto& e = m_entries[key % m_entries.size()];
+    if (e.key == key && e.data == data)
+    {
+        ++m_stats.hits;
+        return e.hash;
+    }
+
+    ++m_stats.misses;
+    e.hash = evmone::keccak256(data);
+    if (e.key == key)
+        e.data = data;  // Seen again: worth keeping.
+    else
+    {
+        e.key = key;
+        e.data.clear();
+    }
+    return e.hash;
+}
+}  // namespace evmone::state
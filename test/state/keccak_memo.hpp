@@ -0,0 +1,64 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "hash_utils.hpp"
+#include <array>
+
+namespace evmone::state
+{
+/// The memo of the Keccak-256 hashes of the recently hashed inputs.
+///
+/// It is meant for the code hashed over and over again, e.g. the initcode and the runtime code
+/// of the contract clones deployed by the CREATE2 factories. The memo is direct-mapped
+/// by a cheap non-cryptographic hash of the input. The entries keep a copy of the input
+/// so every hit is verified by the full comparison, which is still much cheaper than Keccak.
+/// To not copy the inputs hashed only once, an input is stored only when it is seen
+/// the second time in a row in its slot (identified by the cheap hash).
+class KeccakMemo
+{
+public:
+    /// The inputs shorter than this are not memoized.
+    ///
+    /// Any input up to 135 bytes costs a full Keccak-f[1600] permutation while the memo lookup
+    /// costs a pass of the cheap hash and the comparison. This covers the EIP-1167 minimal proxy
+    /// clones: the initcode of 55 bytes and the runtime code of 45 bytes.
+    static constexpr size_t MIN_SIZE = 32;
+
+    /// The inputs longer than this are not memoized (the EIP-3860 initcode limit).
+    static constexpr size_t MAX_SIZE = 0xc000;
+
+    /// The memo usage counters. The inputs not eligible for memoization are not counted.
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    /// Returns the memo of the current thread.
+    static KeccakMemo& local() noexcept;
+
+    /// Computes the Keccak-256 hash of the data, or returns the memoized one.
+    [[nodiscard]] hash256 keccak256(bytes_view data);
+
+    [[nodiscard]] const Stats& stats() const noexcept { return m_stats; }
+
+    void reset_stats() noexcept { m_stats = {}; }
+
+private:
+    struct Entry
+    {
+        /// The cheap hash of the last input mapped to this entry.
+        size_t key = 0;
+
+        /// The stored input. Empty if the input has been seen only once.
+        bytes data;
+
+        hash256 hash;
+    };
+
+    std::array<Entry, 16> m_entries;
+    Stats m_stats;
+};
+}  // namespace evmone::state
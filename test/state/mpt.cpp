@@ -216,6 +216,46 @@ static bytes encode_child(const MPTNode& child) noexcept  // NOLINT(misc-no-recu
         return rlp::encode(keccak256(e));
 }
 
+/// Encodes the children of a branch node.
+/// The "long" children are hashed together with the multi-buffer Keccak.
+static bytes encode_children(  // NOLINT(misc-no-recursion)
+    const std::unique_ptr<MPTNode> (&children)[16])
+{
+    static constexpr uint8_t empty = 0x80;  // encoded empty child
+
+    bytes encoded_children[16];
+    bytes_view long_children[16];
+    size_t long_indexes[16];
+    size_t num_long = 0;
+    for (size_t i = 0; i < std::size(children); ++i)
+    {
+        if (!children[i])
+            continue;
+        encoded_children[i] = children[i]->encode();
+        if (encoded_children[i].size() >= 32)
+        {
+            long_children[num_long] = encoded_children[i];
+            long_indexes[num_long++] = i;
+        }
+    }
+
+    hash256 hashes[16];
+    keccak256_batch({hashes, num_long}, {long_children, num_long});
+    for (size_t j = 0; j < num_long; ++j)
+        encoded_children[long_indexes[j]] = rlp::encode(hashes[j]);
+
+    bytes encoded;
+    for (size_t i = 0; i < std::size(children); ++i)
+    {
+        if (children[i])
+            encoded += encoded_children[i];
+        else
+            encoded += empty;
+    }
+    encoded += empty;  // end indicator
+    return encoded;
+}
+
 bytes MPTNode::encode() const  // NOLINT(misc-no-recursion)
 {
     bytes encoded;
@@ -229,16 +269,7 @@ bytes MPTNode::encode() const  // NOLINT(misc-no-recursion)
     case Kind::branch:
     {
         assert(m_path.empty());
-        static constexpr uint8_t empty = 0x80;  // encoded empty child
-
-        for (const auto& child : m_children)
-        {
-            if (child)
-                encoded += encode_child(*child);
-            else
-                encoded += empty;
-        }
-        encoded += empty;  // end indicator
+        encoded = encode_children(m_children);
         break;
     }
     case Kind::ext:
@@ -15,12 +15,23 @@ namespace
 {
 hash256 mpt_hash(const std::map<bytes32, bytes32>& storage)
 {
-    MPT trie;
+    // Hash all the keys at once with the multi-buffer Keccak.
+    std::vector<bytes_view> keys;
+    std::vector<bytes32> values;
     for (const auto& [key, value] : storage)
     {
         if (!is_zero(value))  // Skip "deleted" values.
-            trie.insert(keccak256(key), rlp::encode(rlp::trim(value)));
+        {
+            keys.emplace_back(key);
+            values.emplace_back(value);
+        }
     }
+    std::vector<hash256> hashed_keys(keys.size());
+    keccak256_batch(hashed_keys, keys);
+
+    MPT trie;
+    for (size_t i = 0; i < keys.size(); ++i)
+        trie.insert(hashed_keys[i], rlp::encode(rlp::trim(values[i])));
     return trie.hash();
 }
 }  // namespace
@@ -46,6 +57,15 @@ hash256 mpt_hash(std::span<const T> list)
     return trie.hash();
 }
 
+hash256 mpt_hash_encoded(std::span<const bytes> encoded_list)
+{
+    MPT trie;
+    for (size_t i = 0; i < encoded_list.size(); ++i)
+        trie.insert(rlp::encode(i), bytes{encoded_list[i]});
+
+    return trie.hash();
+}
+
 template hash256 mpt_hash<Transaction>(std::span<const Transaction>);
 template hash256 mpt_hash<TransactionReceipt>(std::span<const TransactionReceipt>);
 template hash256 mpt_hash<Withdrawal>(std::span<const Withdrawal>);
@@ -26,6 +26,12 @@ hash256 mpt_hash(const test::TestState& state);
 template <typename T>
 hash256 mpt_hash(std::span<const T> list);
 
+/// Computes Merkle Patricia Trie root hash for the given list of already RLP-encoded items.
+///
+/// The result is the same as of mpt_hash() of the list of the structures,
+/// but the encoding can be done ahead (e.g. in parallel).
+hash256 mpt_hash_encoded(std::span<const bytes> encoded_list);
+
 /// A helper to automatically convert collections (e.g. vector, array) to span.
 template <typename T>
 inline hash256 mpt_hash(const T& list)
@@ -0,0 +1,70 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace evmone::state
+{
+/// Calls fn(i) for every i in [0, n) using up to num_threads threads (including the calling one).
+///
+/// The indexes are distributed dynamically. If fn is invocable with two arguments,
+/// it is called as fn(i, w) where w in [0, min(num_threads, n)) identifies the worker thread,
+/// e.g. to select the worker's resources. The calling thread is the worker 0.
+/// If a thread cannot be started, the work is done by the threads started so far.
+/// If fn throws, the remaining indexes are skipped and the first exception is rethrown
+/// in the calling thread after all workers have finished.
+template <typename Fn>
+void parallel_for(size_t n, size_t num_threads, const Fn& fn)
+{
+    std::atomic<size_t> next = 0;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    const auto worker = [&](size_t w) noexcept {
+        try
+        {
+            for (auto i = next++; i < n; i = next++)
+            {
+                if constexpr (std::is_invocable_v<const Fn&, size_t, size_t>)
+                    fn(i, w);
+                else
+                    fn(i);
+            }
+        }
+        catch (...)
+        {
+            next = n;  // Stop the other workers.
+            const std::lock_guard lock{error_mutex};
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    const auto num_workers = std::max(std::min(num_threads, n), size_t{1});
+    std::vector<std::thread> threads;
+    try
+    {
+        threads.reserve(num_workers - 1);
+        for (size_t w = 1; w < num_workers; ++w)
+            threads.emplace_back(worker, w);
+    }
+    catch (const std::exception&)
+    {
+        // Continue with the threads started so far (std::system_error or std::bad_alloc).
+    }
+    worker(0);
+    for (auto& t : threads)
+        t.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+}  // namespace evmone::state
@@ -4,19 +4,25 @@
 
 #include "precompiles.hpp"
 #include "precompiles_internal.hpp"
-#include "precompiles_stubs.hpp"
 #include <evmone_precompiles/blake2b.hpp>
 #include <evmone_precompiles/bls.hpp>
 #include <evmone_precompiles/bn254.hpp>
 #include <evmone_precompiles/kzg.hpp>
+#include <evmone_precompiles/modexp.hpp>
 #include <evmone_precompiles/ripemd160.hpp>
 #include <evmone_precompiles/secp256k1.hpp>
 #include <evmone_precompiles/sha256.hpp>
 #include <intx/intx.hpp>
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #ifdef EVMONE_PRECOMPILES_SILKPRE
 #include "precompiles_silkpre.hpp"
@@ -343,6 +349,36 @@ ExecutionResult ecmul_execute(const uint8_t* input, size_t input_size, uint8_t*
         return {EVMC_PRECOMPILE_FAILURE, 0};
 }
 
+ExecutionResult ecpairing_execute(const uint8_t* input, size_t input_size, uint8_t* output,
+    [[maybe_unused]] size_t output_size) noexcept
+{
+    assert(output_size >= 32);
+
+    static constexpr size_t PAIR_SIZE = 192;
+    if (input_size % PAIR_SIZE != 0)
+        return {EVMC_PRECOMPILE_FAILURE, 0};
+
+    std::vector<std::pair<evmmax::bn254::Point, evmmax::bn254::ExtPoint>> pairs;
+    pairs.reserve(input_size / PAIR_SIZE);
+    for (auto p = input; p != input + input_size; p += PAIR_SIZE)
+    {
+        const auto load = [p](size_t offset) noexcept {
+            return intx::be::unsafe::load<intx::uint256>(&p[offset]);
+        };
+        // The Fp2 elements c0 + c1⋅u are encoded as (c1, c0).
+        pairs.emplace_back(evmmax::bn254::Point{load(0), load(32)},
+            evmmax::bn254::ExtPoint{{load(96), load(64)}, {load(160), load(128)}});
+    }
+
+    const auto res = evmmax::bn254::pairing_check(pairs);
+    if (!res.has_value())
+        return {EVMC_PRECOMPILE_FAILURE, 0};
+
+    std::fill_n(output, 32, uint8_t{0});
+    output[31] = *res ? 1 : 0;
+    return {EVMC_SUCCESS, 32};
+}
+
 ExecutionResult identity_execute(const uint8_t* input, size_t input_size, uint8_t* output,
     [[maybe_unused]] size_t output_size) noexcept
 {
@@ -351,6 +387,40 @@ ExecutionResult identity_execute(const uint8_t* input, size_t input_size, uint8_
     return {EVMC_SUCCESS, input_size};
 }
 
+ExecutionResult expmod_execute(const uint8_t* input, size_t input_size, uint8_t* output,
+    [[maybe_unused]] size_t output_size) noexcept
+{
+    static constexpr size_t input_header_size = 3 * sizeof(intx::uint256);
+
+    uint8_t input_header[input_header_size]{};
+    std::copy_n(input, std::min(input_size, input_header_size), input_header);
+
+    // The lengths fit size_t, otherwise the gas cost is unreachable (see expmod_analyze()).
+    const auto base_len =
+        static_cast<size_t>(intx::be::unsafe::load<intx::uint256>(&input_header[0]));
+    const auto exp_len =
+        static_cast<size_t>(intx::be::unsafe::load<intx::uint256>(&input_header[32]));
+    const auto mod_len =
+        static_cast<size_t>(intx::be::unsafe::load<intx::uint256>(&input_header[64]));
+    assert(output_size >= mod_len);
+
+    if (mod_len == 0)
+        return {EVMC_SUCCESS, 0};
+
+    // The missing input bytes are implicitly zeros.
+    bytes payload(base_len + exp_len + mod_len, 0);
+    if (input_size > input_header_size)
+    {
+        std::copy_n(&input[input_header_size],
+            std::min(input_size - input_header_size, payload.size()), payload.data());
+    }
+
+    const bytes_view payload_view{payload};
+    crypto::modexp(payload_view.substr(0, base_len), payload_view.substr(base_len, exp_len),
+        payload_view.substr(base_len + exp_len, mod_len), output);
+    return {EVMC_SUCCESS, mod_len};
+}
+
 ExecutionResult blake2bf_execute(const uint8_t* input, [[maybe_unused]] size_t input_size,
     uint8_t* output, [[maybe_unused]] size_t output_size) noexcept
 {
@@ -390,13 +460,23 @@ ExecutionResult point_evaluation_execute(const uint8_t* input, size_t input_size
     if (input_size != 192)
         return {EVMC_PRECOMPILE_FAILURE, 0};
 
-    const auto r = crypto::kzg_verify_proof(reinterpret_cast<const std::byte*>(&input[0]),
-        reinterpret_cast<const std::byte*>(&input[32]),
-        reinterpret_cast<const std::byte*>(&input[64]),
-        reinterpret_cast<const std::byte*>(&input[96]),
-        reinterpret_cast<const std::byte*>(&input[96 + 48]));
-
+    // Use the result of the batched verification if known. Otherwise, verify the proof
+    // unless the verification is deferred.
+    auto& batch = PointEvaluationBatch::local();
+    const bytes_view input_view{input, input_size};
+    auto r = batch.find(input_view);
+    if (!r && batch.is_deferred() && batch.defer(input_view))
+        r = true;
     if (!r)
+    {
+        r = crypto::kzg_verify_proof(reinterpret_cast<const std::byte*>(&input[0]),
+            reinterpret_cast<const std::byte*>(&input[32]),
+            reinterpret_cast<const std::byte*>(&input[64]),
+            reinterpret_cast<const std::byte*>(&input[96]),
+            reinterpret_cast<const std::byte*>(&input[96 + 48]));
+    }
+
+    if (!*r)
         return {EVMC_PRECOMPILE_FAILURE, 0};
 
     // Return FIELD_ELEMENTS_PER_BLOB and BLS_MODULUS as padded 32 byte big endian values
@@ -547,10 +627,10 @@ inline constexpr auto traits = []() noexcept {
         {sha256_analyze, sha256_execute},
         {ripemd160_analyze, ripemd160_execute},
         {identity_analyze, identity_execute},
-        {expmod_analyze, expmod_stub},
+        {expmod_analyze, expmod_execute},
         {ecadd_analyze, ecadd_execute},
         {ecmul_analyze, ecmul_execute},
-        {ecpairing_analyze, ecpairing_stub},
+        {ecpairing_analyze, ecpairing_execute},
         {blake2bf_analyze, blake2bf_execute},
         {point_evaluation_analyze, point_evaluation_execute},
         {bls12_g1add_analyze, bls12_g1add_execute},
@@ -567,10 +647,10 @@ inline constexpr auto traits = []() noexcept {
     // tbl[static_cast<size_t>(PrecompileId::ecrecover)].execute = silkpre_ecrecover_execute;
     // tbl[static_cast<size_t>(PrecompileId::sha256)].execute = silkpre_sha256_execute;
     // tbl[static_cast<size_t>(PrecompileId::ripemd160)].execute = silkpre_ripemd160_execute;
-    tbl[static_cast<size_t>(PrecompileId::expmod)].execute = silkpre_expmod_execute;
+    // tbl[static_cast<size_t>(PrecompileId::expmod)].execute = silkpre_expmod_execute;
     // tbl[static_cast<size_t>(PrecompileId::ecadd)].execute = silkpre_ecadd_execute;
     // tbl[static_cast<size_t>(PrecompileId::ecmul)].execute = silkpre_ecmul_execute;
-    tbl[static_cast<size_t>(PrecompileId::ecpairing)].execute = silkpre_ecpairing_execute;
+    // tbl[static_cast<size_t>(PrecompileId::ecpairing)].execute = silkpre_ecpairing_execute;
     // tbl[static_cast<size_t>(PrecompileId::blake2bf)].execute = silkpre_blake2bf_execute;
 #endif
     return tbl;
@@ -626,4 +706,92 @@ evmc::Result call_precompile(evmc_revision rev, const evmc_message& msg) noexcep
         [](const evmc_result* res) noexcept { delete[] res->output_data; }};
     return evmc::Result{result};
 }
+
+PointEvaluationBatch& PointEvaluationBatch::local() noexcept
+{
+    // Thread-local, so the transactions executed in parallel don't contend.
+    thread_local PointEvaluationBatch batch;
+    return batch;
+}
+
+void PointEvaluationBatch::prevalidate(std::span<const bytes_view> inputs)
+{
+    std::vector<Input> unknown;
+    unknown.reserve(inputs.size());
+    for (const auto& input : inputs)
+    {
+        if (input.size() != INPUT_SIZE || find(input))
+            continue;
+        std::ranges::copy(input, unknown.emplace_back().begin());
+    }
+    std::ranges::sort(unknown);
+    const auto [last, _] = std::ranges::unique(unknown);
+    unknown.erase(last, unknown.end());
+    verify(unknown);
+}
+
+std::optional<bool> PointEvaluationBatch::find(bytes_view input) const noexcept
+{
+    if (input.size() != INPUT_SIZE)
+        return std::nullopt;
+
+    const auto it = std::ranges::lower_bound(m_results, input, std::less{},
+        [](const auto& e) noexcept { return bytes_view{e.first.data(), e.first.size()}; });
+    if (it == m_results.end() || !std::ranges::equal(it->first, input))
+        return std::nullopt;
+    return it->second;
+}
+
+void PointEvaluationBatch::set_deferred(bool deferred, size_t max_deferred)
+{
+    if (deferred)
+        m_pending.reserve(max_deferred);
+    m_max_deferred = max_deferred;
+    m_deferred = deferred;
+}
+
+bool PointEvaluationBatch::defer(bytes_view input) noexcept
+{
+    assert(input.size() == INPUT_SIZE);
+    // Doesn't allocate: the capacity is reserved by set_deferred().
+    if (m_pending.size() >= m_max_deferred || m_pending.size() == m_pending.capacity())
+        return false;
+    std::ranges::copy(input, m_pending.emplace_back().begin());
+    return true;
+}
+
+bool PointEvaluationBatch::verify_deferred()
+{
+    std::ranges::sort(m_pending);
+    const auto [last, _] = std::ranges::unique(m_pending);
+    m_pending.erase(last, m_pending.end());
+    const auto all_valid = verify(m_pending);
+    m_pending.clear();  // Keep the capacity for the following deferred proofs.
+    return all_valid;
+}
+
+void PointEvaluationBatch::clear() noexcept
+{
+    m_results.clear();
+    m_pending.clear();
+}
+
+bool PointEvaluationBatch::verify(std::span<const Input> inputs)
+{
+    static_assert(sizeof(crypto::KZGProofInput) == INPUT_SIZE);
+    if (inputs.empty())
+        return true;
+
+    std::vector<crypto::KZGProofInput> proofs(inputs.size());
+    std::memcpy(proofs.data(), inputs.data(), inputs.size_bytes());
+
+    const auto valid = std::make_unique<bool[]>(inputs.size());
+    const auto all_valid = crypto::kzg_verify_proofs(proofs, {valid.get(), inputs.size()});
+
+    m_results.reserve(m_results.size() + inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+        m_results.emplace_back(inputs[i], valid[i]);
+    std::ranges::sort(m_results, {}, &std::pair<Input, bool>::first);
+    return all_valid;
+}
 }  // namespace evmone::state
@@ -5,10 +5,15 @@
 
 #include "../utils/stdx/utility.hpp"
 #include <evmc/evmc.hpp>
+#include <array>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace evmone::state
 {
+using evmc::bytes_view;
+
 /// The precompile identifiers and their corresponding addresses.
 enum class PrecompileId : uint8_t
 {
@@ -47,4 +52,67 @@ bool is_precompile(evmc_revision rev, const evmc::address& addr) noexcept;
 
 /// Executes the message to a precompiled contract (msg.code_address must be a precompile).
 evmc::Result call_precompile(evmc_revision rev, const evmc_message& msg) noexcept;
+
+/// The batched verification of the KZG proofs of the point evaluation precompile (EIP-4844).
+///
+/// The precompile verifies a single proof with two pairings. prevalidate() verifies the precompile
+/// inputs known ahead of the execution (e.g. of the transactions calling the precompile directly)
+/// in a batch with a single pairing check instead. The precompile then uses the results
+/// instead of verifying the proofs again.
+///
+/// In the deferred mode (not used by the test tools) the precompile treats the proofs without
+/// known results as valid and only records them for verify_deferred(). The caller must discard
+/// the execution results if it reports an invalid proof. The memory for the recorded proofs
+/// is reserved ahead; when it is used up the precompile verifies the proofs immediately.
+///
+/// The results are kept until clear(), e.g. for a single block as the test tools do
+/// with prevalidate_point_evaluations(). The batch is thread-local: it only affects
+/// the precompile calls executed by the same thread.
+class PointEvaluationBatch
+{
+public:
+    /// The size of the point evaluation precompile input.
+    static constexpr size_t INPUT_SIZE = 192;
+
+    using Input = std::array<uint8_t, INPUT_SIZE>;
+
+    /// Returns the batch of the current thread.
+    static PointEvaluationBatch& local() noexcept;
+
+    /// Verifies the precompile inputs in a batch and keeps the results.
+    /// The inputs of invalid size are skipped, the precompile rejects them anyway.
+    void prevalidate(std::span<const bytes_view> inputs);
+
+    /// Returns the known verification result of the precompile input. Binary search.
+    [[nodiscard]] std::optional<bool> find(bytes_view input) const noexcept;
+
+    /// Enables or disables the deferred verification of up to max_deferred proofs
+    /// until verify_deferred().
+    void set_deferred(bool deferred, size_t max_deferred = 1024);
+
+    [[nodiscard]] bool is_deferred() const noexcept { return m_deferred; }
+
+    /// Records the precompile input for the deferred verification.
+    /// Returns false if the maximum number of the deferred proofs has been reached.
+    [[nodiscard]] bool defer(bytes_view input) noexcept;
+
+    /// Verifies the deferred proofs in a batch and keeps the results.
+    /// The duplicated proofs are verified once.
+    /// Returns true if all the deferred proofs are valid.
+    [[nodiscard]] bool verify_deferred();
+
+    /// Drops the known results and the deferred proofs.
+    void clear() noexcept;
+
+private:
+    /// Verifies the inputs and adds the results to m_results.
+    bool verify(std::span<const Input> inputs);
+
+    /// The verification results sorted by the input.
+    std::vector<std::pair<Input, bool>> m_results;
+    /// The deferred proofs, possibly duplicated. The capacity is reserved by set_deferred().
+    std::vector<Input> m_pending;
+    size_t m_max_deferred = 0;
+    bool m_deferred = false;
+};
 }  // namespace evmone::state
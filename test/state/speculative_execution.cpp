@@ -0,0 +1,188 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "speculative_execution.hpp"
+#include "block_state.hpp"
+#include "parallel_for.hpp"
+#include "state.hpp"
+#include "test_state.hpp"
+#include <algorithm>
+
+namespace evmone::test
+{
+namespace
+{
+/// The StateView wrapper recording all values read from the underlying state.
+class RecordingStateView : public state::StateView
+{
+    const StateView& m_state;
+    StateReads& m_reads;
+
+public:
+    RecordingStateView(const StateView& state, StateReads& reads) noexcept
+      : m_state{state}, m_reads{reads}
+    {}
+
+    std::optional<Account> get_account(const address& addr) const noexcept override
+    {
+        auto acc = m_state.get_account(addr);
+        m_reads.accounts.emplace_back(addr, acc);
+        return acc;
+    }
+
+    bytes get_account_code(const address& addr) const noexcept override
+    {
+        // The code is not recorded: it is identified by the code hash of the account
+        // which State always reads before the code.
+        return m_state.get_account_code(addr);
+    }
+
+    bytes32 get_storage(const address& addr, const bytes32& key) const noexcept override
+    {
+        const auto value = m_state.get_storage(addr, key);
+        m_reads.storage.emplace_back(addr, key, value);
+        return value;
+    }
+
+    state::CodeStore* code_store() const noexcept override { return m_state.code_store(); }
+};
+
+bool equal(const std::optional<state::StateView::Account>& a,
+    const std::optional<state::StateView::Account>& b) noexcept
+{
+    if (!a.has_value() || !b.has_value())
+        return a.has_value() == b.has_value();
+    return a->nonce == b->nonce && a->balance == b->balance && a->code_hash == b->code_hash &&
+           a->has_storage == b->has_storage;
+}
+
+/// Moves the coinbase fee payment of the speculative transaction result
+/// onto the current coinbase account.
+///
+/// The transaction must not have accessed the coinbase other than by paying the fee.
+/// Returns false if the rebase is not possible. This is when the fee is zero because
+/// then the account may end up empty and be deleted depending on its current state.
+bool rebase_coinbase_fee(state::StateDiff& diff, const StateReads& reads,
+    const state::StateView& state, const address& coinbase) noexcept
+{
+    const auto read = std::ranges::find(reads.accounts, coinbase, [](const auto& r) noexcept {
+        return r.first;
+    });
+    const auto entry = std::ranges::find(diff.modified_accounts, coinbase,
+        [](const state::StateDiff::Entry& e) noexcept { return e.addr; });
+    if (read == reads.accounts.end() || entry == diff.modified_accounts.end())
+        return false;
+
+    const auto speculative_balance = read->second ? read->second->balance : intx::uint256{};
+    if (entry->balance <= speculative_balance)
+        return false;
+    const auto fee = entry->balance - speculative_balance;
+
+    assert(entry->code.empty() && entry->modified_storage.empty());
+    const auto current = state.get_account(coinbase);
+    entry->nonce = current ? current->nonce : 0;
+    entry->balance = (current ? current->balance : intx::uint256{}) + fee;
+    return true;
+}
+}  // namespace
+
+bool StateReads::is_valid(
+    const state::StateView& state, const std::optional<address>& ignored) const noexcept
+{
+    for (const auto& [addr, acc] : accounts)
+    {
+        if (addr != ignored && !equal(state.get_account(addr), acc))
+            return false;
+    }
+    for (const auto& [addr, key, value] : storage)
+    {
+        if (addr != ignored && state.get_storage(addr, key) != value)
+            return false;
+    }
+    return true;
+}
+
+std::vector<SpeculativeTransition> speculate(const state::StateView& state,
+    const state::BlockInfo& block, std::span<const state::Transaction> txs, evmc_revision rev,
+    std::span<evmc::VM> vms)
+{
+    assert(!vms.empty());
+    std::vector<SpeculativeTransition> speculations(txs.size());
+    state::parallel_for(txs.size(), vms.size(), [&](size_t i, size_t w) {
+        auto& s = speculations[i];
+        const RecordingStateView view{state, s.reads};
+        // Assume the transaction is the first one in the block.
+        s.result = state::transition(view, block, txs[i], rev, vms[w], block.gas_limit,
+            state::BlockInfo::MAX_BLOB_GAS_PER_BLOCK, &s.access);
+    });
+
+    return speculations;
+}
+
+namespace
+{
+/// Commits the speculative result to the state (TestState or BlockState) if it is valid.
+/// Otherwise, executes the transaction again.
+template <typename StateT>
+std::variant<state::TransactionReceipt, std::error_code> commit(StateT& state,
+    const state::BlockInfo& block, const state::Transaction& tx, evmc_revision rev, evmc::VM& vm,
+    int64_t block_gas_left, int64_t blob_gas_left, SpeculativeTransition&& speculation,
+    SpeculationStats* stats)
+{
+    const auto execute = [&] {
+        if (stats != nullptr)
+            ++stats->reexecuted;
+        auto res = state::transition(state, block, tx, rev, vm, block_gas_left, blob_gas_left);
+        if (const auto receipt = get_if<state::TransactionReceipt>(&res))
+            state.apply(receipt->state_diff);
+        return res;
+    };
+
+    // The speculative execution has assumed all the block gas is available.
+    // If the transaction fits in the remaining gas, the gas checks give the same outcome.
+    const auto fits_in_block =
+        tx.gas_limit <= block_gas_left && tx.blob_gas_used() <= blob_gas_left;
+    if (!fits_in_block)
+        return execute();
+
+    // The coinbase is always credited with the fee. If the execution hasn't accessed it
+    // otherwise, the result depends on the coinbase account only through the final balance.
+    // The fee payment has to be rebased only if the coinbase has changed since the speculation
+    // (e.g. by the fees of the previous transactions).
+    const auto fee_only_coinbase = !speculation.access.accounts_read.contains(block.coinbase);
+    const auto rebase_fee = !speculation.reads.is_valid(state);
+    if (rebase_fee && (!fee_only_coinbase || !speculation.reads.is_valid(state, block.coinbase)))
+        return execute();
+
+    if (auto* const receipt = get_if<state::TransactionReceipt>(&speculation.result))
+    {
+        if (rebase_fee &&
+            !rebase_coinbase_fee(receipt->state_diff, speculation.reads, state, block.coinbase))
+            return execute();
+        state.apply(receipt->state_diff);
+    }
+    if (stats != nullptr)
+        ++stats->reused;
+    return std::move(speculation.result);
+}
+}  // namespace
+
+std::variant<state::TransactionReceipt, std::error_code> transition(TestState& state,
+    const state::BlockInfo& block, const state::Transaction& tx, evmc_revision rev, evmc::VM& vm,
+    int64_t block_gas_left, int64_t blob_gas_left, SpeculativeTransition&& speculation,
+    SpeculationStats* stats)
+{
+    return commit(
+        state, block, tx, rev, vm, block_gas_left, blob_gas_left, std::move(speculation), stats);
+}
+
+std::variant<state::TransactionReceipt, std::error_code> transition(state::BlockState& state,
+    const state::BlockInfo& block, const state::Transaction& tx, evmc_revision rev, evmc::VM& vm,
+    int64_t block_gas_left, int64_t blob_gas_left, SpeculativeTransition&& speculation,
+    SpeculationStats* stats)
+{
+    return commit(
+        state, block, tx, rev, vm, block_gas_left, blob_gas_left, std::move(speculation), stats);
+}
+}  // namespace evmone::test
@@ -0,0 +1,100 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "access_record.hpp"
+#include "state_view.hpp"
+#include "transaction.hpp"
+#include <span>
+#include <system_error>
+#include <tuple>
+#include <variant>
+
+namespace evmone
+{
+namespace state
+{
+class BlockState;
+struct BlockInfo;
+}
+
+namespace test
+{
+class TestState;
+
+/// The state values read by a transaction execution.
+///
+/// The transaction execution is deterministic, therefore it produces the same result
+/// on any state where these values are the same.
+struct StateReads
+{
+    /// The accounts read: address => account (nullopt if the account didn't exist).
+    std::vector<std::pair<address, std::optional<state::StateView::Account>>> accounts;
+
+    /// The storage entries read: (address, key, value).
+    std::vector<std::tuple<address, bytes32, bytes32>> storage;
+
+    /// Checks if all the values, except the ones of the ignored account,
+    /// are the same in the given state.
+    [[nodiscard]] bool is_valid(
+        const state::StateView& state, const std::optional<address>& ignored = {}) const noexcept;
+};
+
+/// The result of the speculative transaction execution.
+struct SpeculativeTransition
+{
+    /// The transaction execution result.
+    std::variant<state::TransactionReceipt, std::error_code> result;
+
+    /// The state values the result depends on.
+    StateReads reads;
+
+    /// The state accessed by the transaction.
+    state::AccessRecord access;
+};
+
+/// The counters of the speculative results committed with test::transition().
+struct SpeculationStats
+{
+    /// The number of speculative results reused.
+    size_t reused = 0;
+
+    /// The number of transactions executed again because their speculative results were invalid.
+    size_t reexecuted = 0;
+};
+
+/// Speculatively executes the block transactions in parallel.
+///
+/// Every transaction is executed against the given state (e.g. the state before the block),
+/// i.e. as if it were the first transaction in the block. The transactions are distributed
+/// between worker threads, one thread per VM instance. The VM instances must not be used
+/// by anyone else during the call.
+/// The state must be safe for concurrent reads.
+///
+/// The results should be committed in the transaction order with test::transition().
+[[nodiscard]] std::vector<SpeculativeTransition> speculate(const state::StateView& state,
+    const state::BlockInfo& block, std::span<const state::Transaction> txs, evmc_revision rev,
+    std::span<evmc::VM> vms);
+
+/// Wrapping of state::transition() which operates on TestState
+/// and commits the speculative result of the transaction execution if it is still valid.
+///
+/// The speculative result is reused if the transaction fits in the block gas limits
+/// and all the state values it has read are unchanged. Otherwise, the transaction
+/// is executed again. In both cases, the result is identical to the sequential execution.
+/// The coinbase account is exempted from the check if the transaction has only paid
+/// the fee to it: the fee payment is then redone on the current coinbase balance.
+/// The outcome is counted in the optional stats.
+[[nodiscard]] std::variant<state::TransactionReceipt, std::error_code> transition(TestState& state,
+    const state::BlockInfo& block, const state::Transaction& tx, evmc_revision rev, evmc::VM& vm,
+    int64_t block_gas_left, int64_t blob_gas_left, SpeculativeTransition&& speculation,
+    SpeculationStats* stats = nullptr);
+
+/// The variant of the speculative transition() which operates on BlockState.
+[[nodiscard]] std::variant<state::TransactionReceipt, std::error_code> transition(
+    state::BlockState& state, const state::BlockInfo& block, const state::Transaction& tx,
+    evmc_revision rev, evmc::VM& vm, int64_t block_gas_left, int64_t blob_gas_left,
+    SpeculativeTransition&& speculation, SpeculationStats* stats = nullptr);
+}  // namespace test
+}  // namespace evmone
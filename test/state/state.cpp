@@ -9,6 +9,7 @@
 #include <evmone/constants.hpp>
 #include <evmone/eof.hpp>
 #include <algorithm>
+#include <cstring>
 
 namespace evmone::state
 {
@@ -107,8 +108,8 @@ StateDiff State::build_diff(evmc_revision rev) const
 
         // Output only the new code.
         // TODO: Output also the code hash. It will be needed for DB update and MPT hash.
-        if (m.just_created && !m.code.empty())
-            a.code = m.code;
+        if (m.just_created && m.code != nullptr && !m.code->code().empty())
+            a.code = m.code->code();
 
         for (const auto& [k, v] : m.storage)
         {
@@ -159,11 +160,29 @@ bytes_view State::get_code(const address& addr)
     auto* a = find(addr);
     if (a == nullptr)
         return {};
-    if (a->code_hash == Account::EMPTY_CODE_HASH)
+    return get_code(addr, *a);
+}
+
+bytes_view State::get_code(const address& addr, Account& acc)
+{
+    if (acc.code_hash == Account::EMPTY_CODE_HASH)
         return {};
-    if (a->code.empty())
-        a->code = m_initial.get_account_code(addr);
-    return a->code;
+    if (acc.code == nullptr)
+    {
+        // Load the code from the initial state only if no other account shares it.
+        if (m_code_store != nullptr)
+            acc.code = m_code_store->find(acc.code_hash);
+        if (acc.code == nullptr)
+            acc.code = store_code(acc.code_hash, m_initial.get_account_code(addr));
+    }
+    return acc.code->code();
+}
+
+std::shared_ptr<const CodeStore::Entry> State::store_code(const bytes32& code_hash, bytes&& code)
+{
+    if (m_code_store == nullptr)
+        return std::make_shared<const CodeStore::Entry>(std::move(code));
+    return m_code_store->insert(code_hash, std::move(code));
 }
 
 Account& State::touch(const address& addr)
@@ -172,7 +191,7 @@ Account& State::touch(const address& addr)
     if (!acc.erase_if_empty && acc.is_empty())
     {
         acc.erase_if_empty = true;
-        m_journal.emplace_back(JournalTouched{addr});
+        journal_push(JournalTouched{addr});
     }
     return acc;
 }
@@ -190,108 +209,164 @@ StorageValue& State::get_storage(const address& addr, const bytes32& key)
     return it->second;
 }
 
+void State::preload(
+    std::span<const address> addrs, std::span<const std::pair<address, bytes32>> keys)
+{
+    const auto accounts = m_initial.get_accounts(addrs);
+    for (size_t i = 0; i < addrs.size(); ++i)
+    {
+        if (const auto& cacc = accounts[i]; cacc && !m_modified.contains(addrs[i]))
+        {
+            insert(addrs[i], {.nonce = cacc->nonce,
+                                 .balance = cacc->balance,
+                                 .code_hash = cacc->code_hash,
+                                 .has_initial_storage = cacc->has_storage});
+        }
+    }
+
+    const auto values = m_initial.get_storage_batch(keys);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        const auto& [addr, key] = keys[i];
+        // The storage of non-existing accounts is empty and doesn't need preloading.
+        if (const auto it = m_modified.find(addr); it != m_modified.end())
+            it->second.storage.try_emplace(key, StorageValue{values[i], values[i]});
+    }
+}
+
+template <typename T>
+void State::journal_push(const T& entry)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto pos = m_journal.size();
+    m_journal.resize(pos + sizeof(T) + 1);
+    std::memcpy(&m_journal[pos], &entry, sizeof(T));
+    m_journal.back() = static_cast<uint8_t>(T::kind);
+}
+
+template <typename T>
+T State::journal_pop() noexcept
+{
+    assert(m_journal.size() > sizeof(T));
+    assert(m_journal.back() == static_cast<uint8_t>(T::kind));
+    const auto pos = m_journal.size() - 1 - sizeof(T);
+    T entry{};
+    std::memcpy(&entry, &m_journal[pos], sizeof(T));
+    m_journal.resize(pos);
+    return entry;
+}
+
 void State::journal_balance_change(const address& addr, const intx::uint256& prev_balance)
 {
-    m_journal.emplace_back(JournalBalanceChange{{addr}, prev_balance});
+    journal_push(JournalBalanceChange{{addr}, prev_balance});
 }
 
 void State::journal_storage_change(
     const address& addr, const bytes32& key, const StorageValue& value)
 {
-    m_journal.emplace_back(JournalStorageChange{{addr}, key, value.current, value.access_status});
+    journal_push(JournalStorageChange{{addr}, key, value.current, value.access_status});
 }
 
 void State::journal_transient_storage_change(
     const address& addr, const bytes32& key, const bytes32& value)
 {
-    m_journal.emplace_back(JournalTransientStorageChange{{addr}, key, value});
+    journal_push(JournalTransientStorageChange{{addr}, key, value});
 }
 
 void State::journal_bump_nonce(const address& addr)
 {
-    m_journal.emplace_back(JournalNonceBump{addr});
+    journal_push(JournalNonceBump{addr});
 }
 
 void State::journal_create(const address& addr, bool existed)
 {
-    m_journal.emplace_back(JournalCreate{{addr}, existed});
+    journal_push(JournalCreate{{addr}, existed});
 }
 
 void State::journal_destruct(const address& addr)
 {
-    m_journal.emplace_back(JournalDestruct{addr});
+    journal_push(JournalDestruct{addr});
 }
 
 void State::journal_access_account(const address& addr)
 {
-    m_journal.emplace_back(JournalAccessAccount{addr});
+    journal_push(JournalAccessAccount{addr});
 }
 
 void State::rollback(size_t checkpoint)
 {
+    assert(checkpoint <= m_journal.size());
     while (m_journal.size() != checkpoint)
     {
-        std::visit(
-            [this](const auto& e) {
-                using T = std::decay_t<decltype(e)>;
-                if constexpr (std::is_same_v<T, JournalNonceBump>)
-                {
-                    get(e.addr).nonce -= 1;
-                }
-                else if constexpr (std::is_same_v<T, JournalTouched>)
-                {
-                    get(e.addr).erase_if_empty = false;
-                }
-                else if constexpr (std::is_same_v<T, JournalDestruct>)
-                {
-                    get(e.addr).destructed = false;
-                }
-                else if constexpr (std::is_same_v<T, JournalAccessAccount>)
-                {
-                    get(e.addr).access_status = EVMC_ACCESS_COLD;
-                }
-                else if constexpr (std::is_same_v<T, JournalCreate>)
-                {
-                    if (e.existed)
-                    {
-                        // This account is not always "touched". TODO: Why?
-                        auto& a = get(e.addr);
-                        a.nonce = 0;
-                        a.code_hash = Account::EMPTY_CODE_HASH;
-                        a.code.clear();
-                    }
-                    else
-                    {
-                        // TODO: Before Spurious Dragon we don't clear empty accounts ("erasable")
-                        //       so we need to delete them here explicitly.
-                        //       This should be changed by tuning "erasable" flag
-                        //       and clear in all revisions.
-                        m_modified.erase(e.addr);
-                    }
-                }
-                else if constexpr (std::is_same_v<T, JournalStorageChange>)
-                {
-                    auto& s = get(e.addr).storage.find(e.key)->second;
-                    s.current = e.prev_value;
-                    s.access_status = e.prev_access_status;
-                }
-                else if constexpr (std::is_same_v<T, JournalTransientStorageChange>)
-                {
-                    auto& s = get(e.addr).transient_storage.find(e.key)->second;
-                    s = e.prev_value;
-                }
-                else if constexpr (std::is_same_v<T, JournalBalanceChange>)
-                {
-                    get(e.addr).balance = e.prev_balance;
-                }
-                else
-                {
-                    // TODO(C++23): Change condition to `false` once CWG2518 is in.
-                    static_assert(std::is_void_v<T>, "unhandled journal entry type");
-                }
-            },
-            m_journal.back());
-        m_journal.pop_back();
+        switch (static_cast<JournalKind>(m_journal.back()))
+        {
+        case JournalKind::nonce_bump:
+        {
+            const auto e = journal_pop<JournalNonceBump>();
+            get(e.addr).nonce -= 1;
+            break;
+        }
+        case JournalKind::touched:
+        {
+            const auto e = journal_pop<JournalTouched>();
+            get(e.addr).erase_if_empty = false;
+            break;
+        }
+        case JournalKind::destruct:
+        {
+            const auto e = journal_pop<JournalDestruct>();
+            get(e.addr).destructed = false;
+            break;
+        }
+        case JournalKind::access_account:
+        {
+            const auto e = journal_pop<JournalAccessAccount>();
+            get(e.addr).access_status = EVMC_ACCESS_COLD;
+            break;
+        }
+        case JournalKind::create:
+        {
+            const auto e = journal_pop<JournalCreate>();
+            if (e.existed)
+            {
+                // This account is not always "touched". TODO: Why?
+                auto& a = get(e.addr);
+                a.nonce = 0;
+                a.code_hash = Account::EMPTY_CODE_HASH;
+                a.code.reset();
+            }
+            else
+            {
+                // TODO: Before Spurious Dragon we don't clear empty accounts ("erasable")
+                //       so we need to delete them here explicitly.
+                //       This should be changed by tuning "erasable" flag
+                //       and clear in all revisions.
+                m_modified.erase(e.addr);
+            }
+            break;
+        }
+        case JournalKind::storage_change:
+        {
+            const auto e = journal_pop<JournalStorageChange>();
+            auto& s = get(e.addr).storage.find(e.key)->second;
+            s.current = e.prev_value;
+            s.access_status = e.prev_access_status;
+            break;
+        }
+        case JournalKind::transient_storage_change:
+        {
+            const auto e = journal_pop<JournalTransientStorageChange>();
+            auto& s = get(e.addr).transient_storage.find(e.key)->second;
+            s = e.prev_value;
+            break;
+        }
+        case JournalKind::balance_change:
+        {
+            const auto e = journal_pop<JournalBalanceChange>();
+            get(e.addr).balance = e.prev_balance;
+            break;
+        }
+        }
     }
 }
 
@@ -417,10 +492,25 @@ StateDiff finalize(const StateView& state_view, evmc_revision rev, const address
 
 std::variant<TransactionReceipt, std::error_code> transition(const StateView& state_view,
     const BlockInfo& block, const Transaction& tx, evmc_revision rev, evmc::VM& vm,
-    int64_t block_gas_left, int64_t blob_gas_left)
+    int64_t block_gas_left, int64_t blob_gas_left, AccessRecord* access_record)
 {
+    // Start loading everything the transaction is known to access in the background.
+    std::vector<address> known_accounts{tx.sender, block.coinbase};
+    if (tx.to.has_value())
+        known_accounts.emplace_back(*tx.to);
+    std::vector<std::pair<address, bytes32>> known_storage;
+    for (const auto& [a, storage_keys] : tx.access_list)
+    {
+        known_accounts.emplace_back(a);
+        for (const auto& key : storage_keys)
+            known_storage.emplace_back(a, key);
+    }
+    state_view.prefetch(known_accounts, known_storage);
+
     State state{state_view};
     auto* sender_ptr = state.find(tx.sender);
+    if (access_record != nullptr)
+        access_record->accounts_read.insert(tx.sender);
 
     // Validate transaction. The validation needs the sender account, so in case
     // it doesn't exist provide an empty one. The account isn't created in the state
@@ -436,6 +526,11 @@ std::variant<TransactionReceipt, std::error_code> transition(const StateView& st
     // The account won't be empty because its nonce will be bumped.
     auto& sender_acc = (sender_ptr != nullptr) ? *sender_ptr : state.insert(tx.sender);
 
+    // Pre-warm the state with the rest of the known accounts and storage entries.
+    state.preload(std::span{known_accounts}.subspan(1), known_storage);
+    if (access_record != nullptr)
+        access_record->accounts_written.insert(tx.sender);
+
     assert(sender_acc.nonce < Account::NonceMax);  // Checked in transaction validation
     ++sender_acc.nonce;                            // Bump sender nonce.
 
@@ -477,6 +572,8 @@ std::variant<TransactionReceipt, std::error_code> transition(const StateView& st
     if (rev >= EVMC_SHANGHAI)
         host.access_account(block.coinbase);
 
+    // The warming above doesn't depend on the state so the recording starts here.
+    host.record_accesses(access_record);
     const auto result = host.call(build_message(tx, execution_gas_limit, rev));
 
     auto gas_used = tx.gas_limit - result.gas_left;
@@ -489,6 +586,8 @@ std::variant<TransactionReceipt, std::error_code> transition(const StateView& st
 
     sender_acc.balance += tx_max_cost - gas_used * effective_gas_price;
     state.touch(block.coinbase).balance += gas_used * priority_gas_price;
+    if (access_record != nullptr)
+        access_record->accounts_written.insert(block.coinbase);
 
     // Cumulative gas used is unknown in this scope.
     TransactionReceipt receipt{
@@ -16,10 +16,24 @@
 namespace evmone::state
 {
 class StateView;
+struct AccessRecord;
 
 /// The Ethereum State: the collection of accounts mapped by their addresses.
 class State
 {
+    /// The kind of the journal entry. Stored in the journal as the last byte of every entry.
+    enum class JournalKind : uint8_t
+    {
+        balance_change,
+        touched,
+        storage_change,
+        transient_storage_change,
+        nonce_bump,
+        create,
+        destruct,
+        access_account,
+    };
+
     struct JournalBase
     {
         address addr;
@@ -27,14 +41,18 @@ class State
 
     struct JournalBalanceChange : JournalBase
     {
+        static constexpr auto kind = JournalKind::balance_change;
         intx::uint256 prev_balance;
     };
 
     struct JournalTouched : JournalBase
-    {};
+    {
+        static constexpr auto kind = JournalKind::touched;
+    };
 
     struct JournalStorageChange : JournalBase
     {
+        static constexpr auto kind = JournalKind::storage_change;
         bytes32 key;
         bytes32 prev_value;
         evmc_access_status prev_access_status;
@@ -42,40 +60,61 @@ class State
 
     struct JournalTransientStorageChange : JournalBase
     {
+        static constexpr auto kind = JournalKind::transient_storage_change;
         bytes32 key;
         bytes32 prev_value;
     };
 
     struct JournalNonceBump : JournalBase
-    {};
+    {
+        static constexpr auto kind = JournalKind::nonce_bump;
+    };
 
     struct JournalCreate : JournalBase
     {
+        static constexpr auto kind = JournalKind::create;
         bool existed;
     };
 
     struct JournalDestruct : JournalBase
-    {};
+    {
+        static constexpr auto kind = JournalKind::destruct;
+    };
 
     struct JournalAccessAccount : JournalBase
-    {};
-
-    using JournalEntry =
-        std::variant<JournalBalanceChange, JournalTouched, JournalStorageChange, JournalNonceBump,
-            JournalCreate, JournalTransientStorageChange, JournalDestruct, JournalAccessAccount>;
+    {
+        static constexpr auto kind = JournalKind::access_account;
+    };
 
     /// The read-only view of the initial (cold) state.
     const StateView& m_initial;
 
+    /// The store of the account code, see StateView::code_store(). May be null.
+    CodeStore* const m_code_store;
+
     /// The accounts loaded from the initial state and potentially modified.
     std::unordered_map<address, Account> m_modified;
 
     /// The state journal: the list of changes made to the state
     /// with information how to revert them.
-    std::vector<JournalEntry> m_journal;
+    ///
+    /// The entries of different sizes are tightly packed in the byte buffer.
+    /// Every entry is followed by its JournalKind byte so the journal can be
+    /// unwound from the back without any per-entry size overhead.
+    std::vector<uint8_t> m_journal;
+
+    /// Appends the entry to the journal.
+    template <typename T>
+    void journal_push(const T& entry);
+
+    /// Removes the last entry (it must be of type T) from the journal and returns it.
+    template <typename T>
+    T journal_pop() noexcept;
 
 public:
-    explicit State(const StateView& state_view) noexcept : m_initial{state_view} {}
+    explicit State(const StateView& state_view) noexcept
+      : m_initial{state_view}, m_code_store{state_view.code_store()}
+    {}
     State(const State&) = delete;
     State(State&&) = delete;
     State& operator=(State&&) = delete;
@@ -95,12 +134,23 @@ public:
 
     bytes_view get_code(const address& addr);
 
+    /// Returns the code of the account already looked up with find() or get().
+    bytes_view get_code(const address& addr, Account& acc);
+
+    /// Returns the shared code entry for the new code with the given hash.
+    std::shared_ptr<const CodeStore::Entry> store_code(const bytes32& code_hash, bytes&& code);
+
     StorageValue& get_storage(const address& addr, const bytes32& key);
 
+    /// Loads the existing accounts and their storage entries from the initial state
+    /// with the batch StateView methods. The already loaded accounts and entries are kept.
+    void preload(std::span<const address> addrs, std::span<const std::pair<address, bytes32>> keys);
+
     StateDiff build_diff(evmc_revision rev) const;
 
     /// Returns the state journal checkpoint. It can be later used to in rollback()
     /// to revert changes newer than the checkpoint.
+    /// The value is opaque: it is the journal size in bytes, not the number of entries.
     [[nodiscard]] size_t checkpoint() const noexcept { return m_journal.size(); }
 
     /// Reverts state changes made after the checkpoint.
@@ -138,9 +188,13 @@ public:
     const address& coinbase, std::optional<uint64_t> block_reward, std::span<const Ommer> ommers,
     std::span<const Withdrawal> withdrawals);
 
+/// Executes the transaction.
+///
+/// The state accesses are recorded in the access_record if not null: the sender and the coinbase
+/// fee payment by the transaction itself, and everything else accessed during the execution.
 [[nodiscard]] std::variant<TransactionReceipt, std::error_code> transition(const StateView& state,
     const BlockInfo& block, const Transaction& tx, evmc_revision rev, evmc::VM& vm,
-    int64_t block_gas_left, int64_t blob_gas_left);
+    int64_t block_gas_left, int64_t blob_gas_left, AccessRecord* access_record = nullptr);
 
 std::variant<int64_t, std::error_code> validate_transaction(const Account& sender_acc,
     const BlockInfo& block, const Transaction& tx, evmc_revision rev, int64_t block_gas_left,
@@ -43,7 +43,9 @@ struct StateDiff
 
     /// List of deleted accounts.
     ///
-    /// This list doesn't have common addresses with modified_accounts.
+    /// The deletions are applied before the modifications. An address is also
+    /// in modified_accounts only if the account has been deleted and then created again,
+    /// e.g. in the diff of multiple transactions.
     /// Note that from the Cancun revision (because of the modification to the SELFDESTRUCT)
     /// accounts cannot be deleted and this list is always empty.
     std::vector<address> deleted_accounts;
@@ -0,0 +1,156 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "state_snapshot.hpp"
+#include "account.hpp"
+#include "hash_utils.hpp"
+#include "state_diff.hpp"
+#include <algorithm>
+
+namespace evmone::state
+{
+namespace
+{
+constexpr auto EMPTY_CODE_HASH = Account::EMPTY_CODE_HASH;
+}  // namespace
+
+/// The single layer of state changes. Never modified after being pushed on a snapshot.
+struct StateSnapshot::Layer
+{
+    /// The state of an account modified in this layer.
+    struct Entry
+    {
+        /// The account has been deleted. The other fields are not used.
+        bool deleted = false;
+
+        /// The account has been deleted and then created again in this layer.
+        /// The code and storage from the previous layers are not inherited.
+        bool recreated = false;
+
+        uint64_t nonce = 0;
+        uint256 balance;
+        bytes32 code_hash = EMPTY_CODE_HASH;
+        bool has_storage = false;
+
+        /// The new code. Empty if the code has not been changed in this layer.
+        bytes code;
+
+        /// The storage entries modified in this layer. The value 0 means the entry is deleted.
+        std::unordered_map<bytes32, bytes32> storage;
+    };
+
+    /// The previous layer. Null for the first layer on top of the base state.
+    std::shared_ptr<const Layer> parent;
+
+    /// The number of layers including this one.
+    size_t depth = 0;
+
+    std::unordered_map<address, Entry> accounts;
+
+    [[nodiscard]] const Entry* find(const address& addr) const noexcept
+    {
+        const auto it = accounts.find(addr);
+        return it != accounts.end() ? &it->second : nullptr;
+    }
+};
+
+StateSnapshot::StateSnapshot(const StateView& base) noexcept : m_base{&base} {}
+
+StateSnapshot::StateSnapshot(const StateView& base, std::shared_ptr<const Layer> top) noexcept
+  : m_base{&base}, m_top{std::move(top)}
+{}
+
+size_t StateSnapshot::depth() const noexcept
+{
+    return m_top != nullptr ? m_top->depth : 0;
+}
+
+StateSnapshot StateSnapshot::apply(const StateDiff& diff) const
+{
+    auto layer = std::make_shared<Layer>();
+    layer->parent = m_top;
+    layer->depth = depth() + 1;
+
+    for (const auto& addr : diff.deleted_accounts)
+        layer->accounts[addr] = {.deleted = true};
+
+    for (const auto& m : diff.modified_accounts)
+    {
+        auto& e = layer->accounts[m.addr];
+        const auto recreated = e.deleted;
+        const auto prev = recreated ? std::nullopt : get_account(m.addr);
+        e.deleted = false;
+        e.recreated = recreated;
+        e.nonce = m.nonce;
+        e.balance = m.balance;
+        if (!m.code.empty())
+        {
+            e.code = m.code;
+            e.code_hash = keccak256(m.code);
+        }
+        else if (prev.has_value())
+            e.code_hash = prev->code_hash;
+
+        // The flag is exact unless the account already had storage: the layer only knows
+        // the modified entries, so it cannot tell if the deletions have emptied the storage
+        // and the flag stays set. This does not change the only use of the flag,
+        // the address collision check of contract creation (EIP-7610): the storage is
+        // only written by the account's own code, so the account has been created
+        // by a contract creation and its nonce is non-zero, which is a collision anyway.
+        e.has_storage = (prev.has_value() && prev->has_storage) ||
+                        std::ranges::any_of(m.modified_storage,
+                            [](const auto& kv) noexcept { return !is_zero(kv.second); });
+        e.storage.insert(m.modified_storage.begin(), m.modified_storage.end());
+    }
+
+    return StateSnapshot{*m_base, std::move(layer)};
+}
+
+std::optional<StateView::Account> StateSnapshot::get_account(const address& addr) const noexcept
+{
+    for (const auto* l = m_top.get(); l != nullptr; l = l->parent.get())
+    {
+        if (const auto* e = l->find(addr); e != nullptr)
+        {
+            if (e->deleted)
+                return std::nullopt;
+            return Account{e->nonce, e->balance, e->code_hash, e->has_storage};
+        }
+    }
+    return m_base->get_account(addr);
+}
+
+bytes StateSnapshot::get_account_code(const address& addr) const noexcept
+{
+    for (const auto* l = m_top.get(); l != nullptr; l = l->parent.get())
+    {
+        if (const auto* e = l->find(addr); e != nullptr)
+        {
+            if (e->deleted || e->code_hash == EMPTY_CODE_HASH)
+                return {};
+            if (!e->code.empty())
+                return e->code;
+            // The code has not been changed in this layer, continue with the previous one.
+        }
+    }
+    return m_base->get_account_code(addr);
+}
+
+bytes32 StateSnapshot::get_storage(const address& addr, const bytes32& key) const noexcept
+{
+    for (const auto* l = m_top.get(); l != nullptr; l = l->parent.get())
+    {
+        if (const auto* e = l->find(addr); e != nullptr)
+        {
+            if (e->deleted)
+                return {};
+            if (const auto it = e->storage.find(key); it != e->storage.end())
+                return it->second;
+            if (e->recreated)
+                return {};
+        }
+    }
+    return m_base->get_storage(addr, key);
+}
+}  // namespace evmone::state
@@ -0,0 +1,54 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "state_view.hpp"
+#include <memory>
+
+namespace evmone::state
+{
+struct StateDiff;
+
+/// The immutable snapshot of the state at a transaction boundary.
+///
+/// The snapshot is a persistent stack of state changes (StateDiff layers) on top of
+/// the base StateView. Copying a snapshot is O(1) and shares all the layers with the original,
+/// so a block builder can fork the state after any transaction, execute different continuations
+/// (e.g. in parallel threads) and discard the losing branches by dropping the snapshots.
+///
+/// The layers are never modified once created. Concurrent reads from snapshots are safe
+/// as long as the base StateView is safe for concurrent reads.
+/// The base StateView must outlive all snapshots created on top of it.
+///
+/// The lookups walk the layers from the top so very long chains of snapshots should be
+/// committed to the base state from time to time (e.g. at a block boundary).
+class StateSnapshot : public StateView
+{
+    struct Layer;
+
+    /// The base (oldest) state.
+    const StateView* m_base = nullptr;
+
+    /// The most recent layer of state changes. Null if there are no changes on top of the base.
+    std::shared_ptr<const Layer> m_top;
+
+    StateSnapshot(const StateView& base, std::shared_ptr<const Layer> top) noexcept;
+
+public:
+    /// Creates the snapshot of the base state without any changes.
+    explicit StateSnapshot(const StateView& base) noexcept;
+
+    /// Returns the new snapshot with the state changes applied on top of this snapshot.
+    ///
+    /// This snapshot is not modified. The cost is proportional to the size of the diff.
+    [[nodiscard]] StateSnapshot apply(const StateDiff& diff) const;
+
+    /// Returns the number of layers of state changes on top of the base state.
+    [[nodiscard]] size_t depth() const noexcept;
+
+    std::optional<Account> get_account(const address& addr) const noexcept override;
+    bytes get_account_code(const address& addr) const noexcept override;
+    bytes32 get_storage(const address& addr, const bytes32& key) const noexcept override;
+};
+}  // namespace evmone::state
@@ -6,6 +6,9 @@
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
 #include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace evmone::state
 {
@@ -14,6 +17,8 @@ using evmc::bytes;
 using evmc::bytes32;
 using intx::uint256;
 
+class CodeStore;
+
 class StateView
 {
 public:
@@ -25,9 +30,50 @@ public:
         bool has_storage = false;
     };
 
+    /// The storage entry key: (address, key).
+    using StorageKey = std::pair<address, bytes32>;
+
     virtual ~StateView() = default;
     virtual std::optional<Account> get_account(const address& addr) const noexcept = 0;
     virtual bytes get_account_code(const address& addr) const noexcept = 0;
     virtual bytes32 get_storage(const address& addr, const bytes32& key) const noexcept = 0;
+
+    /// Gets the accounts at the given addresses, in the same order.
+    ///
+    /// The implementations with expensive individual lookups (e.g. disk-backed)
+    /// should override it to load the accounts at once.
+    virtual std::vector<std::optional<Account>> get_accounts(
+        std::span<const address> addrs) const noexcept
+    {
+        std::vector<std::optional<Account>> accounts;
+        accounts.reserve(addrs.size());
+        for (const auto& addr : addrs)
+            accounts.emplace_back(get_account(addr));
+        return accounts;
+    }
+
+    /// Gets the values of the given storage entries, in the same order.
+    ///
+    /// See get_accounts().
+    virtual std::vector<bytes32> get_storage_batch(std::span<const StorageKey> keys) const noexcept
+    {
+        std::vector<bytes32> values;
+        values.reserve(keys.size());
+        for (const auto& [addr, key] : keys)
+            values.emplace_back(get_storage(addr, key));
+        return values;
+    }
+
+    /// Hints that the accounts and the storage entries are going to be read soon.
+    ///
+    /// It must not block: the implementation may start loading the data asynchronously
+    /// so that the following reads are served without waiting. Does nothing by default.
+    virtual void prefetch([[maybe_unused]] std::span<const address> addrs,
+        [[maybe_unused]] std::span<const StorageKey> keys) const noexcept
+    {}
+
+    /// Returns the store to share the account code through, e.g. between the transactions
+    /// executed on this state. Null by default: then every State loads the code on its own.
+    virtual CodeStore* code_store() const noexcept { return nullptr; }
 };
 }  // namespace evmone::state
@@ -29,6 +29,9 @@ bytes TestState::get_account_code(const address& addr) const noexcept
 
 void TestState::apply(const state::StateDiff& diff)
 {
+    for (const auto& addr : diff.deleted_accounts)
+        erase(addr);
+
     for (const auto& m : diff.modified_accounts)
     {
         auto& a = (*this)[m.addr];
@@ -44,9 +47,6 @@ void TestState::apply(const state::StateDiff& diff)
                 a.storage.erase(k);
         }
     }
-
-    for (const auto& addr : diff.deleted_accounts)
-        erase(addr);
 }
 
 bytes32 TestState::get_storage(const address& addr, const bytes32& key) const noexcept
@@ -3,10 +3,12 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "code_store.hpp"
 #include "state_view.hpp"
 #include <evmc/evmc.hpp>
 #include <intx/intx.hpp>
 #include <map>
+#include <memory>
 #include <span>
 #include <variant>
 
@@ -47,12 +49,17 @@ struct TestAccount
 /// and is also easier to work with in tests.
 class TestState : public state::StateView, public std::map<address, TestAccount>
 {
+    /// The store of the code loaded by the States executing on this state.
+    /// The copies share it: the entries are identified by the code hash.
+    std::shared_ptr<state::CodeStore> m_code_store = std::make_shared<state::CodeStore>();
+
 public:
     using map::map;
 
     std::optional<Account> get_account(const address& addr) const noexcept override;
     bytes get_account_code(const address& addr) const noexcept override;
     bytes32 get_storage(const address& addr, const bytes32& key) const noexcept override;
+    state::CodeStore* code_store() const noexcept override { return m_code_store.get(); }
 
     /// Inserts new account to the state.
     ///
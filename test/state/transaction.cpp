@@ -4,8 +4,9 @@
 
 #include "transaction.hpp"
 #include "../utils/stdx/utility.hpp"
+#include "hash_utils.hpp"
 #include "rlp.hpp"
-
+#include <evmone_precompiles/secp256k1.hpp>
 
 namespace evmone::state
 {
@@ -80,4 +81,109 @@ namespace evmone::state
                             bytes_view(receipt.logs_bloom_filter), receipt.logs);
     }
 }
+
+hash256 signing_hash(const Transaction& tx)
+{
+    assert(tx.type <= Transaction::Type::blob);
+
+    const auto gas_limit = static_cast<uint64_t>(tx.gas_limit);
+    const auto to = tx.to.has_value() ? tx.to.value() : bytes_view();
+
+    if (tx.type == Transaction::Type::legacy)
+    {
+        // EIP-155: rlp [nonce, gas_price, gas_limit, to, value, data, chain_id, 0, 0].
+        if (tx.v >= 35)
+        {
+            return keccak256(rlp::encode_tuple(tx.nonce, tx.max_gas_price, gas_limit, to,
+                tx.value, tx.data, tx.chain_id, uint64_t{0}, uint64_t{0}));
+        }
+        // rlp [nonce, gas_price, gas_limit, to, value, data].
+        return keccak256(
+            rlp::encode_tuple(tx.nonce, tx.max_gas_price, gas_limit, to, tx.value, tx.data));
+    }
+    else if (tx.type == Transaction::Type::access_list)
+    {
+        return keccak256(bytes{0x01} + rlp::encode_tuple(tx.chain_id, tx.nonce, tx.max_gas_price,
+                                           gas_limit, to, tx.value, tx.data, tx.access_list));
+    }
+    else if (tx.type == Transaction::Type::eip1559)
+    {
+        return keccak256(
+            bytes{0x02} + rlp::encode_tuple(tx.chain_id, tx.nonce, tx.max_priority_gas_price,
+                              tx.max_gas_price, gas_limit, to, tx.value, tx.data, tx.access_list));
+    }
+    else  // Transaction::Type::blob
+    {
+        return keccak256(bytes{stdx::to_underlying(Transaction::Type::blob)} +
+                         rlp::encode_tuple(tx.chain_id, tx.nonce, tx.max_priority_gas_price,
+                             tx.max_gas_price, gas_limit, to, tx.value, tx.data, tx.access_list,
+                             tx.max_blob_gas_price, tx.blob_hashes));
+    }
+}
+
+namespace
+{
+/// Returns the input of the sender public key recovery from the transaction signature
+/// or std::nullopt if the signature values are invalid in the given revision.
+std::optional<evmmax::secp256k1::EcrecoverInput> sender_recovery_input(
+    const Transaction& tx, evmc_revision rev)
+{
+    bool y_parity = false;
+    if (tx.type == Transaction::Type::legacy)
+    {
+        if (tx.v == 27 || tx.v == 28)
+            y_parity = tx.v == 28;
+        else if (rev >= EVMC_SPURIOUS_DRAGON && tx.v >= 35 &&
+                 static_cast<uint64_t>(tx.v - 35) / 2 == tx.chain_id)  // EIP-155.
+            y_parity = (tx.v - 35) % 2 == 1;
+        else
+            return std::nullopt;
+    }
+    else
+    {
+        if (tx.v > 1)
+            return std::nullopt;
+        y_parity = tx.v == 1;
+    }
+
+    // EIP-2: the signatures with s-value greater than N/2 are invalid.
+    if (rev >= EVMC_HOMESTEAD && tx.s > evmmax::secp256k1::Order / 2)
+        return std::nullopt;
+
+    return evmmax::secp256k1::EcrecoverInput{
+        std::bit_cast<ethash::hash256>(signing_hash(tx)), tx.r, tx.s, y_parity};
+}
+}  // namespace
+
+std::optional<address> recover_sender(const Transaction& tx, evmc_revision rev)
+{
+    const auto input = sender_recovery_input(tx, rev);
+    if (!input.has_value())
+        return std::nullopt;
+    return evmmax::secp256k1::ecrecover(input->hash, input->r, input->s, input->v);
+}
+
+std::vector<std::optional<address>> recover_sender_batch(
+    std::span<const Transaction> txs, evmc_revision rev)
+{
+    std::vector<evmmax::secp256k1::EcrecoverInput> inputs;
+    std::vector<size_t> indexes;
+    inputs.reserve(txs.size());
+    indexes.reserve(txs.size());
+    for (size_t i = 0; i < txs.size(); ++i)
+    {
+        if (const auto input = sender_recovery_input(txs[i], rev); input.has_value())
+        {
+            inputs.push_back(*input);
+            indexes.push_back(i);
+        }
+    }
+
+    const auto recovered = evmmax::secp256k1::ecrecover_batch(inputs);
+
+    std::vector<std::optional<address>> senders(txs.size());
+    for (size_t j = 0; j < recovered.size(); ++j)
+        senders[indexes[j]] = recovered[j];
+    return senders;
+}
 }  // namespace evmone::state
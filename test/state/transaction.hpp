@@ -8,6 +8,7 @@
 #include "state_diff.hpp"
 #include <intx/intx.hpp>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace evmone::state
@@ -105,4 +106,22 @@ struct TransactionReceipt
 
 /// Defines how to RLP-encode a Log.
 [[nodiscard]] bytes rlp_encode(const Log& log);
+
+/// Computes the hash of the transaction data signed by the sender.
+///
+/// This is the hash of the RLP encoding without the signature, extended
+/// with the chain id for the EIP-155 legacy transactions.
+[[nodiscard]] hash256 signing_hash(const Transaction& tx);
+
+/// Recovers the transaction sender address from the transaction signature.
+///
+/// Returns std::nullopt if the signature is invalid in the given revision.
+[[nodiscard]] std::optional<address> recover_sender(const Transaction& tx, evmc_revision rev);
+
+/// Recovers the senders of multiple transactions.
+///
+/// This is equivalent to recover_sender() for each transaction, but the signature recoveries
+/// share the inversions (see evmmax::secp256k1::ecrecover_batch()).
+[[nodiscard]] std::vector<std::optional<address>> recover_sender_batch(
+    std::span<const Transaction> txs, evmc_revision rev);
 }  // namespace evmone::state
@@ -0,0 +1,71 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "tx_preparation.hpp"
+#include "parallel_for.hpp"
+#include "precompiles.hpp"
+#include "rlp.hpp"
+#include "state.hpp"
+#include <algorithm>
+
+namespace evmone::state
+{
+std::vector<PreparedTransaction> prepare_transactions(
+    std::span<const Transaction> txs, evmc_revision rev, bool recover_senders, size_t num_threads)
+{
+    // The maximum number of transactions a worker takes at once.
+    // The sender recoveries of these share the inversions, see recover_sender_batch().
+    static constexpr size_t MAX_CHUNK_SIZE = 16;
+
+    std::vector<PreparedTransaction> prepared(txs.size());
+
+    const auto num_workers = std::max(std::min(num_threads, txs.size()), size_t{1});
+    const auto chunk_size = std::clamp((txs.size() + num_workers - 1) / num_workers, size_t{1},
+        MAX_CHUNK_SIZE);
+    const auto num_chunks = (txs.size() + chunk_size - 1) / chunk_size;
+
+    parallel_for(num_chunks, num_threads, [&](size_t c) {
+        const auto begin = c * chunk_size;
+        const auto chunk = txs.subspan(begin, std::min(chunk_size, txs.size() - begin));
+        for (size_t i = 0; i < chunk.size(); ++i)
+        {
+            const auto& tx = chunk[i];
+            auto& p = prepared[begin + i];
+            p.rlp = rlp::encode(tx);
+            p.hash = keccak256(p.rlp);
+        }
+
+        if (recover_senders)
+        {
+            const auto senders = recover_sender_batch(chunk, rev);
+            for (size_t i = 0; i < chunk.size(); ++i)
+                prepared[begin + i].sender = senders[i];
+        }
+    });
+
+    return prepared;
+}
+
+void prevalidate_point_evaluations(std::span<const Transaction> txs, evmc_revision rev)
+{
+    static constexpr address POINT_EVALUATION_ADDRESS{
+        stdx::to_underlying(PrecompileId::point_evaluation)};
+
+    // Drop the results of the previous block so the batch doesn't grow without bounds.
+    auto& batch = PointEvaluationBatch::local();
+    batch.clear();
+
+    if (rev < EVMC_CANCUN)
+        return;
+
+    std::vector<bytes_view> inputs;
+    for (const auto& tx : txs)
+    {
+        if (tx.to == POINT_EVALUATION_ADDRESS)
+            inputs.emplace_back(tx.data);
+    }
+    if (!inputs.empty())
+        batch.prevalidate(inputs);
+}
+}  // namespace evmone::state
@@ -0,0 +1,45 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "transaction.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace evmone::state
+{
+/// The transaction data which doesn't depend on the state,
+/// computed ahead of the sequential execution of the block.
+struct PreparedTransaction
+{
+    /// The RLP encoding of the transaction: the leaf of the transactions trie.
+    bytes rlp;
+
+    /// The transaction hash: the Keccak-256 hash of the RLP encoding.
+    hash256 hash;
+
+    /// The sender recovered from the signature.
+    /// Empty if the signature is invalid or the recovery hasn't been requested.
+    std::optional<address> sender;
+};
+
+/// Prepares the transactions of a block for the execution.
+///
+/// This is the first stage of the block execution pipeline. The transactions are independent here,
+/// so they are processed in parallel by num_threads threads (including the calling one):
+/// RLP encoding and hashing and, if requested, the sender recovery from the signature
+/// (the most expensive part). The threads take the transactions in chunks and recover
+/// the senders of a chunk in a batch. The second stage is the sequential execution:
+/// the recovered senders are meant to replace Transaction::sender before it starts.
+[[nodiscard]] std::vector<PreparedTransaction> prepare_transactions(
+    std::span<const Transaction> txs, evmc_revision rev, bool recover_senders, size_t num_threads);
+
+/// Pre-validates the KZG proofs of the transactions calling the point evaluation precompile
+/// directly, in a batch (see PointEvaluationBatch).
+///
+/// The results are used by the precompile calls executed later by the calling thread.
+/// The results of the previous call (i.e. of the previous block) are dropped.
+void prevalidate_point_evaluations(std::span<const Transaction> txs, evmc_revision rev);
+}  // namespace evmone::state
@@ -2,10 +2,13 @@
 // Copyright 2023 The evmone Authors.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "../state/block_commitments.hpp"
 #include "../state/errors.hpp"
 #include "../state/ethash_difficulty.hpp"
 #include "../state/mpt_hash.hpp"
 #include "../state/rlp.hpp"
+#include "../state/speculative_execution.hpp"
+#include "../state/tx_preparation.hpp"
 #include "../statetest/statetest.hpp"
 #include "../utils/utils.hpp"
 #include <evmone/evmone.h>
@@ -35,6 +38,10 @@ int main(int argc, const char* argv[])
     std::optional<uint64_t> block_reward;
     uint64_t chain_id = 0;
     bool trace = false;
+    uint64_t jobs = 1;
+    // Execute the transactions with the senders recovered from the signatures
+    // instead of the ones from the input and reject the ones with invalid signatures.
+    bool recover_senders = false;
 
     try
     {
@@ -72,6 +79,10 @@ int main(int argc, const char* argv[])
                 output_body_file = argv[i];
             else if (arg == "--trace")
                 trace = true;
+            else if (arg == "--jobs" && ++i < argc)
+                jobs = intx::from_string<uint64_t>(argv[i]);
+            else if (arg == "--recover-senders")
+                recover_senders = true;
         }
 
         state::BlockInfo block;
@@ -113,6 +124,7 @@ int main(int argc, const char* argv[])
         int64_t cumulative_gas_used = 0;
         int64_t blob_gas_left = state::BlockInfo::MAX_BLOB_GAS_PER_BLOCK;
         std::vector<state::Transaction> transactions;
+        std::vector<bytes> encoded_transactions;
         std::vector<state::TransactionReceipt> receipts;
         int64_t block_gas_left = block.gas_limit;
 
@@ -135,12 +147,41 @@ int main(int argc, const char* argv[])
 
                 test::system_call(state, block, rev, vm);
 
-                for (size_t i = 0; i < j_txs.size(); ++i)
+                std::vector<state::Transaction> txs;
+                txs.reserve(j_txs.size());
+                for (const auto& j_tx : j_txs)
                 {
-                    auto tx = test::from_json<state::Transaction>(j_txs[i]);
+                    auto& tx = txs.emplace_back(test::from_json<state::Transaction>(j_tx));
                     tx.chain_id = chain_id;
+                }
 
-                    const auto computed_tx_hash = keccak256(rlp::encode(tx));
+                // Hash the transactions and, if requested, recover the senders in parallel.
+                const auto prepared = state::prepare_transactions(txs, rev, recover_senders,
+                    static_cast<size_t>(std::max(jobs, uint64_t{1})));
+                for (size_t i = 0; i < txs.size(); ++i)
+                {
+                    if (prepared[i].sender.has_value())
+                        txs[i].sender = *prepared[i].sender;
+                }
+                state::prevalidate_point_evaluations(txs, rev);
+
+                // Execute transactions speculatively in parallel. Tracing requires
+                // the sequential execution to redirect the trace output per transaction.
+                std::vector<SpeculativeTransition> speculations;
+                if (!trace && jobs > 1 && txs.size() > 1)
+                {
+                    std::vector<evmc::VM> workers;
+                    workers.reserve(jobs);
+                    for (uint64_t w = 0; w < jobs; ++w)
+                        workers.emplace_back(evmc_create_evmone());
+                    speculations = speculate(state, block, txs, rev, workers);
+                }
+
+                for (size_t i = 0; i < j_txs.size(); ++i)
+                {
+                    auto& tx = txs[i];
+
+                    const auto& computed_tx_hash = prepared[i].hash;
                     const auto computed_tx_hash_str = hex0x(computed_tx_hash);
 
                     if (j_txs[i].contains("hash"))
@@ -168,8 +209,16 @@ int main(int argc, const char* argv[])
                         std::clog.rdbuf(trace_file_output.rdbuf());
                     }
 
-                    auto res =
-                        test::transition(state, block, tx, rev, vm, block_gas_left, blob_gas_left);
+                    std::variant<state::TransactionReceipt, std::error_code> res =
+                        make_error_code(state::INVALID_SIGNATURE);
+                    if (!recover_senders || prepared[i].sender.has_value())
+                    {
+                        res = speculations.empty() ?
+                                  test::transition(
+                                      state, block, tx, rev, vm, block_gas_left, blob_gas_left) :
+                                  test::transition(state, block, tx, rev, vm, block_gas_left,
+                                      blob_gas_left, std::move(speculations[i]));
+                    }
 
                     if (holds_alternative<std::error_code>(res))
                     {
@@ -206,6 +255,7 @@ int main(int argc, const char* argv[])
                         j_receipt["transactionIndex"] = hex0x(i);
                         blob_gas_left -= tx.blob_gas_used();
                         transactions.emplace_back(std::move(tx));
+                        encoded_transactions.emplace_back(prepared[i].rlp);
                         block_gas_left -= receipt.gas_used;
                         receipts.emplace_back(std::move(receipt));
                     }
@@ -223,12 +273,14 @@ int main(int argc, const char* argv[])
             j_result["stateRoot"] = hex0x(state::mpt_hash(state));
         }
 
-        j_result["logsBloom"] = hex0x(compute_bloom_filter(receipts));
-        j_result["receiptsRoot"] = hex0x(state::mpt_hash(receipts));
+        const auto commitments = state::compute_block_commitments(encoded_transactions, receipts,
+            block.withdrawals, static_cast<size_t>(std::max(jobs, uint64_t{1})));
+        j_result["logsBloom"] = hex0x(commitments.logs_bloom);
+        j_result["receiptsRoot"] = hex0x(commitments.receipts_root);
         if (rev >= EVMC_SHANGHAI)
-            j_result["withdrawalsRoot"] = hex0x(state::mpt_hash(block.withdrawals));
+            j_result["withdrawalsRoot"] = hex0x(commitments.withdrawals_root);
 
-        j_result["txRoot"] = hex0x(state::mpt_hash(transactions));
+        j_result["txRoot"] = hex0x(commitments.transactions_root);
         j_result["gasUsed"] = hex0x(cumulative_gas_used);
         if (rev >= EVMC_CANCUN)
         {
@@ -151,7 +151,7 @@ TEST(evmmax, bn254_pt_add)
 
 TEST(evmmax, inv_1)
 {
-    const evmmax::ModArith<uint256> m{evmmax::bn254::FieldPrime};
+    const evmmax::bn254::FieldArith m{evmmax::bn254::FieldPrime};
 
     const auto a =
         m.to_mont(0x6e140df17432311190232a91a38daed3ee9ed7f038645dd0278da7ca6e497de_u256);
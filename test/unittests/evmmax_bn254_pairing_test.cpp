@@ -0,0 +1,76 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "evmone_precompiles/bn254.hpp"
+#include <gtest/gtest.h>
+#include <test/utils/utils.hpp>
+
+using namespace evmmax::bn254;
+using namespace evmone::test;
+
+namespace
+{
+/// Decodes the ECPAIRING precompile input: the sequence of the (G1, G2) points pairs.
+std::vector<std::pair<Point, ExtPoint>> decode_pairs(bytes_view input)
+{
+    std::vector<std::pair<Point, ExtPoint>> pairs;
+    for (size_t i = 0; i + 192 <= input.size(); i += 192)
+    {
+        const auto load = [p = &input[i]](size_t offset) {
+            return intx::be::unsafe::load<uint256>(&p[offset]);
+        };
+        pairs.emplace_back(Point{load(0), load(32)},
+            ExtPoint{{load(96), load(64)}, {load(160), load(128)}});
+    }
+    return pairs;
+}
+
+struct TestCase
+{
+    bytes input;
+    std::optional<bool> expected_result;
+};
+
+const TestCase test_cases[] = {
+    // e(3⋅G1, 5⋅G2) ⋅ e(-15⋅G1, G2) = 1
+    {"0769bf9ac56bea3ff40232bcb1b6bd159315d84715b8e679f2d355961915abf02ab799bee0489429554fdb7c8d086475319e63b40b9c5b57cdf1ff3dd9fe22610a09ccf561b55fd99d1c1208dee1162457b57ac5af3759d50671e510e428b2a12e539c423b302d13f4e5773c603948eaf5db5df8ae8a9a9113708390a06410d819b763513924a736e4eebd0d78c91c1bc1d657fee4214057d21414011cfcc7632f8d9f9ab83727c77a2fec063cb7b6e5eb23044ccf535ad49d46d394fb6f6bf62d96b121486ab9da7bf549e57d2f8a6cc1983a336903524fb05dcd507457f63c129908ffc7b7d5f3d871fc120a9ee4bbe5b7b56329a7a79259a7467db7a25564198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c21800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa"_hex,
+        true},
+    // e(3⋅G1, 5⋅G2) ⋅ e(15⋅G1, G2) ≠ 1
+    {"0769bf9ac56bea3ff40232bcb1b6bd159315d84715b8e679f2d355961915abf02ab799bee0489429554fdb7c8d086475319e63b40b9c5b57cdf1ff3dd9fe22610a09ccf561b55fd99d1c1208dee1162457b57ac5af3759d50671e510e428b2a12e539c423b302d13f4e5773c603948eaf5db5df8ae8a9a9113708390a06410d819b763513924a736e4eebd0d78c91c1bc1d657fee4214057d21414011cfcc7632f8d9f9ab83727c77a2fec063cb7b6e5eb23044ccf535ad49d46d394fb6f6bf62d96b121486ab9da7bf549e57d2f8a6cc1983a336903524fb05dcd507457f63c1dcb45731979ca35dfde49a476e273a1b1c9b52e3eca22fae279459920daa7e3198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c21800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa"_hex,
+        false},
+    // e(G1, G2) ⋅ e(-G1, G2) = 1
+    {"00000000000000000000000000000000000000000000000000000000000000010000000000000000000000000000000000000000000000000000000000000002198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c21800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa000000000000000000000000000000000000000000000000000000000000000130644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd45198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c21800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa"_hex,
+        true},
+    // The empty product.
+    {""_hex, true},
+    // The G1 point at infinity.
+    {"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000a09ccf561b55fd99d1c1208dee1162457b57ac5af3759d50671e510e428b2a12e539c423b302d13f4e5773c603948eaf5db5df8ae8a9a9113708390a06410d819b763513924a736e4eebd0d78c91c1bc1d657fee4214057d21414011cfcc7632f8d9f9ab83727c77a2fec063cb7b6e5eb23044ccf535ad49d46d394fb6f6bf6"_hex,
+        true},
+    // Both points at infinity.
+    {"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"_hex,
+        true},
+    // The G2 point on the twisted curve but not in the subgroup.
+    {"0000000000000000000000000000000000000000000000000000000000000001000000000000000000000000000000000000000000000000000000000000000216f984a318c267976142ea7d17be31111a2a73ed562b0f79c37459eef50bea630dc7b35e27cd813047229389571aa8766c307511b2b9437a28df6ec4ce4a2bbd1141c2ee21c9e9ddd3a2e7f344cc9b45f53149681651563dacfd67d9aafb15fd1b116ffee251b2f56889773066aa3e5cdfdf1ea7bbf12261bae9320a0bcde118"_hex,
+        std::nullopt},
+    // The G1 point coordinate not in the field.
+    {"000000000000000000000000000000000000000000000000000000000000000130644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd49198e9393920d483a7260bfb731fb5d25f1aa493335a9e71297e485b7aef312c21800deef121f1e76426a00665e5c4479674322d4f75edadd46debd5cd992f6ed090689d0585ff075ec9e99ad690c3395bc4b313370b38ef355acdadcd122975b12c85ea5db8c6deb4aab71808dcb408fe3d1e7690c43d37b4ce6cc0166fa7daa"_hex,
+        std::nullopt},
+};
+}  // namespace
+
+TEST(evmmax, bn254_pairing_check)
+{
+    for (const auto& t : test_cases)
+    {
+        const auto pairs = decode_pairs(t.input);
+        EXPECT_EQ(pairing_check(pairs), t.expected_result) << hex(t.input);
+    }
+}
+
+TEST(evmmax, bn254_pairing_check_invalid_g2_point)
+{
+    // The G2 point not on the twisted curve.
+    const std::pair<Point, ExtPoint> pairs[] = {{{1, 2}, {{1, 0}, {2, 0}}}};
+    EXPECT_EQ(pairing_check(pairs), std::nullopt);
+}
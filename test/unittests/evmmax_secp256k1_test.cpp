@@ -12,7 +12,7 @@ using namespace evmone::test;
 
 TEST(secp256k1, field_inv)
 {
-    const evmmax::ModArith m{FieldPrime};
+    const FieldArith m{FieldPrime};
 
     for (const auto& t : std::array{
              1_u256,
@@ -30,7 +30,7 @@ TEST(secp256k1, field_inv)
 
 TEST(secp256k1, field_sqrt)
 {
-    const evmmax::ModArith m{FieldPrime};
+    const FieldArith m{FieldPrime};
 
     for (const auto& t : std::array{
              1_u256,
@@ -58,7 +58,7 @@ TEST(secp256k1, field_sqrt)
 
 TEST(secp256k1, field_sqrt_invalid)
 {
-    const evmmax::ModArith m{FieldPrime};
+    const FieldArith m{FieldPrime};
 
     for (const auto& t : std::array{3_u256, FieldPrime - 1})
     {
@@ -86,7 +86,7 @@ TEST(secp256k1, scalar_inv)
 
 TEST(secp256k1, calculate_y)
 {
-    const evmmax::ModArith m{FieldPrime};
+    const FieldArith m{FieldPrime};
 
     struct TestCase
     {
@@ -129,7 +129,7 @@ TEST(secp256k1, calculate_y)
 
 TEST(secp256k1, calculate_y_invalid)
 {
-    const evmmax::ModArith m{FieldPrime};
+    const FieldArith m{FieldPrime};
 
     for (const auto& t : std::array{
              0x207ea538f1835f6de40c793fc23d22b14da5a80015a0fecddf56f146b21d7949_u256,
@@ -161,7 +161,7 @@ TEST(evmmax, secp256k1_calculate_u1)
     const auto r = 0x71cd6bfc24665312ff489aba9279710a560eda74aca333bf298785dc3cd72f6e_u256;
     const auto expected = 0xd80ea4db5200c96e969270ab7c105e16abb9fc18a6e01cc99575dd3f5ce41eed_u256;
 
-    const evmmax::ModArith m{evmmax::secp256k1::FieldPrime};
+    const evmmax::secp256k1::FieldArith m{evmmax::secp256k1::FieldPrime};
     const auto z_mont = m.to_mont(z);
     const auto r_mont = m.to_mont(r);
     const auto r_inv = field_inv(m, r_mont);
@@ -178,7 +178,7 @@ TEST(evmmax, secp256k1_calculate_u2)
     const auto s = 0x7ce91fc325f28e78a016fa674a80d85581cc278d15453ea2fede2471b1adaada_u256;
     const auto expected = 0xf888ea06899abc190fa37a165c98e6d4b00b13c50db1d1c34f38f0ab8fd9c29b_u256;
 
-    const evmmax::ModArith m{evmmax::secp256k1::FieldPrime};
+    const evmmax::secp256k1::FieldArith m{evmmax::secp256k1::FieldPrime};
     const auto s_mont = m.to_mont(s);
     const auto r_mont = m.to_mont(r);
     const auto r_inv = field_inv(m, r_mont);
@@ -289,6 +289,43 @@ TEST(evmmax, secp256k1_pt_mul)
     }
 }
 
+TEST(evmmax, secp256k1_pt_mul_generator)
+{
+    const Point G{0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798_u256,
+        0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8_u256};
+    const Point neg_G{G.x, FieldPrime - G.y};
+
+    EXPECT_EQ(mul(G, 0), Point{});
+    EXPECT_EQ(mul(G, 1), G);
+    EXPECT_EQ(mul(G, Order - 1), neg_G);
+    EXPECT_EQ(mul(G, Order), Point{});
+
+    // The maximum scalar has the additional top wNAF digit.
+    const auto max = ~uint256{};
+    EXPECT_EQ(mul(G, max), mul(G, max - Order));
+    EXPECT_EQ(mul(neg_G, max), mul(neg_G, max - Order));
+}
+
+TEST(evmmax, ecc_wnaf)
+{
+    for (const auto c : {0_u256, 1_u256, 0xff_u256, Order - 1, ~uint256{}, ~uint256{} >> 1,
+             0x8000000000000000000000000000000000000000000000000000000000000000_u256})
+    {
+        const auto digits = evmmax::ecc::wnaf<5>(c);
+        intx::uint<512> value;
+        for (size_t i = digits.size(); i != 0; --i)
+        {
+            const auto d = digits[i - 1];
+            EXPECT_TRUE(d == 0 || (d % 2 != 0 && d > -16 && d < 16));
+            value <<= 1;
+            if (d > 0)
+                value += static_cast<uint64_t>(d);
+            else
+                value -= static_cast<uint64_t>(-d);
+        }
+        EXPECT_EQ(value, intx::uint<512>{c});
+    }
+}
 
 struct TestCaseECR
 {
@@ -379,3 +416,27 @@ TEST(evmmax, ecrecovery)
         }
     }
 }
+
+TEST(evmmax, ecrecover_batch)
+{
+    std::vector<EcrecoverInput> inputs;
+    for (const auto& t : test_cases)
+    {
+        EcrecoverInput input;
+        std::memcpy(input.hash.bytes, t.input.data(), 32);
+        input.v = be::unsafe::load<uint256>(&t.input[32]) == 28;
+        input.r = be::unsafe::load<uint256>(&t.input[64]);
+        input.s = be::unsafe::load<uint256>(&t.input[96]);
+        inputs.push_back(input);
+    }
+
+    const auto results = ecrecover_batch(inputs);
+    ASSERT_EQ(results.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        const auto& [hash, r, s, v] = inputs[i];
+        EXPECT_EQ(results[i], ecrecover(hash, r, s, v)) << i;
+    }
+
+    EXPECT_TRUE(ecrecover_batch({}).empty());
+}
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <evmmax/evmmax.hpp>
+#include <evmmax/safegcd.hpp>
 #include <gtest/gtest.h>
 #include <array>
 
@@ -18,11 +19,11 @@ constexpr auto BLS12384Mod =
     0x1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab_u384;
 
 
-template <typename UintT, const UintT& Mod>
-struct ModA : ModArith<UintT>
+template <typename UintT, const UintT& Mod, typename KindT = GenericModulus>
+struct ModA : ModArith<UintT, KindT>
 {
     using uint = UintT;
-    ModA() : ModArith<UintT>{Mod} {}
+    ModA() : ModArith<UintT, KindT>{Mod} {}
 };
 
 template <typename>
@@ -30,7 +31,10 @@ class evmmax_test : public testing::Test
 {};
 
 using test_types = testing::Types<ModA<uint256, P23>, ModA<uint256, BN254Mod>,
-    ModA<uint256, Secp256k1Mod>, ModA<uint256, M256>, ModA<uint384, BLS12384Mod>>;
+    ModA<uint256, Secp256k1Mod>, ModA<uint256, M256>, ModA<uint384, BLS12384Mod>,
+    ModA<uint256, P23, SparseModulus>, ModA<uint256, BN254Mod, SparseModulus>,
+    ModA<uint384, BLS12384Mod, SparseModulus>,
+    ModA<uint256, Secp256k1Mod, PseudoMersenneModulus<0x1000003d1>>>;
 TYPED_TEST_SUITE(evmmax_test, test_types, testing::internal::DefaultNameGenerator);
 
 TYPED_TEST(evmmax_test, to_from_mont)
@@ -76,6 +80,23 @@ static auto get_test_values(const Mod& m) noexcept
     static_assert(m.add(a, b) == m.to_mont(14));
     static_assert(m.sub(a, b) == m.to_mont(BN254Mod - 8));
     static_assert(m.mul(a, b) == m.to_mont(33));
+    static_assert(m.sqr(b) == m.to_mont(121));
+
+    static constexpr ModArith<uint256, SparseModulus> ms{BN254Mod};
+    static_assert(ms.to_mont(3) == a);
+    static_assert(ms.add(a, b) == m.add(a, b));
+    static_assert(ms.mul(a, b) == m.mul(a, b));
+    static_assert(ms.sqr(b) == m.sqr(b));
+
+    static constexpr ModArith<uint256, PseudoMersenneModulus<0x1000003d1>> mp{Secp256k1Mod};
+    static_assert(mp.to_mont(3) == 3);
+    static_assert(mp.mul(mp.to_mont(3), mp.to_mont(11)) == mp.to_mont(33));
+    static_assert(mp.mul(Secp256k1Mod - 1, Secp256k1Mod - 1) == 1);
+    static_assert(mp.sqr(Secp256k1Mod - 1) == 1);
+
+    static_assert(safegcd::inv(3, BN254Mod) == (2 * BN254Mod + 1) / 3);
+    static_assert(m.mul(safegcd::inv(m, a), a) == m.to_mont(1));
+    static_assert(mp.mul(safegcd::inv(mp, 3), 3) == 1);
 }
 
 TYPED_TEST(evmmax_test, add)
@@ -147,3 +168,98 @@ TYPED_TEST(evmmax_test, mul)
         }
     }
 }
+
+TYPED_TEST(evmmax_test, sqr)
+{
+    const TypeParam m;
+
+    for (const auto& x : get_test_values(m))
+    {
+        const auto expected = udivrem(umul(x, x), m.mod).rem;
+
+        const auto xm = m.to_mont(x);
+        EXPECT_EQ(m.sqr(xm), m.mul(xm, xm));
+        EXPECT_EQ(m.from_mont(m.sqr(xm)), expected);
+    }
+}
+
+TEST(evmmax, pseudo_mersenne_mul_edge_cases)
+{
+    const ModArith<uint256, PseudoMersenneModulus<0x1000003d1>> m{Secp256k1Mod};
+
+    // The first pair requires the final subtraction, the second one the additional fold
+    // of the carry in the reduction.
+    for (const auto& [x, y] : {
+             std::pair{Secp256k1Mod - 1, Secp256k1Mod - 1},
+             std::pair{Secp256k1Mod - 1, Secp256k1Mod - 0x1000003d2},
+             std::pair{Secp256k1Mod - 1, Secp256k1Mod / 2},
+         })
+    {
+        const auto expected = udivrem(umul(x, y), m.mod).rem;
+        EXPECT_EQ(m.mul(x, y), expected);
+    }
+}
+
+template <typename UintT, const UintT& Mod, typename KindT = GenericModulus>
+static void check_mul_matches_constexpr()
+{
+    // The constant evaluation always uses the portable implementation so it is the reference
+    // for the CPU-specific kernels (e.g. x86_64::mul_mont()) selected at runtime.
+    static constexpr ModArith<UintT, KindT> m{Mod};
+    static constexpr std::array values{
+        Mod - 1,
+        Mod - 2,
+        Mod / 2 + 1,
+        Mod / 3,
+        UintT{0x6e140df17432311190232a91a38daed3ee9ed7f038645dd0278da7ca6e497de_u256} % Mod,
+        UintT{2},
+        UintT{1},
+        UintT{0},
+    };
+    static constexpr auto expected = [] {
+        std::array<UintT, values.size() * values.size()> r;
+        for (size_t i = 0; i < values.size(); ++i)
+            for (size_t j = 0; j < values.size(); ++j)
+                r[i * values.size() + j] = m.mul(values[i], values[j]);
+        return r;
+    }();
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        for (size_t j = 0; j < values.size(); ++j)
+        {
+            EXPECT_EQ(m.mul(values[i], values[j]), expected[i * values.size() + j])
+                << i << " " << j;
+        }
+        EXPECT_EQ(m.sqr(values[i]), expected[i * values.size() + i]) << i;
+    }
+}
+
+TEST(evmmax, mul_matches_constexpr)
+{
+    check_mul_matches_constexpr<uint256, BN254Mod>();
+    check_mul_matches_constexpr<uint256, BN254Mod, SparseModulus>();
+    check_mul_matches_constexpr<uint256, Secp256k1Mod>();
+    check_mul_matches_constexpr<uint256, M256>();
+    check_mul_matches_constexpr<uint384, BLS12384Mod>();
+    check_mul_matches_constexpr<uint384, BLS12384Mod, SparseModulus>();
+}
+
+TEST(evmmax, safegcd_inv)
+{
+    constexpr auto Secp256k1Order =
+        0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141_u256;
+    constexpr auto R = 0x6e140df17432311190232a91a38daed3ee9ed7f038645dd0278da7ca6e497de_u256;
+
+    for (const auto& mod : {P23, BN254Mod, Secp256k1Mod, Secp256k1Order})
+    {
+        for (const auto& x :
+            {mod - 1, mod - 2, mod / 2 + 1, mod / 2, mod / 3, R % mod, uint256{2}, uint256{1}})
+        {
+            const auto x_inv = safegcd::inv(x, mod);
+            EXPECT_LT(x_inv, mod);
+            EXPECT_EQ(udivrem(umul(x, x_inv), mod).rem, 1);
+        }
+        EXPECT_EQ(safegcd::inv(0, mod), 0);
+    }
+}
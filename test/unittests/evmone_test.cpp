@@ -3,9 +3,11 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <evmc/evmc.hpp>
+#include <evmc/mocked_host.hpp>
 #include <evmone/evmone.h>
 #include <evmone/vm.hpp>
 #include <gtest/gtest.h>
+#include <test/utils/bytecode.hpp>
 
 TEST(evmone, info)
 {
@@ -53,3 +55,47 @@ TEST(evmone, set_option_cgoto)
     EXPECT_EQ(vm.set_option("cgoto", "no"), EVMC_SET_OPTION_INVALID_NAME);
 #endif
 }
+
+TEST(evmone, set_option_keccak_cache)
+{
+    evmc::VM vm{evmc_create_evmone()};
+    const auto& evmone_vm = *static_cast<evmone::VM*>(vm.get_raw_pointer());
+    EXPECT_EQ(evmone_vm.keccak_cache, nullptr);
+    EXPECT_EQ(vm.set_option("keccak_cache", ""), EVMC_SET_OPTION_SUCCESS);
+    EXPECT_NE(evmone_vm.keccak_cache, nullptr);
+}
+
+TEST(evmone, keccak_cache)
+{
+    using namespace evmone::test;
+
+    evmc::VM vm{evmc_create_evmone(), {{"keccak_cache", ""}}};
+    const auto& cache = *static_cast<evmone::VM*>(vm.get_raw_pointer())->keccak_cache;
+
+    // Hash the same "mapping slot" input three times, then the modified one
+    // and return the sum of all hashes. Also hash inputs of other sizes bypassing the cache.
+    const auto code = mstore(0, 0xca11e7) + mstore(32, 3) + keccak256(0, 64) + keccak256(0, 64) +
+                      OP_ADD + keccak256(0, 64) + OP_ADD + mstore(32, 4) + keccak256(0, 64) +
+                      OP_ADD + keccak256(0, 63) + OP_ADD + keccak256(0, 96) + OP_ADD + ret_top();
+
+    evmc::MockedHost host;
+    evmc_message msg{};
+    msg.gas = 1'000'000;
+    const auto r1 = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    ASSERT_EQ(r1.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(cache.stats().hits, 2);
+    EXPECT_EQ(cache.stats().misses, 2);
+
+    // The result must be the same as without the cache.
+    evmc::VM uncached_vm{evmc_create_evmone()};
+    const auto r2 = uncached_vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    ASSERT_EQ(r2.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(evmc::bytes_view(r1.output_data, r1.output_size),
+        evmc::bytes_view(r2.output_data, r2.output_size));
+
+    // The cache is cleared for the next transaction.
+    const auto r3 = vm.execute(host, EVMC_CANCUN, msg, code.data(), code.size());
+    ASSERT_EQ(r3.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(cache.stats().hits, 4);
+    EXPECT_EQ(cache.stats().misses, 4);
+}
@@ -200,6 +200,61 @@ TEST(bls, g1_msm_inf_2)
     EXPECT_EQ(evmc::bytes_view(ry, sizeof ry), expected_y);
 }
 
+TEST(bls, g1_msm_inf_first)
+{
+    using namespace evmc::literals;
+    const auto g =
+        "0000000000000000000000000000000017f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f17"
+        "1bac586c55e83ff97a1aeffb3af00adb22c6bb0000000000000000000000000000000008b3f481e3aaa0f1a09e"
+        "30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1"_hex;
+    const auto two = "0000000000000000000000000000000000000000000000000000000000000002"_hex;
+    const auto input = evmc::bytes(128, 0) + two + g + two;
+    uint8_t rx[64];
+    uint8_t ry[64];
+
+    EXPECT_TRUE(evmone::crypto::bls::g1_msm(rx, ry, input.data(), input.size()));
+
+    const auto expected_x =
+        "000000000000000000000000000000000572cbea904d67468808c8eb50a9450c9721db309128012543902d0ac358a62ae28f75bb8f1c7c42c39a8c5529bf0f4e"_hex;
+    const auto expected_y =
+        "00000000000000000000000000000000166a9d8cabc673a322fda673779d8e3822ba3ecb8670e461f73bb9021d5fd76a4c56d9d4cd16bd1bba86881979749d28"_hex;
+
+    EXPECT_EQ(evmc::bytes_view(rx, sizeof rx), expected_x);
+    EXPECT_EQ(evmc::bytes_view(ry, sizeof ry), expected_y);
+}
+
+TEST(bls, g1_msm_many)
+{
+    // The sum of the scalars is r + 2, where r is the group order, so the result is [2]G.
+    // The input is big enough to be computed by multiple threads.
+    using namespace evmc::literals;
+    const auto g =
+        "0000000000000000000000000000000017f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f17"
+        "1bac586c55e83ff97a1aeffb3af00adb22c6bb0000000000000000000000000000000008b3f481e3aaa0f1a09e"
+        "30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1"_hex;
+    const auto one = "0000000000000000000000000000000000000000000000000000000000000001"_hex;
+    const auto r_minus_61 = "73eda753299d7d483339d80809a1d80553bda402fffe5bfefffffffeffffffc4"_hex;
+    evmc::bytes input;
+    for (size_t i = 0; i < 63; ++i)
+        input += g + one;
+    input += g + r_minus_61;
+
+    const auto expected_x =
+        "000000000000000000000000000000000572cbea904d67468808c8eb50a9450c9721db309128012543902d0ac358a62ae28f75bb8f1c7c42c39a8c5529bf0f4e"_hex;
+    const auto expected_y =
+        "00000000000000000000000000000000166a9d8cabc673a322fda673779d8e3822ba3ecb8670e461f73bb9021d5fd76a4c56d9d4cd16bd1bba86881979749d28"_hex;
+
+    for (const size_t num_threads : {1u, 4u})
+    {
+        uint8_t rx[64];
+        uint8_t ry[64];
+        EXPECT_TRUE(
+            evmone::crypto::bls::g1_msm(rx, ry, input.data(), input.size(), num_threads));
+        EXPECT_EQ(evmc::bytes_view(rx, sizeof rx), expected_x);
+        EXPECT_EQ(evmc::bytes_view(ry, sizeof ry), expected_y);
+    }
+}
+
 TEST(bls, g2_msm)
 {
     using namespace evmc::literals;
@@ -257,6 +312,57 @@ TEST(bls, g2_msm_inf_2)
     EXPECT_EQ(evmc::bytes_view(ry, sizeof ry), expected_y);
 }
 
+TEST(bls, g2_msm_inf_first)
+{
+    using namespace evmc::literals;
+    const auto g =
+        "00000000000000000000000000000000024aa2b2f08f0a91260805272dc51051c6e47ad4fa403b02b4510b647ae3d1770bac0326a805bbefd48056c8c121bdb80000000000000000000000000000000013e02b6052719f607dacd3a088274f65596bd0d09920b61ab5da61bbdc7f5049334cf11213945d57e5ac7d055d042b7e000000000000000000000000000000000ce5d527727d6e118cc9cdc6da2e351aadfd9baa8cbdd3a76d429a695160d12c923ac9cc3baca289e193548608b82801000000000000000000000000000000000606c4a02ea734cc32acd2b02bc28b99cb3e287e85a763af267492ab572e99ab3f370d275cec1da1aaa9075ff05f79be"_hex;
+    const auto two = "0000000000000000000000000000000000000000000000000000000000000002"_hex;
+    const auto input = evmc::bytes(256, 0) + two + g + two;
+    uint8_t rx[128];
+    uint8_t ry[128];
+
+    EXPECT_TRUE(evmone::crypto::bls::g2_msm(rx, ry, input.data(), input.size()));
+
+    const auto expected_x =
+        "000000000000000000000000000000001638533957d540a9d2370f17cc7ed5863bc0b995b8825e0ee1ea1e1e4d00dbae81f14b0bf3611b78c952aacab827a053000000000000000000000000000000000a4edef9c1ed7f729f520e47730a124fd70662a904ba1074728114d1031e1572c6c886f6b57ec72a6178288c47c33577"_hex;
+    const auto expected_y =
+        "000000000000000000000000000000000468fb440d82b0630aeb8dca2b5256789a66da69bf91009cbfe6bd221e47aa8ae88dece9764bf3bd999d95d71e4c9899000000000000000000000000000000000f6d4552fa65dd2638b361543f887136a43253d9c66c411697003f7a13c308f5422e1aa0a59c8967acdefd8b6e36ccf3"_hex;
+
+    EXPECT_EQ(evmc::bytes_view(rx, sizeof rx), expected_x);
+    EXPECT_EQ(evmc::bytes_view(ry, sizeof ry), expected_y);
+}
+
+TEST(bls, g2_msm_many)
+{
+    // The sum of the scalars is r + 2, where r is the group order, so the result is [2]G.
+    // The input is big enough to be computed by multiple threads.
+    using namespace evmc::literals;
+    const auto g =
+        "00000000000000000000000000000000024aa2b2f08f0a91260805272dc51051c6e47ad4fa403b02b4510b647ae3d1770bac0326a805bbefd48056c8c121bdb80000000000000000000000000000000013e02b6052719f607dacd3a088274f65596bd0d09920b61ab5da61bbdc7f5049334cf11213945d57e5ac7d055d042b7e000000000000000000000000000000000ce5d527727d6e118cc9cdc6da2e351aadfd9baa8cbdd3a76d429a695160d12c923ac9cc3baca289e193548608b82801000000000000000000000000000000000606c4a02ea734cc32acd2b02bc28b99cb3e287e85a763af267492ab572e99ab3f370d275cec1da1aaa9075ff05f79be"_hex;
+    const auto one = "0000000000000000000000000000000000000000000000000000000000000001"_hex;
+    const auto r_minus_61 = "73eda753299d7d483339d80809a1d80553bda402fffe5bfefffffffeffffffc4"_hex;
+    evmc::bytes input;
+    for (size_t i = 0; i < 63; ++i)
+        input += g + one;
+    input += g + r_minus_61;
+
+    const auto expected_x =
+        "000000000000000000000000000000001638533957d540a9d2370f17cc7ed5863bc0b995b8825e0ee1ea1e1e4d00dbae81f14b0bf3611b78c952aacab827a053000000000000000000000000000000000a4edef9c1ed7f729f520e47730a124fd70662a904ba1074728114d1031e1572c6c886f6b57ec72a6178288c47c33577"_hex;
+    const auto expected_y =
+        "000000000000000000000000000000000468fb440d82b0630aeb8dca2b5256789a66da69bf91009cbfe6bd221e47aa8ae88dece9764bf3bd999d95d71e4c9899000000000000000000000000000000000f6d4552fa65dd2638b361543f887136a43253d9c66c411697003f7a13c308f5422e1aa0a59c8967acdefd8b6e36ccf3"_hex;
+
+    for (const size_t num_threads : {1u, 4u})
+    {
+        uint8_t rx[128];
+        uint8_t ry[128];
+        EXPECT_TRUE(
+            evmone::crypto::bls::g2_msm(rx, ry, input.data(), input.size(), num_threads));
+        EXPECT_EQ(evmc::bytes_view(rx, sizeof rx), expected_x);
+        EXPECT_EQ(evmc::bytes_view(ry, sizeof ry), expected_y);
+    }
+}
+
 TEST(bls, map_fp_to_g1)
 {
     using namespace evmc::literals;
@@ -0,0 +1,138 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmc/hex.hpp>
+#include <evmone_precompiles/keccak.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+using evmone::crypto::KECCAK256_HASH_SIZE;
+using evmone::crypto::Keccak256BatchImpl;
+using evmone::crypto::keccak256;
+using evmone::crypto::keccak256_batch;
+
+namespace
+{
+std::string hash_hex(const std::byte* hash)
+{
+    return evmc::hex({reinterpret_cast<const uint8_t*>(hash), KECCAK256_HASH_SIZE});
+}
+
+constexpr Keccak256BatchImpl batch_impls[] = {
+    Keccak256BatchImpl::scalar, Keccak256BatchImpl::avx2, Keccak256BatchImpl::avx512};
+
+/// The test vectors for the inputs of "a" repeated n times, around the block size (136 bytes).
+constexpr std::pair<size_t, std::string_view> repeated_a_test_cases[] = {
+    {135, "34367dc248bbd832f4e3e69dfaac2f92638bd0bbd18f2912ba4ef454919cf446"},
+    {136, "a6c4d403279fe3e0af03729caada8374b5ca54d8065329a3ebcaeb4b60aa386e"},
+    {137, "d869f639c7046b4929fc92a4d988a8b22c55fbadb802c0c66ebcd484f1915f39"},
+    {271, "132f47effd6c8b1b299efa53fe68aece77ec8ae4eb2e294f668eec94f76001e1"},
+    {272, "cf7fcd4f705ee749930d19ca84561a9bf62516bd90a471545fa2f49fdc7e63c8"},
+    {273, "5a7b8187d2778e614097fac3097573de1fee4d972304d3360796a857029bb176"},
+    {1000, "b6a4ac1f51884d71f30fa397a5e155de3099e11fc0edef5d08b646e621e19de9"},
+};
+}  // namespace
+
+TEST(keccak256, test_vectors)
+{
+    const std::pair<std::string_view, std::string_view> test_cases[] = {
+        {"", "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"},
+        {"abc", "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45"},
+        {"The quick brown fox jumps over the lazy dog",
+            "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15"},
+    };
+
+    for (const auto& [input, expected_hash_hex] : test_cases)
+    {
+        std::byte hash[KECCAK256_HASH_SIZE];
+        keccak256(hash, reinterpret_cast<const std::byte*>(input.data()), input.size());
+        EXPECT_EQ(hash_hex(hash), expected_hash_hex);
+    }
+}
+
+TEST(keccak256, test_vectors_block_boundaries)
+{
+    // All the test cases in a single batch so the multi-buffer implementations
+    // hash the inputs absorbing different numbers of blocks together.
+    std::vector<std::string> inputs;
+    std::vector<const std::byte*> data;
+    std::vector<size_t> sizes;
+    for (const auto& [size, _] : repeated_a_test_cases)
+    {
+        inputs.emplace_back(size, 'a');
+        sizes.emplace_back(size);
+    }
+    for (const auto& input : inputs)
+        data.emplace_back(reinterpret_cast<const std::byte*>(input.data()));
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        std::byte hash[KECCAK256_HASH_SIZE];
+        keccak256(hash, data[i], sizes[i]);
+        EXPECT_EQ(hash_hex(hash), repeated_a_test_cases[i].second) << sizes[i];
+    }
+
+    for (const auto impl : batch_impls)
+    {
+        if (!is_supported(impl))
+            continue;
+        std::vector<std::byte> hashes(inputs.size() * KECCAK256_HASH_SIZE);
+        keccak256_batch(impl, hashes.data(), data.data(), sizes.data(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            EXPECT_EQ(hash_hex(&hashes[i * KECCAK256_HASH_SIZE]), repeated_a_test_cases[i].second)
+                << "impl " << static_cast<int>(impl) << " size " << sizes[i];
+        }
+    }
+}
+
+TEST(keccak256, batch)
+{
+    // Inputs of different lengths around the block size boundaries (136 bytes)
+    // so the inputs hashed together absorb different numbers of blocks.
+    static constexpr size_t input_sizes[] = {
+        0, 1, 31, 32, 64, 135, 136, 137, 271, 272, 273, 500, 7, 8, 9, 1000};
+
+    std::vector<std::vector<std::byte>> inputs;
+    for (const auto size : input_sizes)
+    {
+        std::vector<std::byte> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = static_cast<std::byte>(i * 7 + size);
+        inputs.emplace_back(std::move(input));
+    }
+
+    for (size_t count = 0; count <= inputs.size(); ++count)
+    {
+        std::vector<const std::byte*> data;
+        std::vector<size_t> sizes;
+        for (size_t i = 0; i < count; ++i)
+        {
+            data.emplace_back(inputs[i].data());
+            sizes.emplace_back(inputs[i].size());
+        }
+
+        std::vector<std::byte> hashes(count * KECCAK256_HASH_SIZE);
+        keccak256_batch(hashes.data(), data.data(), sizes.data(), count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::byte expected[KECCAK256_HASH_SIZE];
+            keccak256(expected, inputs[i].data(), inputs[i].size());
+            EXPECT_EQ(hash_hex(&hashes[i * KECCAK256_HASH_SIZE]), hash_hex(expected))
+                << "count " << count << " input " << i;
+        }
+
+        // Every implementation supported by the CPU, not only the one selected at runtime.
+        for (const auto impl : batch_impls)
+        {
+            if (!is_supported(impl))
+                continue;
+            std::vector<std::byte> impl_hashes(count * KECCAK256_HASH_SIZE);
+            keccak256_batch(impl, impl_hashes.data(), data.data(), sizes.data(), count);
+            EXPECT_EQ(impl_hashes, hashes)
+                << "impl " << static_cast<int>(impl) << " count " << count;
+        }
+    }
+}
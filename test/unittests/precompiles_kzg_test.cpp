@@ -5,8 +5,11 @@
 #include <evmc/evmc.hpp>
 #include <evmone_precompiles/kzg.hpp>
 #include <evmone_precompiles/sha256.hpp>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <intx/intx.hpp>
+#include <cassert>
+#include <cstring>
 #include <span>
 
 using namespace evmc::literals;
@@ -32,6 +35,24 @@ auto versioned_hash(std::span<const std::byte> input) noexcept
     hash[0] = VERSIONED_HASH_VERSION_KZG;
     return hash;
 }
+
+KZGProofInput to_proof_input(evmc::bytes_view input) noexcept
+{
+    KZGProofInput r;
+    assert(input.size() == sizeof(r));
+    std::memcpy(&r, input.data(), sizeof(r));
+    return r;
+}
+
+// Point evaluation precompile inputs from Mainnet.
+const KZGProofInput MAINNET_PROOFS[]{
+    to_proof_input(
+        "012b08a0504a63aac18383db69fe6b52fc833e3d060b87c2726c4140c909d91807dddd3c80995c2bb3012943e2036e77490b1f6ddc58ca39a4fb4f3225ae56ab11dc2c4d89f777f0f5c2a51f45b73ff1538761f9cf23ed74c74472fea625ad8bace1db77e25ceb316d914182e05dd810f112352e1d6ed9e47af28e2f64e22b94c411794359c2273bc10bc0390963fb1a97bb642307bfa4424c66bd90ecc0ecffd5045e492b40304df20346693db7450457e2c72588a6a2b1a16909e2ab1e6284"_hex),
+    to_proof_input(
+        "019cd755316533108b9eade41e35a16442ae76acd5b7d4e8903ecb9d9f48348a00000000000000000000000000000000dd372dcb4e5565861fc29cfb12f4373861e6e2dfca75084191a505f7988db8e82a4a4a09734b6fd7677d590a1cb512768c381fc4957f406ef89996d9dfa1d39b5c8d1368569e56fd61036c537400a3f4515eeb0c4d183142daa2c30423e0c3fa84667445c1669d3a3e3fce8a1144811e4452841399318c21cca9d20c91fb162929c4e96d391b70158bcd4c69b682b272"_hex),
+    to_proof_input(
+        "0187576b6a38dd4ca8ce00e35dd12d1dd91e06ba3bde49d01568103d826d59732fd172adc351401950681fb66f9464410b15437ab00599aede3f90d0d9552bd162920cfc9b91d123f2c24034006fc9b7f5217cfae1022be231b6bd37262fda83ac48e50cbfeeee227daee56a8bff2f96ede7757b6f2598bd40b14d75b04c07a92299443d1eabe857f57fc95b0ca8b121adff55fad542926063245c402008a846c60eeca2e419a3e9e12ddfc0184a606b31d39268d8b580b57ac274501858bdb5"_hex),
+};
 }  // namespace
 
 TEST(kzg, verify_proof_hash_invalid)
@@ -67,3 +88,71 @@ TEST(kzg, verify_proof_constant)
     const auto r = kzg_verify_proof(hash.data(), z, y, c, POINT_AT_INFINITY);
     EXPECT_TRUE(r);
 }
+
+TEST(kzg, verify_proof_batch)
+{
+    for (const auto& p : MAINNET_PROOFS)
+    {
+        EXPECT_TRUE(kzg_verify_proof(p.versioned_hash, p.z, p.y, p.commitment, p.proof));
+        EXPECT_TRUE(kzg_verify_proof_batch({&p, 1}));
+    }
+
+    EXPECT_TRUE(kzg_verify_proof_batch({}));
+    EXPECT_TRUE(kzg_verify_proof_batch(MAINNET_PROOFS));
+
+    // The evaluation y of the second proof is wrong.
+    auto proofs = std::to_array(MAINNET_PROOFS);
+    proofs[1].y[31] ^= std::byte{1};
+    EXPECT_FALSE(kzg_verify_proof_batch(proofs));
+
+    // The same proof repeated: the random coefficients must be different.
+    EXPECT_TRUE(kzg_verify_proof_batch(std::array{MAINNET_PROOFS[0], MAINNET_PROOFS[0]}));
+    EXPECT_FALSE(kzg_verify_proof_batch(std::array{proofs[1], proofs[1]}));
+}
+
+TEST(kzg, verify_proof_batch_constant)
+{
+    // Commit and prove the polynomials f(x) = 0 and f(x) = 1.
+    // Both proofs and the first commitment are the points at infinity.
+    KZGProofInput zero{};
+    zero.z[13] = std::byte{17};
+    std::ranges::copy(POINT_AT_INFINITY, zero.commitment);
+    std::ranges::copy(POINT_AT_INFINITY, zero.proof);
+    std::ranges::copy(versioned_hash(zero.commitment), zero.versioned_hash);
+
+    auto one = zero;
+    one.y[31] = std::byte{1};
+    intx::be::store(reinterpret_cast<uint8_t(&)[48]>(one.commitment), G1_GENERATOR_X);
+    one.commitment[0] |= std::byte{0x80};  // flag of the point compressed form.
+    std::ranges::copy(versioned_hash(one.commitment), one.versioned_hash);
+
+    EXPECT_TRUE(kzg_verify_proof_batch(std::array{zero, one}));
+    EXPECT_TRUE(kzg_verify_proof_batch(std::array{one, zero, MAINNET_PROOFS[2]}));
+
+    // Claim f(z) = 1 for the zero polynomial.
+    auto invalid = zero;
+    invalid.y[31] = std::byte{1};
+    EXPECT_FALSE(kzg_verify_proof_batch(std::array{zero, invalid, one}));
+}
+
+TEST(kzg, verify_proofs)
+{
+    auto proofs = std::to_array(MAINNET_PROOFS);
+    bool valid[std::size(MAINNET_PROOFS)]{};
+    EXPECT_TRUE(kzg_verify_proofs(proofs, valid));
+    EXPECT_THAT(valid, testing::Each(true));
+
+    // Invalid proof.
+    proofs[0].y[31] ^= std::byte{1};
+    // Invalid versioned hash, rejected before the pairing check.
+    proofs[2].versioned_hash[0] = std::byte{0};
+    EXPECT_FALSE(kzg_verify_proofs(proofs, valid));
+    EXPECT_THAT(valid, testing::ElementsAre(false, true, false));
+
+    // All proofs invalid.
+    proofs[1].z[31] ^= std::byte{1};
+    EXPECT_FALSE(kzg_verify_proofs(proofs, valid));
+    EXPECT_THAT(valid, testing::Each(false));
+
+    EXPECT_TRUE(kzg_verify_proofs({}, {}));
+}
@@ -0,0 +1,200 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmc/hex.hpp>
+#include <evmone_precompiles/modexp.hpp>
+#include <gtest/gtest.h>
+
+using evmone::crypto::modexp;
+
+TEST(modexp, test_vectors)
+{
+    struct TestCase
+    {
+        std::string_view base;
+        std::string_view exp;
+        std::string_view mod;
+        std::string_view expected;
+    };
+    const TestCase test_cases[] = {
+        // Fermat's little theorem (EIP-198 example).
+        {"03",
+            "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2e",
+            "fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f",
+            "0000000000000000000000000000000000000000000000000000000000000001"},
+        {"03", "05", "07", "05"},
+        // Zero modulus.
+        {"05", "03", "0000", "0000"},
+        // The modulus 1.
+        {"05", "03", "01", "00"},
+        // Empty exponent.
+        {"05", "", "0005", "0001"},
+        // Zero base.
+        {"", "07", "0d", "00"},
+        // Base longer than modulus.
+        {"8d1708c14994ea9ce5c00b50c0cd601c9833b0ac07107e1daa392f00f667ecafce13ff62d7ecbf7b"
+            "455f2077f321aa2675a5865656363393cd55c37177466edf7ba308655245ffa9eda7abf11ab8a35c",
+            "010001",
+            "00419353abafc5b1945c92f593c8aa5d575a5170de962f01c1ae7cbbe3fcbfbff5",
+            "0010a63442fdaff2d222f72523c2bfe878ddb80d575a878fc8f854fe513e9ff79d"},
+        {"d8f0626b7116e1ff6f292048d17ec136748dfc8b84e630fe6b591756931c4acf84b4140273a8785b"
+            "8a147205e888188683a933e601f22bb6c0fdb2cdc5dcb1b6",
+            "62819353ad11bbcda7794d6376bcc26b",
+            "c9afe2ce76e667a0ba6ad769b62ac3fdc8c83ad04583e2e77b53b2bee8b136bec844257e5302f749"
+            "d53574f677e545b4de1ad0da4007c2ff7432fbc304a278bb",
+            "ac7efbfb22ed43a58c31dffffeb0be3774adeb9cc644052b97c1571a86078b600e117e8f660b4d0a"
+            "daaa53d828bc9194d11e8790011dd47174a6babb2d696578"},
+        {"ada76328fea692ad625a80076bf2118ad68f20e523664a8620909c3e99eda40def94c495c8d3c64e"
+            "fe401b22b21c9d8fdcecbce857f3751345ac1d0aa1ba2c01a4be599b7cdeae9490e043d4f838f8b3"
+            "7486890fa6a378e0edf6a33279d3b178e738bcfcc700c2d910f192cb7972d6c36d1961655b6f2c34"
+            "72b616e28f074a1a",
+            "aaedcabd42019a400ee7c03e08f46a05",
+            "a15b2984c73007343dd44c0bcd46da8c3a642ba20a91c31943360f3efc8a857a8ae360309aa779fe"
+            "124c106d377a1338d9b80f286678fa2cadc50e862398edc1110ce2e7762bec2e789693847c963cd7"
+            "382fe76fd9e13fc5aae102fe09b68e1675418eec1430bbc3345ade6e39e89d3d88c00a615fb8f1eb"
+            "1311760db269ae37",
+            "5e5ced338e1be7a6acbe0c0833917c58f81c0d115bc3b7435ad79f3a82db9860b85bf277a4de2414"
+            "67ce115381fb5bf5dbab8d5f67fc26bb65ab8ab6924b1897531879c9e626249bba435f8c3cc4ad90"
+            "2d84479c41804cf43073aa72b31cc8e5ad5c5ce43c4f9e3d19ce5fdcdc0de68f01c484f31d810faf"
+            "9e5958d3b437d177"},
+        {"967da7fc3be12768723c3ad8b8b1d6f0cabee3467861eae5f42516fbc41198ce8c925d3b99a7f2e3"
+            "770478c170f785f751361cae2e5e702902527b9f4a092e00b50bd40d76ce3fec67473c7e552fb5d3"
+            "b238e80b5bc688efcee7bd0cda6c5298b6f8c3598e37f333f3f0255b0fc4efd9b709f957e12a999d"
+            "683a7e3773ed54abae830e8a6b84728a8bfd55b9e2d0c57bdfa133cea2507f5f95e2bc18d8e43872"
+            "e39fbb06cd19dddd993772953c456b77e530777367ff73de1b68cd2b1d7af0d0a6ba3440c7b3d6b7"
+            "81f88227e532f719b9c980de534f81ce5883d2c6ecff24a5a02cead2f21ef1def62cd5c53e424d44"
+            "f5efb2e44fbe1ddfc0279580350aee5b",
+            "80196a83dae8f390107dff5920cf1bde",
+            "b536599f05b8c839b357497bb06e7fe401474cf58eefc706add16fa1b30e19f880c111cfef33cef8"
+            "e45138d47c4fdc474316d8012e092fd2d02aa778f0f93356fc2471e0f3391b8495cb8cfedbff43b3"
+            "5aceb526db26866ea2b5f289f478f4a0fcce44e24a308fbea595897aa4f1654206e0b0e6fe6c872d"
+            "198df6ba25da62fd75cab77deb9afe4cb322a6aa506707ae005eaaf8337d52538bef70927bc6cd34"
+            "1434aeb7d50e1067e218a719e35abb5419e3f5ed02d34557b24055cbbc88d7e5a7e5680a4158921e"
+            "e7889681d404ea47b875e75a3cd13cafbd8f274f996dc4208b3852b94d01986654b03b5cac944e77"
+            "ee9e1297ff5b9bbe02b4216f622a7af5",
+            "425025343cc35979ab10348c754a2382bc4051cd8ff4025121d65714387ae6462f2890d6e1c4299a"
+            "3b30802e0baabc94b8c17f688bc1181cc47f609fab6a86353313e8aba7b6581757c8de060d21353e"
+            "3a7f32505ad8e53e6867fbd772407329c837ef15468e0469cfb0c3813f58ddf46314229e09be8c5b"
+            "6b16e81738efe11f8a693894c3ef580597b57f7b5bb72dad1f563d9c6b234de9057d84702419fc3c"
+            "902879a5249fabe534682e3cc56e69c5be76fd6475d534595b3182b118add8e6f659a6bc4792e225"
+            "73122741c2d7e9b9b563231c9493ec9760c3c2d6a29907be8971528602104f8c3e32f188924233de"
+            "93e2b9122448ace7624989cf1e95194a"},
+        // Even modulus.
+        {"e93c8ff18e78ab1919a07c1cfee57bd85870f09b09b7f851e987745277452db0",
+            "462be8a0e8ea5a74",
+            "9a6d2c912ee2fcc4cc166849ac67d9e1ffc0f7177d0f7bae4300000000000000",
+            "2f43dc303cb2db012e5d8dad5e22f9bfcba02864af61a9e44600000000000000"},
+        // Even modulus with the odd part 1.
+        {"68eb1c14dbea276db4c37eacedd91698f461ed69323677e93c8c91dda84c486e",
+            "b54a9c07cc881f55",
+            "0000000000000000000000000000000400000000000000000000000000000000",
+            "0000000000000000000000000000000000000000000000000000000000000000"},
+        // Even modulus with the multi-word odd part.
+        {"05362752046c46840da93335a86ac70658882d81d471d7b3e828b151ae6d37b9c4c03b72e065dfad"
+            "6e623b0fbddb51448a2e053162d1ff00a91bc7e5138cd424e2442bd0a60189f5d0d8d0828dac4776"
+            "0df5fab9776fcd98c0107afdbb1052d94aff96d91bde64de095288d366c399027058d2c8430c96f5"
+            "86b708a8827aa39c",
+            "cd94068bd27513aa",
+            "00000035a07682cd11d488298ab5f3ca36fb4a147f80d8fa730ab6b005910edf30ef19d9fb19f749"
+            "d325b4ba8df1fbda093734083c51f41463830004520310b8e59d4e2d619dd663b0dcb99151521386"
+            "fccc81a3b7a35a0d19a70637ad32b304eb6933ca98946046ccead0b973d0271f2aac7cf000000000"
+            "0000000000000000",
+            "00000018a29b1c73ee106d9516a1cf332068d9daf68e7b0388cc5ceea926b6c79c6f03614a21050a"
+            "a2131e297b3d4df6423d4260ae99d50cd191506d381668b7bfcfe743f4119d132ff500c00b8305ce"
+            "e6c6efcfc5d76b18df38ce9aff7ff2b4e6ba490aa39bdc65a65f21af6a3f0573b05b365000000000"
+            "0000000000000000"},
+        // The modulus longer than 4096 bits.
+        {"37db0190c86f7fa8f0191f872e92fd1a66212ae8980fd1f55803bb29fdb05d1f95b901f99105a0c7"
+            "cca85a03ad468bc46c642700fd34a0ccb5052f233b4d07cb24b43d00a459773570046dbdf97ff336"
+            "ed0bfd191d04f463df655c3cf9f403ab419ba5c199a03212ea6fd46e4893b54be824f12e2a312151"
+            "17909b40485ac1532985423fc332b5b20640019c388eb7895f9c45c8eabf5fcce4ebebb36d0a3e34"
+            "dca5573cd12e4e89b0675092bd0c042842a8c560e6fe6410f20154deba05f8c7630303f2b7af5e3f"
+            "8ec23b1e0ae93bcb77e87171570ad615d7eaf665cbbc5c77182066bf97ac14adabe26709cccbee58"
+            "0ae24f055f59d24548830ffa0c3b5f4156b8b28bb445cfde5f215e0aa721004fc5a1ba38cdf29fc2"
+            "750082832e0a114365c2a2810674cfe15f743d55fd99e97cf9b6839be721bb3e59b5debd08bfeacc"
+            "7d39325add34aa1ca28f0112516651b9835f70d92971589aad93101764ed785a69758dd443e972b3"
+            "295e6111d886c8b808ab402963f76d9250dc802436fe3c9e2ac1480a9a7604a8fcc7459df99e36f9"
+            "89300daa48b70a0b03f65967bb40945038ef6216748bc3b7952ff42947d66bf7327c56462d077c96"
+            "0780f2808a0f149b054951486e218de370bd4965f3e713b5960815007403051679f20b74f440a653"
+            "af1de4e51dbdeaa505644c7a6db0bcf5022f94a659bb66c668d5757ef2161a205b672bfc9fcc7dca",
+            "9b76066f",
+            "d3d4e9a19b15617ea8d7369714ac1bcaacdaf9fc02ad231ca116124cecfd4e9c524d1104171135f5"
+            "098496e9af1ad9f69619d9acab81d8109de9572d83c2181cbd06a69f36a55cfd02f07e4f99ef98b8"
+            "38558da265e227f96bb1b23adcd377e8b8c1c01d22d6141c86095b59cd1023a63709f2143e367b72"
+            "4ae0ad4abb12058eebac0c0d98bd7166b097265beed46a8ba6416929ba4eed38406b4571fd8e3299"
+            "06b2df90aeee65af08d360c52b0662a4e436ca130c26d79ad3e02aaa8820bdc1649779dc28275440"
+            "5cef51ea91a3059aff0da097929d5235756a79863ae78b844019f119d5838c4c8f3d3d4ce7fddc63"
+            "2c9be218ca722a2f811886edb1fc2cfb2c0e8e53b43580601657ab2a2f3a14d1bccf8531a3d1c2f3"
+            "9eaaf9f9d742ddc4e5c1e79dfb2998f5edb11706fbe0aeb1cd8087e8cd99c368ccade7996f34001e"
+            "385a856d9f2ac30ed41b8f087f1f42512a848136f7a7c025cf9c3f9b10376d1478dc249f0873997d"
+            "e43b0fe83d72bd07eb2bed4d77995922adfc6b8b2a0be95c887bf3a048e624253003dfb20de3f5d3"
+            "bca9d9f44d453fb6e20908e628ef32b5d1271616268a3b0a201173066a0ae586acd2ab8dd9d26bd3"
+            "fc01327f86d87531874fb446e43d607b31c5c1bcfb34aac9657e44464e7a3df726fc29b92eb80fe1"
+            "37ad207eac3edb9f954d1462a3b19eae964db2d16fc8892f895163915fc5e31ddf5a62367f64d713",
+            "774f2919a4362d3e51414e9781e22c46a706e4b1320fd1d314d573014774b3b18b1030d4ba01ca71"
+            "e69b1eebf4e853d746ffcac193347c31efa0cfb7af70af2c76bc9b1e52e31a1e840d7d10e5340b77"
+            "891fa992e28ed8fa1159bdfdd03b5650364811cc7364a25e35d80f7ffd987dac112541931c506742"
+            "ad39aebe07d5e52bf0a72b714573a561ede0243f127d8119eb7442eea54a8d96704a58ac6a49fe9d"
+            "093f029f1173b167aaa1d612733d171676fb52592e0d5af08b2ed598db795edcbf2fd304b93b3333"
+            "00c92109794dfa772bd7a8ea0d82edfcdf7e04d73e7102e242f186205f1da1135b17ff2177b9ba27"
+            "c36213069b433b85e045cb838db3466a0966b9e1f0aaed30981fd0c1000329356221f4d3d3631408"
+            "ccd517a19446df5f1ed5e2dd48d6f6e6a43592ab9f0d7856544fb64fd3eb59d3e3b0b6a1514920a4"
+            "19234034f2414cc827c1c7175e89e639d0ab7777a04fd96678392854d7324939fb605d1e40196b60"
+            "4a507f4d526ae99984a81dae99195897932b2f7e88345b08a9838ce53b7874bc38dd12ccedf925a4"
+            "5581ca493a65e1d0cbbf7f3e11c34beddba44f923e905bb1613d91e70eae375921716287f4d426da"
+            "463fe4486970a7482572031650f728e6fa2ca7e9f7ae7b87b461cb4bafbc849fab9ef82bfeb4a629"
+            "d9ee64c81ff21ae7c5068983f36d9821e539ea996dfea34ca4ebc0899a7fc4d6c14c7a9d0690a93e"},
+        // The even modulus longer than 4096 bits.
+        {"bda07fdd0e6defab7f7042948aed655fc14f3219d6a8ee7cafeefc8532aba8611f03e364ec6df700"
+            "85d537f1f9d7051442bc93b6994e07a7f91eb45ac963f1f2fb456c0fdab60d1fe66f8ec3cdcfd332"
+            "8d6b3c8804ac0591e2b5b7e862a49df86d2953762ca442de7bab075b7294fed5841ae527661a6927"
+            "63b3fbf4c02261f005b9587e8b3324ba8d73641f6f8328a9d6c61cefaf70957bd4833ff86b73f76d"
+            "35add73593121493c47970e5783bc8e266c85b84b25c23cc747b2fbd562ab40fad075c0fbbe4350d"
+            "b646a95225d5433cef3cc87ce6b12a94f59069bb00ba33893e8dbfe606472d2c22d1664443f5a5f1"
+            "c2f88450efeeb6c31e66aedd21fd80b64e0a9d5005766582739da4592e3fef12ef486ebc2f863463"
+            "9b6d61cd2ac9b065ab5c122373d6faa6024c000922df4c9ace128ecc0d5679adf956dac4d01ab5bf"
+            "7ad01f4246ec10ad012b3bfea980e20b4640d158c717ac267d3a9fe9fb1588174d6b714b812ed14f"
+            "f0c4d47e62e538adaa0e2bc5bec9a9d7459dcdae63b430957bcf3a74cf3d34122f6c73b8e330fb42"
+            "d1d21475e2273e76865037e0e8722e486119aef5af19b56a337c985fa8920f3251b27ece3002d25e"
+            "586df3b2e9f37577b2fb34dc73c3ad496cf8e85b7c2ae47245d9b51645f44be089e2c75e313e873f"
+            "09031df99cffb33e6140fa934a8d48f6a307d7e771e920283e080589ebc917a6125a4ba6ad880eac",
+            "f5d64320",
+            "ffe533cef772161b43a49cb4249c324dfa6c2fa4fd993fc405c649c2fddff909922376d5531824ed"
+            "344a1c6368e6a5634d25036612061d48fd2a8fbde6c6f70d92dedc03ae6b2b77214d5300d7dcd23e"
+            "6ea228d81a6d7f02503494d45e1c08731b9dfd22c35fe879b5358407e7836c4c4a0f2fd84c874227"
+            "49bb0378d643beab7a8da5f6d9b8f032c30d6cd3ae81b670298c213eba7dd3c49fda6d568bd51c1b"
+            "2c0e2b78fbc78548e955b0d97c1a6bacf9d271259e326d8c042a85db275e32b9dddac2828aef60aa"
+            "60b3352cd061fea20ff69dfb7d6a99fa91bc52f96e80a22aa50928b080f688b7ce5891cb6356cc78"
+            "b41f3d8b5e4d19931334e4f06d7b7dfcc40e73b0f50514ff03757ba64bb0c9cf5c962ed206dfb2c4"
+            "32ddea10cda6ceda78d69657eb64da3826671f23b07ad22663f187f4fc7fd2138f7821d2c04c2885"
+            "fb0b00a9c0d2e506f316b584203fee45b3a4a48d32858f9aa77ec4fcd28473b77b849620b089e130"
+            "5ea9d01b01dab8ec74fd611b484aafc753cdebc23f343645a784f3d1232642b3fae1cd0479e231b0"
+            "a7d3073ccda9f8d886f77f7d3e9250d60ed519bf356d649843dff8036200005af1432634d9b1d677"
+            "e142532bdaea76bdaf1dfaac716a2037a1f70359baf4dcf6c11fae1254fae5e640fc11ae33bb48be"
+            "d74c00aad5a0a741ce2c768965933fbff1a7f13e6d8b54d0f6dde37ad0e8c3c00000000000000000",
+            "2a79cd69248e06de9e817875db9fce6ed44c571b4d06b6d17a32d22bc4f06042990b34a9681344c8"
+            "0aa7bc36aaf152e4855fe3439fa1170b91b84ca53aeb98b3c6ed1e2089ae3262b0f11ed6baee381d"
+            "678f7328602e9d57852ca44ff75e2b535690bb110e22d7dff8d476b5e62948fb74f90012cd4fdca3"
+            "f560aeab31e25085dc3545944e7781f6eb30f4b9539bc15d30a614d37e9ee2ec3b83e60148a71772"
+            "e90d58dd4c66779f291b4c193765f54c50312f0f30b69fe8bbd90dc4380b280ad8d25a77b8445cb9"
+            "97fef3902f76131f4d88e18d90eb4bf4066b759905a4df28f988da7679687a6fbeac0ef7758aabde"
+            "5b5f08840f80a0c39399b32c8cc5b5f34a941377d6845a85577d7d787361f60b0e8698c09b631b47"
+            "839f4d4b696852b5081eef2dc9deefc1bfa4f5e35c788f82159cf8fd3bea1f43abb265f2cc71f336"
+            "b46de0a6184a7cd9ff9b852825992b55770df87d9380cf59783c409f422ae0ac7009b991f33c6769"
+            "81b1de7b66f2cf4b57be901f2e00d704381bdf5b5ccfd8ffb72bcb4779d41e58e6d2b33900df72fc"
+            "aad98fae3943f626cc3718bbfb8517df300a129e256440c8862a3b0423527a073f27720f7e5041b0"
+            "89e56db21114daafcb3c2c37906fda0721bd6a4f2deffede2e4341074303bbfd808023b23af0c3e5"
+            "db31fc1e234ae7552aeb258c15505affc4932602eb4784f40e27804e2d039b800000000000000000"},
+    };
+
+    for (const auto& [base_hex, exp_hex, mod_hex, expected_hex] : test_cases)
+    {
+        const auto base = evmc::from_hex(base_hex).value();
+        const auto exp = evmc::from_hex(exp_hex).value();
+        const auto mod = evmc::from_hex(mod_hex).value();
+        evmc::bytes output(mod.size(), 0xff);
+        modexp(base, exp, mod, output.data());
+        EXPECT_EQ(evmc::hex(output), expected_hex);
+    }
+}
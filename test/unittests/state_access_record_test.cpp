@@ -0,0 +1,69 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone/evmone.h>
+#include <gtest/gtest.h>
+#include <test/state/access_record.hpp>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+#include <test/utils/bytecode.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+TEST(state_access_record, transition)
+{
+    static constexpr auto Sender = 0x5e_address;
+    static constexpr auto To = 0x70_address;
+    static constexpr auto B = 0xbb_address;
+    static constexpr auto C = 0xcc_address;
+    static constexpr auto Coinbase = 0xc014bace_address;
+
+    evmc::VM vm{evmc_create_evmone()};
+    const TestState pre{
+        {Sender, {.balance = 1'000'000}},
+        {To, {.code = sstore(2, sload(1)) + push(B) + OP_BALANCE + OP_POP + push(C) +
+                      OP_EXTCODESIZE + OP_POP}},
+        {C, {.code = bytecode{OP_STOP}}},
+    };
+    const BlockInfo block{.gas_limit = 1'000'000, .coinbase = Coinbase};
+    const Transaction tx{.gas_limit = 100'000,
+        .max_gas_price = 1,
+        .max_priority_gas_price = 1,
+        .sender = Sender,
+        .to = To};
+
+    AccessRecord record;
+    const auto res = transition(pre, block, tx, EVMC_CANCUN, vm, block.gas_limit,
+        BlockInfo::MAX_BLOB_GAS_PER_BLOCK, &record);
+    ASSERT_TRUE(holds_alternative<TransactionReceipt>(res));
+    EXPECT_EQ(std::get<TransactionReceipt>(res).status, EVMC_SUCCESS);
+
+    // The coinbase is warm but the execution hasn't read it.
+    EXPECT_EQ(record.accounts_read, (std::set{Sender, To, B, C}));
+    EXPECT_EQ(record.accounts_written, (std::set{Sender, To, Coinbase}));
+    using StorageKeys = std::set<std::pair<address, bytes32>>;
+    EXPECT_EQ(record.storage_read, (StorageKeys{{To, 0x01_bytes32}, {To, 0x02_bytes32}}));
+    EXPECT_EQ(record.storage_written, (StorageKeys{{To, 0x02_bytes32}}));
+    EXPECT_EQ(record.code_loaded, (std::set{To, C}));
+}
+
+TEST(state_access_record, invalid_transaction)
+{
+    static constexpr auto Sender = 0x5e_address;
+
+    evmc::VM vm{evmc_create_evmone()};
+    const TestState pre{{Sender, {.balance = 1}}};
+    const BlockInfo block{.gas_limit = 1'000'000};
+    const Transaction tx{.gas_limit = 21000, .max_gas_price = 1, .sender = Sender, .to = Sender};
+
+    AccessRecord record;
+    const auto res = transition(pre, block, tx, EVMC_CANCUN, vm, block.gas_limit,
+        BlockInfo::MAX_BLOB_GAS_PER_BLOCK, &record);
+    ASSERT_TRUE(holds_alternative<std::error_code>(res));
+    EXPECT_EQ(record.accounts_read, std::set{Sender});
+    EXPECT_TRUE(record.accounts_written.empty());
+    EXPECT_TRUE(record.code_loaded.empty());
+}
@@ -0,0 +1,60 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/block_commitments.hpp>
+#include <test/state/mpt_hash.hpp>
+#include <test/state/rlp.hpp>
+
+using namespace evmc::literals;
+using namespace evmone;
+using namespace evmone::state;
+
+TEST(state_block_commitments, empty)
+{
+    const auto c = compute_block_commitments({}, {}, {}, 4);
+    EXPECT_EQ(c.transactions_root, EMPTY_MPT_HASH);
+    EXPECT_EQ(c.receipts_root, EMPTY_MPT_HASH);
+    EXPECT_EQ(c.withdrawals_root, EMPTY_MPT_HASH);
+    EXPECT_EQ(bytes_view{c.logs_bloom}, bytes_view{BloomFilter{}});
+}
+
+TEST(state_block_commitments, same_as_sequential)
+{
+    std::vector<Transaction> txs;
+    std::vector<TransactionReceipt> receipts;
+    std::vector<Withdrawal> withdrawals;
+    for (uint64_t i = 0; i < 300; ++i)
+    {
+        txs.push_back({.gas_limit = 21000, .to = 0x01_address, .value = i, .nonce = i});
+
+        auto& r = receipts.emplace_back();
+        r.status = EVMC_SUCCESS;
+        r.gas_used = 21000;
+        r.cumulative_gas_used = static_cast<int64_t>(i + 1) * 21000;
+        if (i % 7 == 0)
+        {
+            r.logs.push_back({.addr = address{i}, .data = {}, .topics = {bytes32{i}}});
+            r.logs_bloom_filter = compute_bloom_filter(r.logs);
+        }
+
+        if (i % 10 == 0)
+            withdrawals.push_back({.index = i, .validator_index = i, .recipient = address{i}});
+    }
+
+    std::vector<bytes> encoded_txs;
+    for (const auto& tx : txs)
+        encoded_txs.emplace_back(rlp::encode(tx));
+
+    EXPECT_EQ(mpt_hash_encoded(encoded_txs), mpt_hash(txs));
+
+    for (const size_t num_threads : {0u, 1u, 3u, 8u})
+    {
+        const auto c = compute_block_commitments(encoded_txs, receipts, withdrawals, num_threads);
+        EXPECT_EQ(c.transactions_root, mpt_hash(txs));
+        EXPECT_EQ(c.receipts_root, mpt_hash(receipts));
+        EXPECT_EQ(c.withdrawals_root, mpt_hash(withdrawals));
+        EXPECT_EQ(bytes_view{c.logs_bloom}, bytes_view{compute_bloom_filter(receipts)});
+    }
+}
@@ -0,0 +1,94 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone/evmone.h>
+#include <gtest/gtest.h>
+#include <test/state/block_state.hpp>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+#include <test/utils/bytecode.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+TEST(state_block_state, merged_diff)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    static constexpr auto K1 = 0x01_bytes32;
+    static constexpr auto K2 = 0x02_bytes32;
+
+    TestState state{{A, {.nonce = 1, .storage = {{K1, 0x11_bytes32}}, .code = bytes{0xfe}}}};
+    BlockState block_state{state};
+
+    StateDiff d1;
+    d1.modified_accounts.push_back({A, 2, 0, {}, {{K2, 0x22_bytes32}}});
+    d1.modified_accounts.push_back({B, 0, 1, {}, {}});
+    block_state.apply(d1);
+    EXPECT_EQ(block_state.get_account(A)->nonce, 2);
+    EXPECT_EQ(block_state.get_storage(A, K1), 0x11_bytes32);
+    EXPECT_EQ(block_state.get_storage(A, K2), 0x22_bytes32);
+    EXPECT_EQ(block_state.get_account_code(A), bytes{0xfe});
+
+    // Delete and create A again.
+    StateDiff d2;
+    d2.deleted_accounts.push_back(A);
+    block_state.apply(d2);
+    EXPECT_FALSE(block_state.get_account(A).has_value());
+    StateDiff d3;
+    d3.modified_accounts.push_back({A, 1, 3, bytes{0x00}, {{K2, 0x23_bytes32}}});
+    block_state.apply(d3);
+    EXPECT_EQ(block_state.get_storage(A, K1), bytes32{});
+    EXPECT_EQ(block_state.get_storage(A, K2), 0x23_bytes32);
+    EXPECT_EQ(block_state.get_account_code(A), bytes{0x00});
+    EXPECT_EQ(block_state.get_account(A)->code_hash, keccak256(bytes{0x00}));
+
+    // The underlying state is not modified until the block diff is applied.
+    EXPECT_EQ(state.at(A).nonce, 1);
+    state.apply(block_state.build_diff());
+    const TestState expected{
+        {A, {.nonce = 1, .balance = 3, .storage = {{K2, 0x23_bytes32}}, .code = bytes{0x00}}},
+        {B, {.balance = 1}},
+    };
+    EXPECT_EQ(state, expected);
+}
+
+TEST(state_block_state, same_as_sequential)
+{
+    static constexpr auto Sender = 0x5e_address;
+    static constexpr auto Counter = 0xc0_address;
+    static constexpr auto rev = EVMC_CANCUN;
+
+    evmc::VM vm{evmc_create_evmone()};
+    const TestState pre{
+        {Sender, {.balance = 1'000'000}},
+        {Counter, {.code = sstore(0, add(sload(0), 1))}},
+    };
+    const BlockInfo block{.gas_limit = 1'000'000, .coinbase = 0xc014bace_address};
+
+    auto sequential = pre;
+    auto block_scoped = pre;
+    BlockState block_state{block_scoped};
+    for (uint64_t nonce = 0; nonce < 3; ++nonce)
+    {
+        const Transaction tx{.gas_limit = 100'000,
+            .max_gas_price = 1,
+            .max_priority_gas_price = 1,
+            .sender = Sender,
+            .to = Counter,
+            .nonce = nonce};
+        constexpr auto blob_gas_left = BlockInfo::MAX_BLOB_GAS_PER_BLOCK;
+        const auto r1 = transition(sequential, block, tx, rev, vm, block.gas_limit, blob_gas_left);
+        ASSERT_TRUE(holds_alternative<TransactionReceipt>(r1));
+        const auto r2 = transition(block_state, block, tx, rev, vm, block.gas_limit, blob_gas_left);
+        ASSERT_TRUE(holds_alternative<TransactionReceipt>(r2));
+        block_state.apply(std::get<TransactionReceipt>(r2).state_diff);
+        EXPECT_EQ(std::get<TransactionReceipt>(r2).gas_used,
+            std::get<TransactionReceipt>(r1).gas_used);
+    }
+    block_scoped.apply(block_state.build_diff());
+    EXPECT_EQ(block_scoped, sequential);
+    EXPECT_EQ(block_scoped.at(Counter).storage.at(0x00_bytes32), 0x03_bytes32);
+}
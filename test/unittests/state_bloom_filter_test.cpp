@@ -81,3 +81,18 @@ TEST(state_bloom_filter, combine_blooms_simgle_transaction)
     const auto res = compute_bloom_filter(logs);
     EXPECT_EQ(bytes_view(res), expected_result);
 }
+
+TEST(state_bloom_filter, duplicated_entries)
+{
+    // The same transaction as above, but with the log entries duplicated and shuffled.
+    const auto addr = 0x6e397a41f9fa7362e2c726bff032b4cd3fbc0b3c_address;
+    const auto topic0 = 0x01a1249f2caa0445b8391e02413d26f0d409dabe5330cd1d04d3d0801fc42db3_bytes32;
+    const auto topic1 = 0x497f3c9f61479c1cfa53f0373d39d2bf4e5f73f71411da62f1d6b85c03a60735_bytes32;
+
+    const std::array single{Log{addr, {}, {topic0, topic1}}};
+    const std::array logs{Log{addr, {}, {topic0}}, Log{addr, {}, {topic1, topic0}},
+        Log{addr, {0x01}, {topic1, topic1}}, Log{addr, {}, {}}};
+
+    EXPECT_EQ(bytes_view(compute_bloom_filter(logs)), bytes_view(compute_bloom_filter(single)));
+    EXPECT_EQ(bytes_view(compute_bloom_filter(std::span<const Log>{})), bytes_view(BloomFilter{}));
+}
@@ -0,0 +1,66 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/code_store.hpp>
+#include <test/state/hash_utils.hpp>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+TEST(state_code_store, deduplication)
+{
+    CodeStore store;
+    const bytes code{0x60, 0x01, 0x00};
+    const auto hash = keccak256(code);
+
+    EXPECT_EQ(store.find(hash), nullptr);
+    auto e1 = store.insert(hash, bytes{code});
+    auto e2 = store.insert(hash, bytes{code});
+    EXPECT_EQ(e1, e2);
+    EXPECT_EQ(store.find(hash), e1);
+    EXPECT_EQ(e1->code(), code);
+    EXPECT_EQ(store.size(), 1);
+
+    // The entry is removed when not used any more.
+    e1.reset();
+    e2.reset();
+    EXPECT_EQ(store.find(hash), nullptr);
+    EXPECT_EQ(store.size(), 0);
+}
+
+TEST(state_code_store, shared_by_accounts)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    const bytes code{0x36, 0x3d, 0x3d, 0x37};  // Some unique code.
+
+    const TestState test_state{{A, {.code = code}}, {B, {.code = code}}};
+    State state{test_state};
+    const auto code_a = state.get_code(A);
+    const auto code_b = state.get_code(B);
+    EXPECT_EQ(code_a, code);
+    EXPECT_EQ(code_a.data(), code_b.data());
+    EXPECT_EQ(state.find(A)->code, state.find(B)->code);
+}
+
+TEST(state_code_store, shared_by_states)
+{
+    static constexpr auto A = 0xaa_address;
+    const bytes code{0x36, 0x3d, 0x3d, 0x38};  // Some unique code.
+
+    const TestState test_state{{A, {.code = code}}};
+    ASSERT_NE(test_state.code_store(), nullptr);
+    State state1{test_state};
+    State state2{test_state};
+    EXPECT_EQ(state1.get_code(A).data(), state2.get_code(A).data());
+    EXPECT_EQ(test_state.code_store()->size(), 1);
+
+    // The copy shares the store.
+    const auto copy = test_state;
+    EXPECT_EQ(copy.code_store(), test_state.code_store());
+}
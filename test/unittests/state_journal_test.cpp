@@ -0,0 +1,77 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+TEST(state_journal, rollback_all_entry_kinds)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    static constexpr auto K = 0x01_bytes32;
+
+    const TestState pre{{A, {.nonce = 1, .balance = 100, .storage = {{K, 0x11_bytes32}}}}};
+    State state{pre};
+
+    auto& a = state.get(A);
+    const auto cp0 = state.checkpoint();
+
+    state.journal_bump_nonce(A);
+    ++a.nonce;
+    state.journal_balance_change(A, a.balance);
+    a.balance = 1;
+    state.journal_access_account(A);
+    a.access_status = EVMC_ACCESS_WARM;
+
+    auto& slot = state.get_storage(A, K);
+    state.journal_storage_change(A, K, slot);
+    slot.current = 0x22_bytes32;
+    slot.access_status = EVMC_ACCESS_WARM;
+
+    auto& tslot = a.transient_storage[K];
+    state.journal_transient_storage_change(A, K, tslot);
+    tslot = 0x33_bytes32;
+
+    const auto cp1 = state.checkpoint();
+    EXPECT_GT(cp1, cp0);
+
+    state.journal_create(B, false);
+    state.insert(B, {.nonce = 1});
+    state.journal_destruct(A);
+    a.destructed = true;
+
+    state.rollback(cp1);
+    EXPECT_EQ(state.checkpoint(), cp1);
+    EXPECT_EQ(state.find(B), nullptr);
+    EXPECT_FALSE(a.destructed);
+    EXPECT_EQ(a.nonce, 2);
+
+    state.rollback(cp0);
+    EXPECT_EQ(state.checkpoint(), cp0);
+    EXPECT_EQ(a.nonce, 1);
+    EXPECT_EQ(a.balance, 100);
+    EXPECT_EQ(a.access_status, EVMC_ACCESS_COLD);
+    EXPECT_EQ(slot.current, 0x11_bytes32);
+    EXPECT_EQ(slot.original, 0x11_bytes32);
+    EXPECT_EQ(slot.access_status, EVMC_ACCESS_COLD);
+    EXPECT_EQ(tslot, bytes32{});
+}
+
+TEST(state_journal, touch_rollback)
+{
+    static constexpr auto E = 0xee_address;
+
+    const TestState pre{{E, {}}};
+    State state{pre};
+
+    const auto cp = state.checkpoint();
+    EXPECT_TRUE(state.touch(E).erase_if_empty);
+    state.rollback(cp);
+    EXPECT_FALSE(state.get(E).erase_if_empty);
+}
@@ -0,0 +1,89 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/host.hpp>
+#include <test/state/keccak_memo.hpp>
+#include <test/utils/utils.hpp>
+
+using namespace evmc::literals;
+using namespace evmone;
+using namespace evmone::state;
+using evmone::test::operator""_hex;
+
+TEST(state_keccak_memo, hits)
+{
+    KeccakMemo memo;
+    const bytes a(KeccakMemo::MIN_SIZE, 0xaa);
+    const bytes b(KeccakMemo::MIN_SIZE, 0xbb);
+
+    EXPECT_EQ(memo.keccak256(a), keccak256(a));
+    EXPECT_EQ(memo.keccak256(b), keccak256(b));
+    EXPECT_EQ(memo.stats().hits, 0);
+    EXPECT_EQ(memo.stats().misses, 2);
+
+    // The inputs are stored when seen the second time.
+    EXPECT_EQ(memo.keccak256(a), keccak256(a));
+    EXPECT_EQ(memo.keccak256(b), keccak256(b));
+    EXPECT_EQ(memo.stats().hits, 0);
+    EXPECT_EQ(memo.stats().misses, 4);
+
+    EXPECT_EQ(memo.keccak256(a), keccak256(a));
+    EXPECT_EQ(memo.keccak256(b), keccak256(b));
+    EXPECT_EQ(memo.stats().hits, 2);
+    EXPECT_EQ(memo.stats().misses, 4);
+
+    memo.reset_stats();
+    EXPECT_EQ(memo.stats().hits, 0);
+    EXPECT_EQ(memo.stats().misses, 0);
+}
+
+TEST(state_keccak_memo, verified_by_content)
+{
+    KeccakMemo memo;
+    bytes data(1000, 0x01);
+    const auto h1 = memo.keccak256(data);
+    EXPECT_EQ(memo.keccak256(data), h1);  // Stored.
+
+    // The same size and the same buffer, but the different content.
+    data[999] = 0x02;
+    const auto h2 = memo.keccak256(data);
+    EXPECT_NE(h2, h1);
+    EXPECT_EQ(h2, keccak256(data));
+    EXPECT_EQ(memo.stats().hits, 0);
+}
+
+TEST(state_keccak_memo, not_eligible)
+{
+    KeccakMemo memo;
+    const bytes short_data(KeccakMemo::MIN_SIZE - 1, 0x01);
+    const bytes long_data(KeccakMemo::MAX_SIZE + 1, 0x01);
+    for (int i = 0; i < 2; ++i)
+    {
+        EXPECT_EQ(memo.keccak256(short_data), keccak256(short_data));
+        EXPECT_EQ(memo.keccak256(long_data), keccak256(long_data));
+    }
+    EXPECT_EQ(memo.stats().hits, 0);
+    EXPECT_EQ(memo.stats().misses, 0);
+}
+
+TEST(state_keccak_memo, create2_address)
+{
+    // The EIP-1167 minimal proxy initcode.
+    const auto initcode =
+        "3d602d80600a3d3981f3363d3d373d3d3d363d73bebebebebebebebebebebebebebebebebebebebe"
+        "5af43d82803e903d91602b57fd5bf3"_hex;
+    ASSERT_GE(initcode.size(), KeccakMemo::MIN_SIZE);
+    const auto sender = 0x01_address;
+
+    auto& memo = KeccakMemo::local();
+    memo.reset_stats();
+    const auto addr1 = compute_create2_address(sender, 0x01_bytes32, initcode);
+    const auto addr2 = compute_create2_address(sender, 0x02_bytes32, initcode);
+    const auto addr3 = compute_create2_address(sender, 0x03_bytes32, initcode);
+    EXPECT_NE(addr1, addr2);
+    EXPECT_NE(addr2, addr3);
+    EXPECT_EQ(memo.stats().hits + memo.stats().misses, 3);
+    EXPECT_GE(memo.stats().hits, 1);
+}
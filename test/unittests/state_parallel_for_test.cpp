@@ -0,0 +1,55 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <test/state/parallel_for.hpp>
+#include <stdexcept>
+
+using namespace evmone::state;
+
+TEST(state_parallel_for, all_indexes)
+{
+    for (const size_t num_threads : {0u, 1u, 3u, 8u})
+    {
+        std::vector<std::atomic<int>> counts(100);
+        std::vector<std::atomic<int>> workers(num_threads + 1);
+        parallel_for(counts.size(), num_threads, [&](size_t i, size_t w) {
+            ++counts[i];
+            ++workers[w];
+        });
+        for (const auto& c : counts)
+            EXPECT_EQ(c, 1);
+        int total = 0;
+        for (size_t w = 0; w < workers.size(); ++w)
+        {
+            EXPECT_TRUE(w < std::max(num_threads, size_t{1}) || workers[w] == 0) << w;
+            total += workers[w];
+        }
+        EXPECT_EQ(total, 100);
+    }
+}
+
+TEST(state_parallel_for, empty)
+{
+    parallel_for(0, 4, [](size_t) { FAIL(); });
+}
+
+TEST(state_parallel_for, exception)
+{
+    const auto fn = [](size_t i) {
+        if (i == 10)
+            throw std::runtime_error{"error"};
+    };
+    EXPECT_THROW(parallel_for(1000, 4, fn), std::runtime_error);
+
+    // The remaining indexes are skipped.
+    size_t last = 0;
+    EXPECT_THROW(parallel_for(1000, 1,
+                     [&](size_t i) {
+                         last = i;
+                         fn(i);
+                     }),
+        std::runtime_error);
+    EXPECT_EQ(last, 10u);
+}
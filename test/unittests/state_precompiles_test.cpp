@@ -52,3 +52,93 @@ TEST(state_precompiles, is_precompile)
         EXPECT_FALSE(is_precompile(rev, 0x17_address));
     }
 }
+
+namespace
+{
+// Point evaluation precompile input from Mainnet.
+const auto POINT_EVALUATION_INPUT =
+    "012b08a0504a63aac18383db69fe6b52fc833e3d060b87c2726c4140c909d91807dddd3c80995c2bb3012943e2036e77490b1f6ddc58ca39a4fb4f3225ae56ab11dc2c4d89f777f0f5c2a51f45b73ff1538761f9cf23ed74c74472fea625ad8bace1db77e25ceb316d914182e05dd810f112352e1d6ed9e47af28e2f64e22b94c411794359c2273bc10bc0390963fb1a97bb642307bfa4424c66bd90ecc0ecffd5045e492b40304df20346693db7450457e2c72588a6a2b1a16909e2ab1e6284"_hex;
+
+/// The input with the wrong evaluation y.
+bytes invalid_point_evaluation_input()
+{
+    auto input = POINT_EVALUATION_INPUT;
+    input[95] ^= 1;
+    return input;
+}
+
+evmc_status_code call_point_evaluation(bytes_view input)
+{
+    evmc_message msg{};
+    msg.gas = 100000;
+    msg.code_address = 0x0a_address;
+    msg.input_data = input.data();
+    msg.input_size = input.size();
+    return call_precompile(EVMC_CANCUN, msg).status_code;
+}
+}  // namespace
+
+TEST(state_precompiles, point_evaluation_prevalidate)
+{
+    auto& batch = PointEvaluationBatch::local();
+    batch.clear();
+
+    const auto invalid = invalid_point_evaluation_input();
+    EXPECT_FALSE(batch.find(POINT_EVALUATION_INPUT).has_value());
+
+    const bytes_view inputs[]{POINT_EVALUATION_INPUT, invalid, bytes_view{invalid}.substr(1)};
+    batch.prevalidate(inputs);
+    EXPECT_EQ(batch.find(POINT_EVALUATION_INPUT), true);
+    EXPECT_EQ(batch.find(invalid), false);
+    EXPECT_FALSE(batch.find(bytes_view{invalid}.substr(1)).has_value());
+
+    EXPECT_EQ(call_point_evaluation(POINT_EVALUATION_INPUT), EVMC_SUCCESS);
+    EXPECT_EQ(call_point_evaluation(invalid), EVMC_PRECOMPILE_FAILURE);
+
+    batch.clear();
+    EXPECT_FALSE(batch.find(POINT_EVALUATION_INPUT).has_value());
+}
+
+TEST(state_precompiles, point_evaluation_deferred)
+{
+    auto& batch = PointEvaluationBatch::local();
+    batch.clear();
+    batch.set_deferred(true);
+
+    // The proofs are assumed valid until verified.
+    const auto invalid = invalid_point_evaluation_input();
+    EXPECT_EQ(call_point_evaluation(POINT_EVALUATION_INPUT), EVMC_SUCCESS);
+    EXPECT_EQ(call_point_evaluation(invalid), EVMC_SUCCESS);
+    EXPECT_EQ(call_point_evaluation(invalid), EVMC_SUCCESS);
+    EXPECT_FALSE(batch.verify_deferred());
+
+    // The results are known now so the execution can be repeated.
+    EXPECT_EQ(call_point_evaluation(POINT_EVALUATION_INPUT), EVMC_SUCCESS);
+    EXPECT_EQ(call_point_evaluation(invalid), EVMC_PRECOMPILE_FAILURE);
+    EXPECT_TRUE(batch.verify_deferred());
+
+    batch.set_deferred(false);
+    batch.clear();
+}
+
+TEST(state_precompiles, point_evaluation_deferred_limit)
+{
+    auto& batch = PointEvaluationBatch::local();
+    batch.clear();
+    batch.set_deferred(true, 1);
+
+    // Only the first proof is deferred, the following one is verified immediately.
+    const auto invalid = invalid_point_evaluation_input();
+    EXPECT_EQ(call_point_evaluation(POINT_EVALUATION_INPUT), EVMC_SUCCESS);
+    EXPECT_EQ(call_point_evaluation(invalid), EVMC_PRECOMPILE_FAILURE);
+    EXPECT_FALSE(batch.find(invalid).has_value());
+    EXPECT_TRUE(batch.verify_deferred());
+    EXPECT_EQ(batch.find(POINT_EVALUATION_INPUT), true);
+
+    // The limit applies to the proofs deferred after the verification.
+    EXPECT_EQ(call_point_evaluation(invalid), EVMC_SUCCESS);
+    EXPECT_FALSE(batch.verify_deferred());
+
+    batch.set_deferred(false);
+    batch.clear();
+}
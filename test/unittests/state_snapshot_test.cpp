@@ -0,0 +1,125 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone/evmone.h>
+#include <gtest/gtest.h>
+#include <test/state/state.hpp>
+#include <test/state/state_snapshot.hpp>
+#include <test/state/test_state.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+TEST(state_snapshot, layers)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    static constexpr auto K1 = 0x01_bytes32;
+    static constexpr auto K2 = 0x02_bytes32;
+
+    const TestState base{{A, {.nonce = 1, .balance = 10, .storage = {{K1, 0x11_bytes32}}}}};
+    const StateSnapshot s0{base};
+    EXPECT_EQ(s0.depth(), 0);
+
+    StateDiff d1;
+    d1.modified_accounts.push_back({A, 2, 9, {}, {{K1, 0x12_bytes32}, {K2, 0x22_bytes32}}});
+    d1.modified_accounts.push_back({B, 1, 1, bytes{0x00}, {}});
+    const auto s1 = s0.apply(d1);
+    EXPECT_EQ(s1.depth(), 1);
+
+    StateDiff d2;
+    d2.deleted_accounts.push_back(B);
+    d2.modified_accounts.push_back({A, 3, 8, {}, {{K1, bytes32{}}}});
+    const auto s2 = s1.apply(d2);
+    EXPECT_EQ(s2.depth(), 2);
+
+    // The base and older snapshots are not affected.
+    EXPECT_EQ(base.get_account(A)->nonce, 1);
+    EXPECT_EQ(s0.get_storage(A, K1), 0x11_bytes32);
+    EXPECT_FALSE(s0.get_account(B).has_value());
+
+    EXPECT_EQ(s1.get_account(A)->nonce, 2);
+    EXPECT_EQ(s1.get_storage(A, K1), 0x12_bytes32);
+    EXPECT_EQ(s1.get_storage(A, K2), 0x22_bytes32);
+    ASSERT_TRUE(s1.get_account(B).has_value());
+    EXPECT_EQ(s1.get_account(B)->code_hash, keccak256(bytes{0x00}));
+    EXPECT_EQ(s1.get_account_code(B), bytes{0x00});
+    EXPECT_EQ(s1.get_account(A)->code_hash, base.get_account(A)->code_hash);
+
+    EXPECT_EQ(s2.get_account(A)->nonce, 3);
+    EXPECT_EQ(s2.get_account(A)->balance, 8);
+    EXPECT_EQ(s2.get_storage(A, K1), bytes32{});
+    EXPECT_EQ(s2.get_storage(A, K2), 0x22_bytes32);
+    EXPECT_FALSE(s2.get_account(B).has_value());
+    EXPECT_TRUE(s2.get_account_code(B).empty());
+}
+
+TEST(state_snapshot, has_storage)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    static constexpr auto K1 = 0x01_bytes32;
+
+    const TestState base{{A, {.nonce = 1, .storage = {{K1, 0x11_bytes32}}}}};
+    const StateSnapshot s0{base};
+
+    // Only the deletions: the storage of B is known to be empty,
+    // the storage of A is conservatively considered non-empty.
+    StateDiff d1;
+    d1.modified_accounts.push_back({A, 1, 0, {}, {{K1, bytes32{}}}});
+    d1.modified_accounts.push_back({B, 1, 0, {}, {{K1, bytes32{}}}});
+    const auto s1 = s0.apply(d1);
+    EXPECT_TRUE(s1.get_account(A)->has_storage);
+    EXPECT_FALSE(s1.get_account(B)->has_storage);
+
+    StateDiff d2;
+    d2.modified_accounts.push_back({B, 1, 0, {}, {{K1, 0x01_bytes32}}});
+    const auto s2 = s1.apply(d2);
+    EXPECT_TRUE(s2.get_account(B)->has_storage);
+
+    // The storage of the recreated account starts empty.
+    StateDiff d3;
+    d3.deleted_accounts.push_back(A);
+    d3.modified_accounts.push_back({A, 1, 0, {}, {{K1, bytes32{}}}});
+    const auto s3 = s2.apply(d3);
+    EXPECT_FALSE(s3.get_account(A)->has_storage);
+    EXPECT_EQ(s3.get_storage(A, K1), bytes32{});
+}
+
+TEST(state_snapshot, fork_transactions)
+{
+    static constexpr auto Sender = 0x5e_address;
+    static constexpr auto To = 0x70_address;
+    static constexpr auto rev = EVMC_SHANGHAI;
+
+    evmc::VM vm{evmc_create_evmone()};
+    const TestState base{{Sender, {.balance = 1'000'000}}};
+    const BlockInfo block{.gas_limit = 1'000'000};
+
+    const auto execute = [&](const StateSnapshot& s, uint64_t nonce, uint64_t value) {
+        const Transaction tx{
+            .gas_limit = 21000, .sender = Sender, .to = To, .value = value, .nonce = nonce};
+        const auto res = transition(
+            s, block, tx, rev, vm, block.gas_limit, BlockInfo::MAX_BLOB_GAS_PER_BLOCK);
+        EXPECT_TRUE(holds_alternative<TransactionReceipt>(res));
+        return s.apply(std::get<TransactionReceipt>(res).state_diff);
+    };
+
+    const StateSnapshot s0{base};
+    const auto s1 = execute(s0, 0, 1);
+
+    // Execute alternative continuations from the same snapshot.
+    const auto s2a = execute(s1, 1, 2);
+    const auto s2b = execute(s1, 1, 3);
+
+    EXPECT_FALSE(s0.get_account(To).has_value());
+    EXPECT_EQ(s1.get_account(To)->balance, 1);
+    EXPECT_EQ(s2a.get_account(To)->balance, 3);
+    EXPECT_EQ(s2b.get_account(To)->balance, 4);
+    EXPECT_EQ(s2a.get_account(Sender)->nonce, 2);
+    EXPECT_EQ(s2b.get_account(Sender)->nonce, 2);
+    EXPECT_EQ(s2b.get_account(Sender)->balance, 1'000'000 - 4);
+    EXPECT_EQ(base.at(Sender).nonce, 0);
+}
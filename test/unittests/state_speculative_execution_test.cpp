@@ -0,0 +1,124 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone/evmone.h>
+#include <gtest/gtest.h>
+#include <test/state/speculative_execution.hpp>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+#include <test/utils/bytecode.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+namespace
+{
+/// Executes the block transactions sequentially and speculatively in parallel,
+/// checks that the results are the same and returns the speculation stats.
+SpeculationStats check_same_as_sequential(const intx::uint256& priority_gas_price)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    static constexpr auto C = 0xcc_address;
+    static constexpr auto Counter = 0xc0_address;
+    static constexpr auto rev = EVMC_CANCUN;
+
+    evmc::VM vm{evmc_create_evmone()};
+    std::array<evmc::VM, 3> workers{evmc::VM{evmc_create_evmone()},
+        evmc::VM{evmc_create_evmone()}, evmc::VM{evmc_create_evmone()}};
+
+    const TestState pre{
+        {A, {.balance = 1'000'000}},
+        {B, {.balance = 1'000'000}},
+        {C, {.balance = 1'000'000}},
+        // Increments the storage slot 0.
+        {Counter, {.code = sstore(0, add(sload(0), 1))}},
+    };
+    const BlockInfo block{.gas_limit = 1'000'000, .coinbase = 0xc014bace_address};
+
+    std::vector<Transaction> txs;
+    const auto add_tx = [&](const address& sender, uint64_t nonce, const address& to) {
+        txs.push_back({.gas_limit = 100'000,
+            .max_gas_price = 1,
+            .max_priority_gas_price = priority_gas_price,
+            .sender = sender,
+            .to = to,
+            .value = 1,
+            .nonce = nonce});
+    };
+    add_tx(A, 0, Counter);
+    add_tx(B, 0, C);        // Independent.
+    add_tx(C, 0, Counter);  // Depends on A's tx and B's tx.
+    add_tx(A, 1, B);        // Depends on A's previous tx.
+    add_tx(A, 3, B);        // Invalid: nonce too high.
+    add_tx(B, 1, Counter);  // Depends on all previous.
+
+    SpeculationStats stats;
+    const auto run = [&](bool parallel) {
+        auto state = pre;
+        std::vector<SpeculativeTransition> speculations;
+        if (parallel)
+            speculations = speculate(state, block, txs, rev, workers);
+        std::vector<std::variant<TransactionReceipt, std::error_code>> results;
+        int64_t block_gas_left = block.gas_limit;
+        for (size_t i = 0; i < txs.size(); ++i)
+        {
+            constexpr auto blob_gas_left = BlockInfo::MAX_BLOB_GAS_PER_BLOCK;
+            auto res = parallel ? transition(state, block, txs[i], rev, vm, block_gas_left,
+                                      blob_gas_left, std::move(speculations[i]), &stats) :
+                                  transition(state, block, txs[i], rev, vm, block_gas_left,
+                                      blob_gas_left);
+            if (const auto r = get_if<TransactionReceipt>(&res))
+                block_gas_left -= r->gas_used;
+            results.emplace_back(std::move(res));
+        }
+        return std::pair{std::move(state), std::move(results)};
+    };
+
+    const auto [seq_state, seq_results] = run(false);
+    const auto [par_state, par_results] = run(true);
+
+    EXPECT_EQ(par_state, seq_state);
+    EXPECT_EQ(stats.reused + stats.reexecuted, txs.size());
+    EXPECT_EQ(par_results.size(), seq_results.size());
+    for (size_t i = 0; i < std::min(seq_results.size(), par_results.size()); ++i)
+    {
+        EXPECT_EQ(par_results[i].index(), seq_results[i].index()) << i;
+        if (par_results[i].index() != seq_results[i].index())
+            continue;
+        if (const auto r = get_if<TransactionReceipt>(&seq_results[i]))
+        {
+            const auto& p = std::get<TransactionReceipt>(par_results[i]);
+            EXPECT_EQ(p.status, r->status) << i;
+            EXPECT_EQ(p.gas_used, r->gas_used) << i;
+        }
+        else
+        {
+            EXPECT_EQ(std::get<std::error_code>(par_results[i]),
+                std::get<std::error_code>(seq_results[i]))
+                << i;
+        }
+    }
+    EXPECT_EQ(seq_state.at(Counter).storage.at(0x00_bytes32), 0x03_bytes32);
+    return stats;
+}
+}  // namespace
+
+TEST(state_speculative_execution, same_as_sequential)
+{
+    // The first tx and the independent B->C tx are reused, the coinbase fee is rebased
+    // for the second one. All the others depend on the previous txs and are executed again.
+    const auto stats = check_same_as_sequential(1);
+    EXPECT_EQ(stats.reused, 2u);
+    EXPECT_EQ(stats.reexecuted, 4u);
+}
+
+TEST(state_speculative_execution, same_as_sequential_zero_tip)
+{
+    // The coinbase is not modified, so the results are reused without the fee rebase.
+    const auto stats = check_same_as_sequential(0);
+    EXPECT_EQ(stats.reused, 2u);
+    EXPECT_EQ(stats.reexecuted, 4u);
+}
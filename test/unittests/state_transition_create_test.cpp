@@ -359,3 +359,29 @@ TEST_F(state_transition, created_code_hash)
     expect.post[created].code = runtime_code;
     expect.post[To].storage[0x00_bytes32] = keccak256(runtime_code);
 }
+
+TEST_F(state_transition, create2_storage_after_reverted_create2)
+{
+    // The initcode increments the storage slot 1 and reverts if called without value.
+    const auto head = sstore(1, add(sload(1), 1));
+    const auto tail = revert(0, 0);
+    const auto jumpdest_pos = head.size() + jumpi(0, OP_CALLVALUE).size() + tail.size();
+    const auto initcode = head + jumpi(jumpdest_pos, OP_CALLVALUE) + tail + OP_JUMPDEST;
+    ASSERT_EQ(initcode[jumpdest_pos], OP_JUMPDEST);
+
+    // Creates the same address twice: the first attempt is reverted.
+    // The second must not observe the storage of the reverted one.
+    tx.to = To;
+    tx.data = initcode;
+    pre.insert(To, {.balance = 1,
+                       .code = calldatacopy(0, 0, calldatasize()) +
+                               create2().input(0, calldatasize()) +
+                               create2().value(1).input(0, calldatasize())});
+
+    const auto created = compute_create2_address(To, {}, initcode);
+    expect.post[To].nonce = pre.get(To).nonce + 2;
+    expect.post[To].balance = 0;
+    expect.post[created].nonce = 1;
+    expect.post[created].balance = 1;
+    expect.post[created].storage[0x01_bytes32] = 0x01_bytes32;
+}
@@ -0,0 +1,192 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone_precompiles/secp256k1.hpp>
+#include <gtest/gtest.h>
+#include <test/state/precompiles.hpp>
+#include <test/state/rlp.hpp>
+#include <test/state/state.hpp>
+#include <test/state/tx_preparation.hpp>
+
+using namespace evmc::literals;
+using namespace intx::literals;
+using namespace evmone;
+using namespace evmone::state;
+
+namespace
+{
+/// The example transaction from EIP-155 signed with the private key 0x4646...46.
+Transaction eip155_tx()
+{
+    return {
+        .type = Transaction::Type::legacy,
+        .gas_limit = 21000,
+        .max_gas_price = 20'000'000'000,
+        .max_priority_gas_price = 20'000'000'000,
+        .to = 0x3535353535353535353535353535353535353535_address,
+        .value = 1'000'000'000'000'000'000,
+        .chain_id = 1,
+        .nonce = 9,
+        .r = 0x28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276_u256,
+        .s = 0x67cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83_u256,
+        .v = 37,
+    };
+}
+
+/// The EIP-1559 transaction signed with the private key 0x4646...46.
+Transaction eip1559_tx()
+{
+    return {
+        .type = Transaction::Type::eip1559,
+        .gas_limit = 21000,
+        .max_gas_price = 2,
+        .max_priority_gas_price = 1,
+        .to = 0x3535353535353535353535353535353535353535_address,
+        .value = 1,
+        .chain_id = 1,
+        .nonce = 0,
+        .r = 0xbb50e2d89a4ed70663d080659fe0ad4b9bc3e06c17a227433966cb59ceee020d_u256,
+        .s = 0x585a4a7ba09e36021bfef5bd6a52fe2cf9c6b972821aa0b8ec5360750e30617a_u256,
+        .v = 1,
+    };
+}
+
+constexpr auto SIGNER = 0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f_address;
+}  // namespace
+
+TEST(state_tx_preparation, signing_hash)
+{
+    EXPECT_EQ(signing_hash(eip155_tx()),
+        0xdaf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53_bytes32);
+    EXPECT_EQ(signing_hash(eip1559_tx()),
+        0x4373efc1c8669972a802be7f640cd0c0a15bc11495819b84cdaca4ea672fe553_bytes32);
+}
+
+TEST(state_tx_preparation, recover_sender)
+{
+    EXPECT_EQ(recover_sender(eip155_tx(), EVMC_CANCUN), SIGNER);
+    EXPECT_EQ(recover_sender(eip1559_tx(), EVMC_CANCUN), SIGNER);
+
+    // The signature of different data gives a different address.
+    auto tx = eip155_tx();
+    tx.nonce = 10;
+    const auto other = recover_sender(tx, EVMC_CANCUN);
+    ASSERT_TRUE(other.has_value());
+    EXPECT_NE(*other, SIGNER);
+}
+
+TEST(state_tx_preparation, recover_sender_invalid)
+{
+    auto tx = eip155_tx();
+    tx.chain_id = 2;  // v doesn't match the chain id.
+    EXPECT_EQ(recover_sender(tx, EVMC_CANCUN), std::nullopt);
+
+    tx = eip155_tx();
+    tx.v = 29;
+    EXPECT_EQ(recover_sender(tx, EVMC_CANCUN), std::nullopt);
+
+    tx = eip1559_tx();
+    tx.v = 27;  // Typed transactions have the y-parity instead of v.
+    EXPECT_EQ(recover_sender(tx, EVMC_CANCUN), std::nullopt);
+
+    tx = eip1559_tx();
+    tx.r = 0;
+    EXPECT_EQ(recover_sender(tx, EVMC_CANCUN), std::nullopt);
+
+    // EIP-2: the high s-value is invalid since Homestead.
+    tx = eip155_tx();
+    tx.s = evmmax::secp256k1::Order - tx.s;
+    tx.v = 28;
+    EXPECT_EQ(recover_sender(tx, EVMC_HOMESTEAD), std::nullopt);
+    EXPECT_TRUE(recover_sender(tx, EVMC_FRONTIER).has_value());
+}
+
+TEST(state_tx_preparation, recover_sender_eip155_before_spurious_dragon)
+{
+    // The replay protected signatures are only valid since Spurious Dragon.
+    const auto tx = eip155_tx();
+    EXPECT_EQ(recover_sender(tx, EVMC_HOMESTEAD), std::nullopt);
+    EXPECT_EQ(recover_sender(tx, EVMC_TANGERINE_WHISTLE), std::nullopt);
+    EXPECT_EQ(recover_sender(tx, EVMC_SPURIOUS_DRAGON), SIGNER);
+}
+
+TEST(state_tx_preparation, recover_sender_batch)
+{
+    std::vector<Transaction> txs{eip155_tx(), eip1559_tx(), eip155_tx(), eip1559_tx()};
+    txs[1].data = bytes{0x01};
+    txs[2].v = 1;  // Invalid v.
+    txs[3].r = 0;  // Invalid r.
+    txs.push_back(eip155_tx());
+
+    const auto senders = recover_sender_batch(txs, EVMC_CANCUN);
+    ASSERT_EQ(senders.size(), txs.size());
+    EXPECT_EQ(senders[0], SIGNER);
+    EXPECT_EQ(senders[4], SIGNER);
+    for (size_t i = 0; i < txs.size(); ++i)
+        EXPECT_EQ(senders[i], recover_sender(txs[i], EVMC_CANCUN)) << i;
+
+    EXPECT_TRUE(recover_sender_batch({}, EVMC_CANCUN).empty());
+}
+
+TEST(state_tx_preparation, prepare_transactions)
+{
+    std::vector<Transaction> txs;
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        txs.push_back(i % 2 == 0 ? eip155_tx() : eip1559_tx());
+        txs.back().data = bytes(i, 0x01);
+    }
+    txs[0].data.clear();
+    txs[1].data.clear();
+
+    for (const size_t num_threads : {0u, 1u, 4u, 16u})
+    {
+        const auto prepared = prepare_transactions(txs, EVMC_CANCUN, true, num_threads);
+        ASSERT_EQ(prepared.size(), txs.size());
+        for (size_t i = 0; i < txs.size(); ++i)
+        {
+            EXPECT_EQ(prepared[i].rlp, rlp::encode(txs[i]));
+            EXPECT_EQ(prepared[i].hash, keccak256(rlp::encode(txs[i])));
+            ASSERT_TRUE(prepared[i].sender.has_value());
+            if (i < 2)
+                EXPECT_EQ(*prepared[i].sender, SIGNER);
+        }
+    }
+
+    const auto prepared = prepare_transactions(txs, EVMC_CANCUN, false, 2);
+    EXPECT_FALSE(prepared[0].sender.has_value());
+    EXPECT_TRUE(prepare_transactions({}, EVMC_CANCUN, true, 4).empty());
+}
+
+TEST(state_tx_preparation, prevalidate_point_evaluations)
+{
+    // Point evaluation precompile input from Mainnet.
+    const auto input =
+        "012b08a0504a63aac18383db69fe6b52fc833e3d060b87c2726c4140c909d91807dddd3c80995c2bb3012943e2036e77490b1f6ddc58ca39a4fb4f3225ae56ab11dc2c4d89f777f0f5c2a51f45b73ff1538761f9cf23ed74c74472fea625ad8bace1db77e25ceb316d914182e05dd810f112352e1d6ed9e47af28e2f64e22b94c411794359c2273bc10bc0390963fb1a97bb642307bfa4424c66bd90ecc0ecffd5045e492b40304df20346693db7450457e2c72588a6a2b1a16909e2ab1e6284"_hex;
+    auto invalid = input;
+    invalid[95] ^= 1;
+
+    std::vector<Transaction> txs{eip1559_tx(), eip1559_tx(), eip1559_tx()};
+    txs[0].data = input;
+    txs[0].to = 0x0a_address;
+    txs[1].data = invalid;
+    txs[1].to = 0x0a_address;
+    txs[2].data = input;  // Not a precompile call.
+    txs[2].data[63] ^= 1;
+
+    auto& batch = PointEvaluationBatch::local();
+    batch.clear();
+
+    prevalidate_point_evaluations(txs, EVMC_SHANGHAI);
+    EXPECT_FALSE(batch.find(input).has_value());
+
+    prevalidate_point_evaluations(txs, EVMC_CANCUN);
+    EXPECT_EQ(batch.find(input), true);
+    EXPECT_EQ(batch.find(invalid), false);
+    EXPECT_FALSE(batch.find(txs[2].data).has_value());
+
+    // The results of the previous block are dropped.
+    prevalidate_point_evaluations({}, EVMC_CANCUN);
+    EXPECT_FALSE(batch.find(input).has_value());
+}
@@ -0,0 +1,110 @@
+// evmone: Fast Ethereum Virtual Machine implementation
+// Copyright 2024 The evmone Authors.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <evmone/evmone.h>
+#include <gtest/gtest.h>
+#include <test/state/state.hpp>
+#include <test/state/test_state.hpp>
+
+using namespace evmc::literals;
+using namespace evmone::state;
+using namespace evmone::test;
+
+namespace
+{
+/// The StateView wrapper recording the batch requests.
+class BatchRecordingView : public StateView
+{
+    const StateView& m_state;
+
+public:
+    mutable std::vector<address> prefetched_accounts;
+    mutable std::vector<StorageKey> prefetched_storage;
+    mutable std::vector<address> batch_accounts;
+    mutable std::vector<StorageKey> batch_storage;
+
+    explicit BatchRecordingView(const StateView& state) noexcept : m_state{state} {}
+
+    std::optional<Account> get_account(const address& addr) const noexcept override
+    {
+        return m_state.get_account(addr);
+    }
+
+    bytes get_account_code(const address& addr) const noexcept override
+    {
+        return m_state.get_account_code(addr);
+    }
+
+    bytes32 get_storage(const address& addr, const bytes32& key) const noexcept override
+    {
+        return m_state.get_storage(addr, key);
+    }
+
+    std::vector<std::optional<Account>> get_accounts(
+        std::span<const address> addrs) const noexcept override
+    {
+        batch_accounts.insert(batch_accounts.end(), addrs.begin(), addrs.end());
+        return m_state.get_accounts(addrs);
+    }
+
+    std::vector<bytes32> get_storage_batch(std::span<const StorageKey> keys) const noexcept override
+    {
+        batch_storage.insert(batch_storage.end(), keys.begin(), keys.end());
+        return m_state.get_storage_batch(keys);
+    }
+
+    void prefetch(
+        std::span<const address> addrs, std::span<const StorageKey> keys) const noexcept override
+    {
+        prefetched_accounts.insert(prefetched_accounts.end(), addrs.begin(), addrs.end());
+        prefetched_storage.insert(prefetched_storage.end(), keys.begin(), keys.end());
+    }
+};
+}  // namespace
+
+TEST(state_view_batch, default_implementation)
+{
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto B = 0xbb_address;
+    const TestState state{{A, {.nonce = 1, .storage = {{0x01_bytes32, 0x11_bytes32}}}}};
+
+    const auto accounts = state.get_accounts(std::array{B, A});
+    ASSERT_EQ(accounts.size(), 2);
+    EXPECT_FALSE(accounts[0].has_value());
+    ASSERT_TRUE(accounts[1].has_value());
+    EXPECT_EQ(accounts[1]->nonce, 1);
+
+    const auto values = state.get_storage_batch(
+        std::array{StateView::StorageKey{A, 0x01_bytes32}, StateView::StorageKey{B, 0x01_bytes32}});
+    EXPECT_EQ(values, (std::vector{0x11_bytes32, bytes32{}}));
+}
+
+TEST(state_view_batch, transition_prewarms_known_state)
+{
+    static constexpr auto Sender = 0x5e_address;
+    static constexpr auto To = 0x70_address;
+    static constexpr auto A = 0xaa_address;
+    static constexpr auto Coinbase = 0xc014bace_address;
+    static constexpr auto K = 0x01_bytes32;
+
+    evmc::VM vm{evmc_create_evmone()};
+    const TestState pre{{Sender, {.balance = 1'000'000}}, {A, {.storage = {{K, 0x11_bytes32}}}}};
+    const BlockInfo block{.gas_limit = 1'000'000, .coinbase = Coinbase};
+    const Transaction tx{.type = Transaction::Type::access_list,
+        .gas_limit = 100'000,
+        .sender = Sender,
+        .to = To,
+        .access_list = {{A, {K}}}};
+
+    const BatchRecordingView view{pre};
+    const auto res = transition(
+        view, block, tx, EVMC_CANCUN, vm, block.gas_limit, BlockInfo::MAX_BLOB_GAS_PER_BLOCK);
+    ASSERT_TRUE(holds_alternative<TransactionReceipt>(res));
+
+    EXPECT_EQ(view.prefetched_accounts, (std::vector{Sender, Coinbase, To, A}));
+    EXPECT_EQ(view.prefetched_storage, (std::vector{StateView::StorageKey{A, K}}));
+    // The sender is loaded first for the transaction validation.
+    EXPECT_EQ(view.batch_accounts, (std::vector{Coinbase, To, A}));
+    EXPECT_EQ(view.batch_storage, (std::vector{StateView::StorageKey{A, K}}));
+}